@@ -0,0 +1,46 @@
+#version 450 core
+
+// Input variables, remember layout
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec4 normal;
+
+// Per instance variables, matrices take up a location per column
+layout(location = 3) in mat4 objToWorld;
+layout(location = 7) in mat4 normMat;
+layout(location = 11) in vec3 tint;
+layout(location = 12) in vec3 diffuseCoeff;
+layout(location = 13) in vec4 specular;
+
+// Uniform variables, mainly matrices
+uniform mat4 worldToCam;
+uniform mat4 perspMat;
+
+// Output variables
+out vec3 myColor;
+out vec4 worldPos;
+out vec4 worldNorm;
+
+// Material of the instance, same for the whole instance so no interpolation
+flat out vec3 instTint;
+flat out vec3 instDiffuse;
+flat out vec3 instSpecular;
+flat out float instSpecularExp;
+
+void main() {
+    // Give the color to the output variable
+    myColor = color;
+
+    // Give the world position and normal to the output
+    worldPos = objToWorld * position;
+    worldNorm = normMat * normal;
+
+    // Pass the material along to the fragment shader
+    instTint = tint;
+    instDiffuse = diffuseCoeff;
+    instSpecular = specular.rgb;
+    instSpecularExp = specular.w;
+
+    // Calculate gl_Position
+    gl_Position = perspMat * worldToCam * objToWorld * position;
+}
\ No newline at end of file
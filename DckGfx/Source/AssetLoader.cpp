@@ -0,0 +1,301 @@
+//*****************************************************************************
+//	File:   AssetLoader.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Loads assets in the background. Worker threads read and
+//		process mesh files, then the finished meshes are queued up and
+//		uploaded to OpenGL on the thread with the GL context a few at a time
+//		each frame
+//*****************************************************************************
+
+#include "AssetLoader.h"
+#include "BinaryMesh.h"
+#include "FileReader.h"
+#include "ObjReader.h"
+#include "Profiler.h"
+#include "SDL2/SDL.h"
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+// Most workers the loader will start, loading is mostly bound by the disk
+static const unsigned int maxWorkerCount = 4;
+
+static AssetLoader assetLoader;
+
+//*****************************************************************************
+//  Description:
+//		Checks if a filepath ends with the given extension
+//*****************************************************************************
+static bool HasExtension(const std::string& filepath, std::string_view extension)
+{
+	return filepath.size() >= extension.size() &&
+		   filepath.compare(filepath.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+AssetLoader::AssetLoader() :
+	workers_(),
+	jobSystem_(nullptr),
+	jobs_(),
+	jobMutex_(),
+	jobReady_(),
+	stopping_(false),
+	uploads_(),
+	uploadMutex_(),
+	pendingCount_(0)
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts up the worker threads, leaving a core free for the main thread
+//
+//	Param jobSystem:
+//		Job system that big files are parsed on, nullptr to parse each file on
+//		the worker that reads it
+//*****************************************************************************
+void AssetLoader::Initialize(JobSystem* jobSystem)
+{
+	jobSystem_ = jobSystem;
+
+	unsigned int coreCount = std::thread::hardware_concurrency();
+	unsigned int workerCount = std::min(maxWorkerCount, coreCount > 1 ? coreCount - 1 : 1);
+
+	stopping_ = false;
+	for (unsigned int i = 0; i < workerCount; ++i)
+		workers_.emplace_back(&AssetLoader::WorkerLoop, this);
+}
+
+//*****************************************************************************
+//  Description:
+//		Stops the workers and throws away anything that didn't get uploaded.
+//		Meshes that never finished loading stay not ready
+//*****************************************************************************
+void AssetLoader::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex_);
+		stopping_ = true;
+		jobs_.clear();
+	}
+	jobReady_.notify_all();
+
+	for (std::thread& worker : workers_)
+		worker.join();
+	workers_.clear();
+
+	for (MeshUpload& upload : uploads_)
+	{
+		delete upload.mesh;
+		delete upload.binary;
+		delete upload.pickTree;
+	}
+	uploads_.clear();
+	pendingCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Queues a mesh file to be read by a worker. The file type is picked
+//		from the extension (.dmesh, .obj, otherwise the text mesh format)
+//
+//	Param target:
+//		The mesh the data will be uploaded to once it is read
+//
+//	Param filepath:
+//		The filepath of the mesh file
+//
+//	Param buildNormals:
+//		Whether the worker should build a flat shaded normal mesh out of the
+//		file, the same way NormalMesh does
+//
+//	Param pickable:
+//		Whether the worker should also build the tree the mesh is picked with
+//*****************************************************************************
+void AssetLoader::QueueMesh(DckMesh* target, std::string filepath, bool buildNormals, bool pickable)
+{
+	// Counted before queueing, so an upload on the render thread can't finish before it is counted
+	++pendingCount_;
+	{
+		std::lock_guard<std::mutex> lock(jobMutex_);
+		jobs_.push_back(MeshJob{ target, filepath, buildNormals, pickable });
+	}
+	jobReady_.notify_one();
+}
+
+//*****************************************************************************
+//  Description:
+//		Queues a mesh that is already in memory to be uploaded, skipping the
+//		workers entirely
+//
+//	Param target:
+//		The mesh the data will be uploaded to
+//
+//	Param mesh:
+//		The cpu side mesh data, which the loader takes ownership of and deletes
+//		once it has been uploaded
+//
+//	Param pickTree:
+//		Tree to pick the mesh with, handed to the mesh with the upload. Can be
+//		nullptr
+//*****************************************************************************
+void AssetLoader::QueueUpload(DckMesh* target, Mesh* mesh, MeshBvh* pickTree)
+{
+	++pendingCount_;
+	std::lock_guard<std::mutex> lock(uploadMutex_);
+	uploads_.push_back(MeshUpload{ target, mesh->GetName(), mesh, nullptr, pickTree });
+}
+
+//*****************************************************************************
+//  Description:
+//		Uploads meshes that the workers have finished reading. Must be called
+//		on the thread with the GL context. At least one mesh is uploaded each
+//		call so loading always moves forward, even with a tiny budget
+//
+//	Param budgetMs:
+//		How many milliseconds can be spent uploading before stopping
+//
+//	Return:
+//		Returns how many meshes were uploaded
+//*****************************************************************************
+int AssetLoader::UploadReady(float budgetMs)
+{
+	if (pendingCount_ == 0)
+		return 0;
+	DCK_PROFILE_ZONE("Upload Meshes");
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = static_cast<Uint64>(budgetMs * 0.001f * SDL_GetPerformanceFrequency());
+
+	int uploaded = 0;
+	while (uploaded == 0 || SDL_GetPerformanceCounter() - start < budget)
+	{
+		MeshUpload upload;
+		{
+			std::lock_guard<std::mutex> lock(uploadMutex_);
+			if (uploads_.empty())
+				break;
+			upload = uploads_.front();
+			uploads_.pop_front();
+		}
+
+		if (upload.mesh)
+			upload.target->Upload(upload.mesh->GetView(), upload.pickTree);
+		else if (upload.binary)
+			upload.target->Upload(upload.binary->GetView(), upload.pickTree);
+		else
+		{
+			std::cout << "Failed to load mesh: " << upload.filepath << std::endl;
+			delete upload.pickTree;
+		}
+
+		delete upload.mesh;
+		delete upload.binary;
+		--pendingCount_;
+		++uploaded;
+	}
+	return uploaded;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many queued meshes are still loading or waiting to upload
+//*****************************************************************************
+int AssetLoader::GetPendingCount()
+{
+	return pendingCount_;
+}
+
+AssetLoader::~AssetLoader()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Worker thread loop. Takes jobs off the queue, reads the file, and
+//		hands the result off to be uploaded
+//*****************************************************************************
+void AssetLoader::WorkerLoop()
+{
+	DCK_PROFILE_THREAD("Asset Loader");
+	while (true)
+	{
+		MeshJob job;
+		{
+			std::unique_lock<std::mutex> lock(jobMutex_);
+			jobReady_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+			if (stopping_)
+				return;
+			job = jobs_.front();
+			jobs_.pop_front();
+		}
+
+		DCK_PROFILE_ZONE("Read Mesh");
+		MeshUpload upload{ job.target, job.filepath, nullptr, nullptr, nullptr };
+		if (HasExtension(job.filepath, ".dmesh"))
+		{
+			// Binary meshes get uploaded straight out of the mapping
+			upload.binary = new BinaryMesh();
+			if (!upload.binary->Open(job.filepath.c_str()))
+			{
+				delete upload.binary;
+				upload.binary = nullptr;
+			}
+		}
+		else
+		{
+			if (HasExtension(job.filepath, ".obj"))
+				upload.mesh = ReadObjFile(job.filepath.c_str(), jobSystem_);
+			else
+				upload.mesh = ReadMeshFile(job.filepath.c_str(), jobSystem_);
+
+			if (upload.mesh && job.buildNormals)
+			{
+				Mesh* normalMesh = new NormalMesh(upload.mesh);
+				delete upload.mesh;
+				upload.mesh = normalMesh;
+			}
+		}
+
+		// Picking trees of big meshes take a while to build, so it happens here instead of on the frame
+		if (job.pickable && upload.mesh)
+			upload.pickTree = DckMesh::BuildPickTree(upload.mesh->GetView());
+		else if (job.pickable && upload.binary)
+			upload.pickTree = DckMesh::BuildPickTree(upload.binary->GetView());
+
+		std::lock_guard<std::mutex> lock(uploadMutex_);
+		uploads_.push_back(upload);
+	}
+}
+
+
+// Functions for interacting with the asset loader
+void AssetLoaderInit(JobSystem* jobSystem)
+{
+	assetLoader.Initialize(jobSystem);
+}
+
+void AssetLoaderQueueMesh(DckMesh* target, std::string filepath, bool buildNormals, bool pickable)
+{
+	assetLoader.QueueMesh(target, filepath, buildNormals, pickable);
+}
+
+void AssetLoaderQueueUpload(DckMesh* target, Mesh* mesh, MeshBvh* pickTree)
+{
+	assetLoader.QueueUpload(target, mesh, pickTree);
+}
+
+int AssetLoaderUpload(float budgetMs)
+{
+	return assetLoader.UploadReady(budgetMs);
+}
+
+int AssetLoaderPendingCount()
+{
+	return assetLoader.GetPendingCount();
+}
+
+void AssetLoaderShutdown()
+{
+	assetLoader.Shutdown();
+}
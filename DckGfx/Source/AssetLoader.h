@@ -0,0 +1,88 @@
+#pragma once
+//*****************************************************************************
+//	File:   AssetLoader.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Loads assets in the background. Worker threads read and
+//		process mesh files, then the finished meshes are queued up and
+//		uploaded to OpenGL on the thread with the GL context a few at a time
+//		each frame
+//*****************************************************************************
+
+#include "MeshLib.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class BinaryMesh;
+class JobSystem;
+
+class AssetLoader {
+public:
+
+	AssetLoader();
+
+	void Initialize(JobSystem* jobSystem);
+	void Shutdown();
+
+	void QueueMesh(DckMesh* target, std::string filepath, bool buildNormals, bool pickable);
+	void QueueUpload(DckMesh* target, Mesh* mesh, MeshBvh* pickTree);
+	int UploadReady(float budgetMs);
+
+	int GetPendingCount();
+
+	~AssetLoader();
+
+private:
+
+	// A mesh file waiting to be read by a worker
+	struct MeshJob {
+		DckMesh* target;
+		std::string filepath;
+		bool buildNormals;
+		bool pickable;
+	};
+
+	// A mesh that has been read and is waiting to be uploaded, only one of mesh or binary is set.
+	// The pick tree is only set for pickable meshes
+	struct MeshUpload {
+		DckMesh* target;
+		std::string filepath;
+		Mesh* mesh;
+		BinaryMesh* binary;
+		MeshBvh* pickTree;
+	};
+
+	void WorkerLoop();
+
+	std::vector<std::thread> workers_;
+
+	// Big files have their parsing split into jobs on this, so the loader doesn't start threads of its own
+	JobSystem* jobSystem_;
+
+	// Jobs for the workers, workers sleep on jobReady_ when there are none
+	std::deque<MeshJob> jobs_;
+	std::mutex jobMutex_;
+	std::condition_variable jobReady_;
+	bool stopping_;
+
+	// Meshes ready for the main thread to upload
+	std::deque<MeshUpload> uploads_;
+	std::mutex uploadMutex_;
+
+	// How many queued meshes haven't been uploaded yet. Meshes are queued on the main
+	// thread but can be uploaded on the render thread, so it is atomic
+	std::atomic<int> pendingCount_;
+
+};
+
+void AssetLoaderInit(JobSystem* jobSystem);
+void AssetLoaderQueueMesh(DckMesh* target, std::string filepath, bool buildNormals, bool pickable);
+void AssetLoaderQueueUpload(DckMesh* target, Mesh* mesh, MeshBvh* pickTree);
+int AssetLoaderUpload(float budgetMs);
+int AssetLoaderPendingCount();
+void AssetLoaderShutdown();
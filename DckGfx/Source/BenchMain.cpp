@@ -0,0 +1,1270 @@
+//*****************************************************************************
+//	File:   BenchMain.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Main for the benchmark runner. Runs the bench scene headless
+//		for a set number of frames with a fixed time step, then writes frame
+//		time percentiles, draw calls and triangle throughput as JSON so runs
+//		can be compared between versions
+//*****************************************************************************
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include "SDL2/SDL.h"
+#include "DckGfxEngine.h"
+#include "BenchScene.h"
+#include "Bvh.h"
+#include "Camera.h"
+#include "FileReader.h"
+#include "FrameStats.h"
+#include "InputRecording.h"
+#include "InputSystem.h"
+#include "JobSystem.h"
+#include "MeshLib.h"
+#include "SceneGraph.h"
+
+// Every frame steps the scene the same amount, so runs animate the same no matter how fast they are
+static const float fixedDt = 1.0f / 60.0f;
+
+// How many nodes deep each chain in the transform bench's scene graph is
+static const int graphChainLength = 8;
+
+// Object counts the culling bench runs at
+static const int cullingCounts[] = { 10000, 100000, 1000000 };
+
+// How many of the culling bench's objects move, the rest go in the static tree
+static const int cullingDynamicPercent = 10;
+
+// Transform counts the transform check runs at. Only some are a whole number of SIMD groups, and
+// the jobs' ranges split the larger ones off of group boundaries
+static const int transformCheckCounts[] = { 1001, 100000, 100003 };
+
+// Workers the transform check splits its updates across, no matter how many cores there are
+static const unsigned int transformCheckWorkers = 3;
+
+// How far a matrix entry from the transform store can be from one made the slow way
+static const float transformCheckTolerance = 1e-4f;
+
+// How many times the mesh load bench builds and uploads its mesh, after one untimed load
+static const int meshLoadRuns = 5;
+
+// About how many lines long the file read bench's mesh files are
+static const int fileReadLineCounts[] = { 100000, 1000000, 10000000 };
+
+// How many times the file read bench reads each file with each reader, after one untimed read
+static const int fileReadRuns = 3;
+
+// How many different spots the API call bench renders its cubes at
+static const int apiCallSpots = 100;
+
+// Heap allocations made while counting is on, from any thread. Counting is turned on once the
+// warmup is over and stays on through the last frame, so allocations on the render thread and
+// job workers are counted no matter when they happen
+static std::atomic<bool> countingAllocs(false);
+static std::atomic<long long> allocCount(0);
+
+static void* CountedAlloc(std::size_t size)
+{
+	if (countingAllocs.load(std::memory_order_relaxed))
+		allocCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size > 0 ? size : 1);
+}
+
+static void* CountedAlignedAlloc(std::size_t size, std::align_val_t alignment)
+{
+	if (countingAllocs.load(std::memory_order_relaxed))
+		allocCount.fetch_add(1, std::memory_order_relaxed);
+	std::size_t align = static_cast<std::size_t>(alignment);
+	size = size > 0 ? size : 1;
+#ifdef _WIN32
+	return _aligned_malloc(size, align);
+#else
+	// aligned_alloc wants the size to be a multiple of the alignment
+	return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+static void AlignedFree(void* memory)
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+	void* memory = CountedAlloc(size);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* memory = CountedAlignedAlloc(size, alignment);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(memory);
+}
+
+//*****************************************************************************
+//  Description:
+//		Named scene setups, each stressing a different part of the engine
+//*****************************************************************************
+struct BenchPreset {
+	const char* name;
+	int objectCount;
+	int lightCount;
+	int meshDetail;
+	RenderType renderMode;
+};
+
+static const BenchPreset presets[] = {
+	{ "default",   1000,  2, 16,  RenderType::Triangles },
+	{ "objects",   20000, 2, 4,   RenderType::Triangles },
+	{ "lights",    1000,  10, 16, RenderType::Triangles },
+	{ "triangles", 64,    2, 128, RenderType::Triangles },
+	{ "lines",     2000,  2, 16,  RenderType::Lines },
+	{ "points",    2000,  2, 16,  RenderType::Points }
+};
+
+static const char* RenderModeName(RenderType mode)
+{
+	switch (mode)
+	{
+		case RenderType::Points:
+			return "points";
+		case RenderType::Lines:
+			return "lines";
+		default:
+			return "triangles";
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes text as a quoted JSON string, escaping quotes and backslashes
+//		so Windows paths come out valid
+//
+//	Param out:
+//		Stream to write to
+//
+//	Param text:
+//		Text to write
+//*****************************************************************************
+static void WriteJsonString(std::ostream& out, const char* text)
+{
+	out << '"';
+	for (const char* c = text; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			out << '\\';
+		out << *c;
+	}
+	out << '"';
+}
+
+static void PrintUsage()
+{
+	std::cout << "DckGfxBench [--preset name] [--objects N] [--lights M] [--detail D]" << std::endl;
+	std::cout << "            [--mode points|lines|triangles] [--frames F] [--warmup W]" << std::endl;
+	std::cout << "            [--size W H] [--render-thread] [--windowed] [--out path]" << std::endl;
+	std::cout << "            [--transforms N] [--culling] [--mesh-load N] [--file-read] [--alloc-check]" << std::endl;
+	std::cout << "            [--api-calls N] [--transform-check] [--replay file.dinput]" << std::endl;
+	std::cout << "Presets:";
+	for (const BenchPreset& preset : presets)
+		std::cout << " " << preset.name;
+	std::cout << std::endl;
+}
+
+//*****************************************************************************
+//  Description:
+//		Times only the transform and scene graph updates, without starting
+//		the engine. Every transform is rotated each frame, so every frame
+//		rebuilds all of them. The graph is made of chains of nodes, each
+//		under the one before it
+//
+//	Param transformCount:
+//		How many transforms to update
+//
+//	Param frameCount:
+//		How many frames to time after the warmup
+//
+//	Param warmupFrames:
+//		How many frames to run before timing
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main
+//*****************************************************************************
+static int RunTransformBench(int transformCount, int frameCount, int warmupFrames, const char* outPath)
+{
+	JobSystem jobSystem;
+	jobSystem.Initialize();
+
+	TransformStore store;
+	SceneGraph graph(&store);
+	std::vector<TransformHandle> handles(transformCount);
+	SceneNode previous;
+	for (int i = 0; i < transformCount; ++i)
+	{
+		handles[i] = store.Add();
+		previous = graph.Add(handles[i], i % graphChainLength ? previous : SceneNode());
+		store.SetPosition(handles[i], glm::vec4(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), static_cast<float>(i / 10000), 1.0f));
+		store.SetScale(handles[i], glm::vec3(1.0f + (i % 7) * 0.25f));
+	}
+
+	FrameStats updateTimes;
+	FrameStats graphTimes;
+	for (int frame = 0; frame < warmupFrames + frameCount; ++frame)
+	{
+		float angle = frame * fixedDt * 90.0f;
+		for (int i = 0; i < transformCount; ++i)
+			store.SetRotation(handles[i], glm::vec4(0, 1, 0, 0), angle + i);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		store.Update(&jobSystem);
+		Uint64 storeEnd = SDL_GetPerformanceCounter();
+		graph.Update(&jobSystem);
+		Uint64 graphEnd = SDL_GetPerformanceCounter();
+
+		if (frame >= warmupFrames)
+		{
+			updateTimes.Add(static_cast<float>((storeEnd - start) * 1000.0 / SDL_GetPerformanceFrequency()));
+			graphTimes.Add(static_cast<float>((graphEnd - storeEnd) * 1000.0 / SDL_GetPerformanceFrequency()));
+		}
+	}
+
+	unsigned int threadCount = jobSystem.GetThreadCount();
+	jobSystem.Shutdown();
+
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"transforms\",\n";
+	outFile << "\t\"transforms\": " << transformCount << ",\n";
+	outFile << "\t\"graphChainLength\": " << graphChainLength << ",\n";
+	outFile << "\t\"threads\": " << threadCount << ",\n";
+	outFile << "\t\"frames\": " << updateTimes.GetCount() << ",\n";
+	outFile << "\t\"warmupFrames\": " << warmupFrames << ",\n";
+	outFile << "\t\"updateMs\": ";
+	updateTimes.WriteJson(outFile);
+	outFile << ",\n\t\"sceneGraphMs\": ";
+	graphTimes.WriteJson(outFile);
+	outFile << "\n}\n";
+
+	FrameStats::Summary summary = updateTimes.Summarize();
+	FrameStats::Summary graphSummary = graphTimes.Summarize();
+	std::cout << "transforms: " << transformCount << " on " << threadCount << " threads, p50 " << summary.p50
+			  << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99 << " ms" << std::endl;
+	std::cout << "scene graph: p50 " << graphSummary.p50 << " ms, p95 " << graphSummary.p95 << " ms, p99 "
+			  << graphSummary.p99 << " ms" << std::endl;
+	return 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks the matrices the transform store makes with SIMD against ones
+//		made the slow way. The update is split across a job system with
+//		workers even on one core, at counts with and without a partial
+//		SIMD group at the end
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main, 1 if any matrix was wrong
+//*****************************************************************************
+static int RunTransformCheck(const char* outPath)
+{
+	JobSystem jobSystem;
+	jobSystem.Initialize(transformCheckWorkers);
+
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		jobSystem.Shutdown();
+		return 1;
+	}
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"transform-check\",\n";
+	outFile << "\t\"threads\": " << jobSystem.GetThreadCount() << ",\n";
+	outFile << "\t\"counts\": [";
+
+	int totalMismatches = 0;
+	const int checkCount = static_cast<int>(sizeof(transformCheckCounts) / sizeof(transformCheckCounts[0]));
+	for (int run = 0; run < checkCount; ++run)
+	{
+		int transformCount = transformCheckCounts[run];
+		TransformStore store;
+		std::vector<TransformHandle> handles(transformCount);
+		for (int i = 0; i < transformCount; ++i)
+		{
+			handles[i] = store.Add();
+			store.SetPosition(handles[i], glm::vec4(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), static_cast<float>(i / 10000), 1.0f));
+			store.SetScale(handles[i], glm::vec3(1.0f + (i % 7) * 0.25f, 1.0f + (i % 5) * 0.5f, 1.0f + (i % 3)));
+			store.SetRotation(handles[i], glm::vec4(static_cast<float>(i % 3), 1.0f, static_cast<float>(i % 2), 0.0f), static_cast<float>(i));
+		}
+		store.Update(&jobSystem);
+
+		int mismatches = 0;
+		for (int i = 0; i < transformCount; ++i)
+		{
+			glm::vec3 scale = store.GetScale(handles[i]);
+			glm::mat4 model = GfxMath::Translate(store.GetPosition(handles[i])) * GfxMath::QuatToMatrix(store.GetOrientation(handles[i]))
+							  * GfxMath::Scale(scale.x, scale.y, scale.z);
+			glm::mat4 normal = GfxMath::NormalMatrix(model);
+			const glm::mat4& storeModel = store.GetModelMatrix(handles[i]);
+			const glm::mat4& storeNormal = store.GetNormalMatrix(handles[i]);
+
+			bool matches = true;
+			for (int column = 0; column < 4; ++column)
+			{
+				for (int row = 0; row < 4; ++row)
+				{
+					if (std::fabs(storeModel[column][row] - model[column][row]) > transformCheckTolerance
+						|| std::fabs(storeNormal[column][row] - normal[column][row]) > transformCheckTolerance)
+						matches = false;
+				}
+			}
+			if (!matches)
+				++mismatches;
+		}
+
+		outFile << (run > 0 ? ", " : "") << "{ \"transforms\": " << transformCount << ", \"mismatches\": " << mismatches << " }";
+		std::cout << "transform check: " << transformCount << " transforms on " << jobSystem.GetThreadCount() << " threads, "
+				  << mismatches << " wrong" << std::endl;
+		totalMismatches += mismatches;
+	}
+
+	outFile << "]\n}\n";
+	jobSystem.Shutdown();
+	return totalMismatches > 0 ? 1 : 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Times culling a field of boxes by checking every one against the
+//		frustum, and by querying the static and dynamic bounding volume
+//		trees, at each of the culling counts. The camera turns in place in
+//		the middle of the field, and some of the boxes move every frame
+//
+//	Param frameCount:
+//		How many frames to time at each count after the warmup
+//
+//	Param warmupFrames:
+//		How many frames to run before timing
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main
+//*****************************************************************************
+static int RunCullingBench(int frameCount, int warmupFrames, const char* outPath)
+{
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"culling\",\n";
+	outFile << "\t\"dynamicPercent\": " << cullingDynamicPercent << ",\n";
+	outFile << "\t\"frames\": " << frameCount << ",\n";
+	outFile << "\t\"warmupFrames\": " << warmupFrames << ",\n";
+	outFile << "\t\"runs\": [";
+
+	bool firstRun = true;
+	for (int objectCount : cullingCounts)
+	{
+		// Same density at every count, so the camera sees about the same share of the boxes
+		float fieldSize = 4.0f * std::cbrt(static_cast<float>(objectCount));
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> position(-fieldSize, fieldSize);
+		std::uniform_real_distribution<float> extent(0.25f, 1.0f);
+
+		std::vector<Aabb> boxes(objectCount);
+		std::vector<int> proxies(objectCount);
+		Bvh staticTree(0.0f);
+		Bvh dynamicTree(0.1f);
+		int dynamicCount = objectCount * cullingDynamicPercent / 100;
+		for (int i = 0; i < objectCount; ++i)
+		{
+			glm::vec3 center(position(random), position(random), position(random));
+			glm::vec3 halfSize(extent(random), extent(random), extent(random));
+			boxes[i] = Aabb(center - halfSize, center + halfSize);
+			proxies[i] = i < dynamicCount ? dynamicTree.Insert(boxes[i]) : staticTree.Insert(boxes[i]);
+		}
+
+		Uint64 buildStart = SDL_GetPerformanceCounter();
+		staticTree.Build();
+		dynamicTree.Build();
+		float buildMs = static_cast<float>((SDL_GetPerformanceCounter() - buildStart) * 1000.0 / SDL_GetPerformanceFrequency());
+
+		Camera camera(GfxMath::Point(0, 0, 0), GfxMath::Vector(0, 0, 1), 90.0f, 16.0f / 9.0f, 1.0f, fieldSize);
+		FrameStats refitTimes;
+		FrameStats flatTimes;
+		FrameStats bvhTimes;
+		std::vector<int> visible;
+		visible.reserve(objectCount);
+		double visibleTotal = 0.0;
+		for (int frame = 0; frame < warmupFrames + frameCount; ++frame)
+		{
+			camera.Yaw(fixedDt * 30.0f);
+			Frustum frustum;
+			frustum.Extract(camera.GetPerspMatrix() * camera.GetViewMatrix());
+
+			// Moving boxes drift back and forth a little each frame
+			Uint64 refitStart = SDL_GetPerformanceCounter();
+			float drift = 0.05f * std::sin(frame * fixedDt * 2.0f);
+			for (int i = 0; i < dynamicCount; ++i)
+			{
+				glm::vec3 offset(drift * ((i & 1) ? 1.0f : -1.0f), drift, 0.0f);
+				boxes[i] = Aabb(boxes[i].min + offset, boxes[i].max + offset);
+				dynamicTree.Move(proxies[i], boxes[i]);
+			}
+			dynamicTree.Optimize();
+			Uint64 flatStart = SDL_GetPerformanceCounter();
+
+			int flatVisible = 0;
+			for (const Aabb& box : boxes)
+			{
+				if (frustum.BoxVisible(box.GetCenter(), box.GetExtents()))
+					++flatVisible;
+			}
+			Uint64 bvhStart = SDL_GetPerformanceCounter();
+
+			visible.clear();
+			staticTree.QueryFrustum(frustum, visible);
+			dynamicTree.QueryFrustum(frustum, visible);
+			Uint64 bvhEnd = SDL_GetPerformanceCounter();
+
+			if (static_cast<int>(visible.size()) != flatVisible)
+			{
+				std::cout << "Culling mismatch at " << objectCount << " objects: flat " << flatVisible << ", tree "
+						  << visible.size() << std::endl;
+				return 1;
+			}
+
+			if (frame >= warmupFrames)
+			{
+				double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+				refitTimes.Add(static_cast<float>((flatStart - refitStart) * 1000.0 / frequency));
+				flatTimes.Add(static_cast<float>((bvhStart - flatStart) * 1000.0 / frequency));
+				bvhTimes.Add(static_cast<float>((bvhEnd - bvhStart) * 1000.0 / frequency));
+				visibleTotal += flatVisible;
+			}
+		}
+
+		outFile << (firstRun ? "\n" : ",\n") << "\t\t{\n";
+		outFile << "\t\t\t\"objects\": " << objectCount << ",\n";
+		outFile << "\t\t\t\"visiblePerFrame\": " << visibleTotal / (frameCount > 0 ? frameCount : 1) << ",\n";
+		outFile << "\t\t\t\"buildMs\": " << buildMs << ",\n";
+		outFile << "\t\t\t\"treeHeight\": " << staticTree.GetHeight() << ",\n";
+		outFile << "\t\t\t\"refitMs\": ";
+		refitTimes.WriteJson(outFile);
+		outFile << ",\n\t\t\t\"flatMs\": ";
+		flatTimes.WriteJson(outFile);
+		outFile << ",\n\t\t\t\"bvhMs\": ";
+		bvhTimes.WriteJson(outFile);
+		outFile << "\n\t\t}";
+		firstRun = false;
+
+		FrameStats::Summary flatSummary = flatTimes.Summarize();
+		FrameStats::Summary bvhSummary = bvhTimes.Summarize();
+		FrameStats::Summary refitSummary = refitTimes.Summarize();
+		std::cout << "culling " << objectCount << ": build " << buildMs << " ms, flat p50 " << flatSummary.p50
+				  << " ms, bvh p50 " << bvhSummary.p50 << " ms, refit p50 " << refitSummary.p50 << " ms" << std::endl;
+	}
+
+	outFile << "\n\t]\n}\n";
+	return 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds a flat grid of quads with about the given number of
+//		triangles, the way a loader would, one vertex and face at a time
+//*****************************************************************************
+static Mesh* BuildGridMesh(int triangleCount)
+{
+	int side = std::max(1, static_cast<int>(std::sqrt(triangleCount / 2.0)));
+	int rowLength = side + 1;
+	Mesh* grid = new Mesh("BenchGrid");
+	grid->Reserve(rowLength * rowLength, 0, 0, side * side * 2);
+
+	glm::vec4 normal = GfxMath::Vector(0, 1, 0);
+	for (int row = 0; row <= side; ++row)
+	{
+		for (int column = 0; column <= side; ++column)
+		{
+			glm::vec3 color(static_cast<float>(column) / side, 0.5f, static_cast<float>(row) / side);
+			grid->AddVertex(GfxMath::Point(static_cast<float>(column), 0, static_cast<float>(row)), color, normal);
+		}
+	}
+
+	for (int row = 0; row < side; ++row)
+	{
+		for (int column = 0; column < side; ++column)
+		{
+			unsigned int v0 = row * rowLength + column;
+			unsigned int v1 = v0 + 1;
+			unsigned int v2 = v0 + rowLength;
+			unsigned int v3 = v2 + 1;
+			grid->AddFace(v0, v2, v1);
+			grid->AddFace(v1, v2, v3);
+		}
+	}
+	return grid;
+}
+
+//*****************************************************************************
+//  Description:
+//		Times loading a big mesh at startup. The mesh is built on the cpu
+//		one vertex and face at a time, then uploaded to OpenGL all at once.
+//		The engine is started headless only for its context, nothing is
+//		drawn
+//
+//	Param triangleCount:
+//		About how many triangles the mesh has
+//
+//	Param config:
+//		How to start the engine
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main
+//*****************************************************************************
+static int RunMeshLoadBench(int triangleCount, const EngineConfig& config, const char* outPath)
+{
+	try
+	{
+		DckEInitialize(config);
+	}
+	catch (const std::runtime_error& error)
+	{
+		std::cout << "Bench failed to start: " << error.what() << std::endl;
+		return 1;
+	}
+
+	FrameStats buildTimes;
+	FrameStats uploadTimes;
+	int vertexCount = 0;
+	int faceCount = 0;
+	for (int run = 0; run <= meshLoadRuns; ++run)
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		Mesh* mesh = BuildGridMesh(triangleCount);
+		Uint64 built = SDL_GetPerformanceCounter();
+
+		// Waits for the driver too, so the upload isn't just handed off and timed as free
+		DckMesh* gpuMesh = new DckMesh(mesh);
+		glFinish();
+		Uint64 uploaded = SDL_GetPerformanceCounter();
+
+		vertexCount = mesh->GetVertexCount();
+		faceCount = mesh->GetFaceCount();
+		delete gpuMesh;
+		delete mesh;
+
+		if (run > 0)
+		{
+			double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+			buildTimes.Add(static_cast<float>((built - start) * 1000.0 / frequency));
+			uploadTimes.Add(static_cast<float>((uploaded - built) * 1000.0 / frequency));
+		}
+	}
+
+	DckEShutdown();
+
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	FrameStats::Summary buildSummary = buildTimes.Summarize();
+	FrameStats::Summary uploadSummary = uploadTimes.Summarize();
+	float loadMs = buildSummary.p50 + uploadSummary.p50;
+	double trianglesPerSecond = loadMs > 0.0f ? faceCount / (loadMs / 1000.0) : 0.0;
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"meshLoad\",\n";
+	outFile << "\t\"vertices\": " << vertexCount << ",\n";
+	outFile << "\t\"triangles\": " << faceCount << ",\n";
+	outFile << "\t\"runs\": " << buildTimes.GetCount() << ",\n";
+	outFile << "\t\"buildMs\": ";
+	buildTimes.WriteJson(outFile);
+	outFile << ",\n\t\"uploadMs\": ";
+	uploadTimes.WriteJson(outFile);
+	outFile << ",\n";
+	outFile << "\t\"trianglesPerSecond\": " << trianglesPerSecond << "\n";
+	outFile << "}\n";
+
+	std::cout << "mesh load: " << faceCount << " triangles, build p50 " << buildSummary.p50 << " ms, upload p50 "
+			  << uploadSummary.p50 << " ms, " << trianglesPerSecond / 1000000.0 << " Mtris/s" << std::endl;
+	return 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes a text mesh file of random vertices and faces, about the given
+//		number of lines long. Half the lines are faces, the other half are
+//		the position and color lines of the vertices
+//
+//	Return:
+//		Returns how many bytes were written, or 0 if the file couldn't be
+//*****************************************************************************
+static size_t WriteBenchMeshFile(const char* filepath, int lineCount)
+{
+	std::ofstream meshFile(filepath, std::ios::trunc);
+	if (!meshFile.is_open())
+		return 0;
+
+	int vertexCount = std::max(3, lineCount / 4);
+	int faceCount = std::max(1, lineCount / 2);
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> color(0.0f, 1.0f);
+	std::uniform_int_distribution<int> vertex(0, vertexCount - 1);
+
+	meshFile << "Mesh\nName\nFileReadBench\n";
+	meshFile << "Vertices\n" << vertexCount << "\n";
+	for (int i = 0; i < vertexCount; ++i)
+	{
+		meshFile << position(random) << " " << position(random) << " " << position(random) << "\n";
+		meshFile << color(random) << " " << color(random) << " " << color(random) << "\n";
+	}
+	meshFile << "Faces\n" << faceCount << "\n";
+	for (int i = 0; i < faceCount; ++i)
+		meshFile << vertex(random) << " " << vertex(random) << " " << vertex(random) << "\n";
+
+	std::streamoff size = meshFile.tellp();
+	return meshFile.good() && size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Reads a text mesh file the way ReadMeshFile used to, a line at a time
+//		with an istringstream for each line, to compare the current reader
+//		against. Only reads the sections the bench files have
+//*****************************************************************************
+static Mesh* ReadMeshFileStreams(const char* filepath)
+{
+	std::ifstream meshFile(filepath);
+	std::string currLine;
+	if (!std::getline(meshFile, currLine) || currLine != "Mesh")
+		return nullptr;
+
+	Mesh* readMesh = nullptr;
+	while (std::getline(meshFile, currLine))
+	{
+		if (currLine == "Name")
+		{
+			std::getline(meshFile, currLine);
+			delete readMesh;
+			readMesh = new Mesh(currLine);
+			continue;
+		}
+
+		bool isVertices = currLine == "Vertices";
+		if (!readMesh || (!isVertices && currLine != "Faces"))
+			continue;
+
+		std::getline(meshFile, currLine);
+		int count = 0;
+		std::istringstream(currLine) >> count;
+		for (int i = 0; i < count; ++i)
+		{
+			std::getline(meshFile, currLine);
+			std::istringstream data(currLine);
+			if (isVertices)
+			{
+				float x, y, z;
+				float r, g, b;
+				data >> x >> y >> z;
+				std::getline(meshFile, currLine);
+				std::istringstream colorData(currLine);
+				colorData >> r >> g >> b;
+				readMesh->AddVertex(GfxMath::Point(x, y, z), glm::vec3(r, g, b));
+			}
+			else
+			{
+				unsigned int v1, v2, v3;
+				data >> v1 >> v2 >> v3;
+				readMesh->AddFace(v1, v2, v3);
+			}
+		}
+	}
+	return readMesh;
+}
+
+//*****************************************************************************
+//  Description:
+//		Times reading text mesh files of each of the file read line counts,
+//		with the old line and stream reader and with ReadMeshFile, and
+//		reports how many MB a second each gets through. The files are
+//		written to the working directory and removed after
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main
+//*****************************************************************************
+static int RunFileReadBench(const char* outPath)
+{
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	// Large sections are parsed as jobs, the same way the asset loader reads them
+	JobSystem jobSystem;
+	jobSystem.Initialize();
+
+	const char* meshPath = "FileReadBench.txt";
+	unsigned int threadCount = jobSystem.GetThreadCount();
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"fileRead\",\n";
+	outFile << "\t\"threads\": " << threadCount << ",\n";
+	outFile << "\t\"runs\": [";
+
+	bool firstRun = true;
+	for (int lineCount : fileReadLineCounts)
+	{
+		size_t bytes = WriteBenchMeshFile(meshPath, lineCount);
+		if (bytes == 0)
+		{
+			std::cout << "Failed to write bench mesh file: " << meshPath << std::endl;
+			return 1;
+		}
+
+		// Untimed read first, so every timed read finds the file already cached
+		delete ReadMeshFile(meshPath, &jobSystem);
+
+		FrameStats streamTimes;
+		FrameStats readerTimes;
+		for (int run = 0; run < fileReadRuns; ++run)
+		{
+			Uint64 streamStart = SDL_GetPerformanceCounter();
+			Mesh* streamMesh = ReadMeshFileStreams(meshPath);
+			Uint64 readerStart = SDL_GetPerformanceCounter();
+			Mesh* readerMesh = ReadMeshFile(meshPath, &jobSystem);
+			Uint64 readerEnd = SDL_GetPerformanceCounter();
+
+			bool matched = streamMesh && readerMesh && streamMesh->GetVertexCount() == readerMesh->GetVertexCount() &&
+						   streamMesh->GetFaceCount() == readerMesh->GetFaceCount();
+			delete streamMesh;
+			delete readerMesh;
+			if (!matched)
+			{
+				std::cout << "File read mismatch at " << lineCount << " lines" << std::endl;
+				std::remove(meshPath);
+				return 1;
+			}
+
+			double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+			streamTimes.Add(static_cast<float>((readerStart - streamStart) * 1000.0 / frequency));
+			readerTimes.Add(static_cast<float>((readerEnd - readerStart) * 1000.0 / frequency));
+		}
+		std::remove(meshPath);
+
+		FrameStats::Summary streamSummary = streamTimes.Summarize();
+		FrameStats::Summary readerSummary = readerTimes.Summarize();
+		double megabytes = bytes / 1000000.0;
+		double streamRate = streamSummary.p50 > 0.0f ? megabytes / (streamSummary.p50 / 1000.0) : 0.0;
+		double readerRate = readerSummary.p50 > 0.0f ? megabytes / (readerSummary.p50 / 1000.0) : 0.0;
+
+		outFile << (firstRun ? "\n" : ",\n") << "\t\t{\n";
+		outFile << "\t\t\t\"lines\": " << lineCount << ",\n";
+		outFile << "\t\t\t\"bytes\": " << bytes << ",\n";
+		outFile << "\t\t\t\"streamMs\": ";
+		streamTimes.WriteJson(outFile);
+		outFile << ",\n\t\t\t\"readerMs\": ";
+		readerTimes.WriteJson(outFile);
+		outFile << ",\n";
+		outFile << "\t\t\t\"streamMBps\": " << streamRate << ",\n";
+		outFile << "\t\t\t\"readerMBps\": " << readerRate << "\n";
+		outFile << "\t\t}";
+		firstRun = false;
+
+		std::cout << "file read " << lineCount << " lines (" << megabytes << " MB): streams " << streamRate
+				  << " MB/s, reader " << readerRate << " MB/s on " << threadCount << " threads" << std::endl;
+	}
+
+	outFile << "\n\t]\n}\n";
+	return 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Times the cost of the engine's API functions that get called the most
+//		times a frame. Every frame checks a key and renders a cube the given
+//		number of times, then updates the engine. The engine replays a
+//		recording that holds the key down the whole run, so it has an input
+//		system even headless and the key checks go all the way through it
+//
+//	Param callCount:
+//		How many times each function is called a frame
+//
+//	Param frameCount:
+//		How many frames to time after the warmup
+//
+//	Param warmupFrames:
+//		How many frames to run before timing
+//
+//	Param config:
+//		How to start the engine
+//
+//	Param outPath:
+//		Where to write the results
+//
+//	Return:
+//		Returns the exit code for main
+//*****************************************************************************
+static int RunApiCallBench(int callCount, int frameCount, int warmupFrames, EngineConfig config, const char* outPath)
+{
+	// W goes down on the first frame and stays down, every other frame has no changes
+	const char* inputPath = "ApiCallBench.dinput";
+	InputRecorder recorder;
+	if (!recorder.Open(inputPath))
+		return 1;
+	InputKeyChange keyDown;
+	keyDown.scancode = static_cast<uint16_t>(SDL_SCANCODE_W);
+	keyDown.state = static_cast<uint8_t>(InputSystem::Down);
+	InputFrame inputFrame;
+	inputFrame.dt = fixedDt;
+	inputFrame.keyChanges.push_back(keyDown);
+	for (int frame = 0; frame < warmupFrames + frameCount; ++frame)
+	{
+		recorder.WriteFrame(inputFrame);
+		inputFrame.keyChanges.clear();
+	}
+	recorder.Close();
+
+	config.frameCount = warmupFrames + frameCount;
+	config.replayInputPath = inputPath;
+	try
+	{
+		DckEInitialize(config);
+	}
+	catch (const std::runtime_error& error)
+	{
+		std::cout << "Bench failed to start: " << error.what() << std::endl;
+		std::remove(inputPath);
+		return 1;
+	}
+
+	// A grid of spots in front of the camera, so none of the cubes get culled
+	DckMesh* cube = MeshLibraryGet("Cube");
+	std::vector<glm::mat4> modelMats(apiCallSpots);
+	for (int i = 0; i < apiCallSpots; ++i)
+		modelMats[i] = GfxMath::Translate(GfxMath::Vector(i % 10 - 4.5f, i / 10 % 10 - 4.5f, 0.0f)) * GfxMath::Scale3D(0.25f);
+
+	FrameStats keyTimes;
+	FrameStats renderTimes;
+	int keysDown = 0;
+	int frame = 0;
+	while (DckEIsRunning())
+	{
+		Uint64 keyStart = SDL_GetPerformanceCounter();
+		for (int i = 0; i < callCount; ++i)
+			keysDown += DckEKeyIsDown(SDL_SCANCODE_W) ? 1 : 0;
+		Uint64 renderStart = SDL_GetPerformanceCounter();
+		for (int i = 0; i < callCount; ++i)
+			DckERender(cube, RenderType::Triangles, modelMats[i % apiCallSpots], glm::vec3(1.0f));
+		Uint64 renderEnd = SDL_GetPerformanceCounter();
+
+		DckEUpdate(fixedDt);
+
+		if (frame >= warmupFrames)
+		{
+			double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+			keyTimes.Add(static_cast<float>((renderStart - keyStart) * 1000.0 / frequency));
+			renderTimes.Add(static_cast<float>((renderEnd - renderStart) * 1000.0 / frequency));
+		}
+		++frame;
+	}
+
+	DckEShutdown();
+	std::remove(inputPath);
+
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	FrameStats::Summary keySummary = keyTimes.Summarize();
+	FrameStats::Summary renderSummary = renderTimes.Summarize();
+	double keyCallNs = keySummary.p50 * 1000000.0 / callCount;
+	double renderCallNs = renderSummary.p50 * 1000000.0 / callCount;
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"apiCalls\",\n";
+	outFile << "\t\"callsPerFrame\": " << callCount << ",\n";
+	outFile << "\t\"headless\": " << (config.headless ? "true" : "false") << ",\n";
+	outFile << "\t\"frames\": " << keyTimes.GetCount() << ",\n";
+	outFile << "\t\"warmupFrames\": " << warmupFrames << ",\n";
+	outFile << "\t\"keysDown\": " << keysDown << ",\n";
+	outFile << "\t\"keyIsDownMs\": ";
+	keyTimes.WriteJson(outFile);
+	outFile << ",\n\t\"renderMs\": ";
+	renderTimes.WriteJson(outFile);
+	outFile << ",\n";
+	outFile << "\t\"keyIsDownNsPerCall\": " << keyCallNs << ",\n";
+	outFile << "\t\"renderNsPerCall\": " << renderCallNs << "\n";
+	outFile << "}\n";
+
+	std::cout << "api calls: " << callCount << " a frame, DckEKeyIsDown p50 " << keySummary.p50 << " ms (" << keyCallNs
+			  << " ns a call), DckERender p50 " << renderSummary.p50 << " ms (" << renderCallNs << " ns a call)" << std::endl;
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+	// Defaults, then the preset, then anything given explicitly on top of it
+	const BenchPreset* preset = &presets[0];
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		if (std::string(argv[i]) != "--preset")
+			continue;
+
+		preset = nullptr;
+		for (const BenchPreset& candidate : presets)
+		{
+			if (candidate.name == std::string(argv[i + 1]))
+				preset = &candidate;
+		}
+		if (!preset)
+		{
+			std::cout << "Unknown preset: " << argv[i + 1] << std::endl;
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	BenchSceneParams params;
+	params.objectCount = preset->objectCount;
+	params.lightCount = preset->lightCount;
+	params.meshDetail = preset->meshDetail;
+	params.renderMode = preset->renderMode;
+
+	EngineConfig config;
+	config.headless = true;
+	int frameCount = 1000;
+	int warmupFrames = 60;
+	const char* outPath = "BenchResults.json";
+	int transformCount = 0;
+	bool culling = false;
+	int meshLoadTriangles = 0;
+	bool fileRead = false;
+	bool allocCheck = false;
+	int apiCallCount = 0;
+	bool transformCheck = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		bool hasValue = i + 1 < argc;
+		if (arg == "--preset" && hasValue)
+			++i;
+		else if (arg == "--objects" && hasValue)
+			params.objectCount = std::stoi(argv[++i]);
+		else if (arg == "--lights" && hasValue)
+			params.lightCount = std::stoi(argv[++i]);
+		else if (arg == "--detail" && hasValue)
+			params.meshDetail = std::stoi(argv[++i]);
+		else if (arg == "--mode" && hasValue)
+		{
+			std::string mode(argv[++i]);
+			params.renderMode = mode == "points" ? RenderType::Points : (mode == "lines" ? RenderType::Lines : RenderType::Triangles);
+		}
+		else if (arg == "--frames" && hasValue)
+			frameCount = std::stoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			warmupFrames = std::stoi(argv[++i]);
+		else if (arg == "--size" && i + 2 < argc)
+		{
+			config.width = std::stoi(argv[++i]);
+			config.height = std::stoi(argv[++i]);
+		}
+		else if (arg == "--render-thread")
+			config.renderThread = true;
+		else if (arg == "--windowed")
+			config.headless = false;
+		else if (arg == "--out" && hasValue)
+			outPath = argv[++i];
+		else if (arg == "--transforms" && hasValue)
+			transformCount = std::stoi(argv[++i]);
+		else if (arg == "--culling")
+			culling = true;
+		else if (arg == "--mesh-load" && hasValue)
+			meshLoadTriangles = std::stoi(argv[++i]);
+		else if (arg == "--file-read")
+			fileRead = true;
+		else if (arg == "--alloc-check")
+			allocCheck = true;
+		else if (arg == "--api-calls" && hasValue)
+			apiCallCount = std::stoi(argv[++i]);
+		else if (arg == "--transform-check")
+			transformCheck = true;
+		else if (arg == "--replay" && hasValue)
+			config.replayInputPath = argv[++i];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// Transform, culling, file read and transform check runs don't need the engine at all
+	if (transformCheck)
+		return RunTransformCheck(outPath);
+	if (transformCount > 0)
+		return RunTransformBench(transformCount, frameCount, warmupFrames, outPath);
+	if (culling)
+		return RunCullingBench(frameCount, warmupFrames, outPath);
+	if (fileRead)
+		return RunFileReadBench(outPath);
+	if (meshLoadTriangles > 0)
+		return RunMeshLoadBench(meshLoadTriangles, config, outPath);
+	if (apiCallCount > 0)
+		return RunApiCallBench(apiCallCount, frameCount, warmupFrames, config, outPath);
+
+	// The engine stops itself once every frame has run, or sooner if a replay runs out first
+	config.frameCount = warmupFrames + frameCount;
+
+	try
+	{
+		BenchSceneSetParams(params);
+		DckEInitialize(config);
+		DckESetNextScene(SceneID::BenchScene);
+	}
+	catch (const std::runtime_error& error)
+	{
+		std::cout << "Bench failed to start: " << error.what() << std::endl;
+		return 1;
+	}
+
+	// Time every frame after the warmup, along with how much was drawn. Room for every sample is
+	// made up front, so the bench itself doesn't allocate while allocations are being counted
+	FrameStats frameTimes;
+	FrameStats gpuTimes;
+	frameTimes.Reserve(frameCount);
+	gpuTimes.Reserve(frameCount);
+	double drawCallTotal = 0.0;
+	double triangleTotal = 0.0;
+	double measuredSeconds = 0.0;
+	long long maxFrameAllocs = 0;
+	int frame = 0;
+	Uint64 lastTicks = SDL_GetPerformanceCounter();
+	while (DckEIsRunning())
+	{
+		// Only frames after the warmup count, by then everything should have grown to its steady size
+		if (frame == warmupFrames)
+			countingAllocs = true;
+		long long frameStartAllocs = allocCount.load();
+		DckEUpdate(fixedDt);
+
+		Uint64 now = SDL_GetPerformanceCounter();
+		float frameMs = static_cast<float>((now - lastTicks) * 1000.0 / SDL_GetPerformanceFrequency());
+		lastTicks = now;
+
+		if (frame >= warmupFrames)
+		{
+			RenderSystem::RenderStats stats = DckEGetStats();
+			frameTimes.Add(frameMs);
+			gpuTimes.Add(stats.gpuPassMs[RenderSystem::MainPass] + stats.gpuPassMs[RenderSystem::DebugPass]);
+			drawCallTotal += stats.drawCalls;
+			triangleTotal += stats.triangleCount;
+			measuredSeconds += frameMs / 1000.0;
+		}
+
+		// Whatever any thread allocated since this frame started goes to this frame
+		maxFrameAllocs = std::max(maxFrameAllocs, allocCount.load() - frameStartAllocs);
+		++frame;
+	}
+
+	countingAllocs = false;
+	DckEShutdown();
+
+	int measuredFrames = frameTimes.GetCount();
+	double framesDivisor = measuredFrames > 0 ? measuredFrames : 1.0;
+	double trianglesPerSecond = measuredSeconds > 0.0 ? triangleTotal / measuredSeconds : 0.0;
+	long long heapAllocs = allocCount;
+
+	std::ofstream outFile(outPath, std::ios::trunc);
+	if (!outFile.is_open())
+	{
+		std::cout << "Failed to write bench results: " << outPath << std::endl;
+		return 1;
+	}
+
+	outFile << "{\n";
+	outFile << "\t\"preset\": \"" << preset->name << "\",\n";
+	outFile << "\t\"objects\": " << params.objectCount << ",\n";
+	outFile << "\t\"lights\": " << params.lightCount << ",\n";
+	outFile << "\t\"meshDetail\": " << params.meshDetail << ",\n";
+	outFile << "\t\"renderMode\": \"" << RenderModeName(params.renderMode) << "\",\n";
+	outFile << "\t\"width\": " << config.width << ",\n";
+	outFile << "\t\"height\": " << config.height << ",\n";
+	outFile << "\t\"headless\": " << (config.headless ? "true" : "false") << ",\n";
+	outFile << "\t\"renderThread\": " << (config.renderThread ? "true" : "false") << ",\n";
+	outFile << "\t\"replay\": ";
+	if (config.replayInputPath)
+		WriteJsonString(outFile, config.replayInputPath);
+	else
+		outFile << "null";
+	outFile << ",\n";
+	outFile << "\t\"frames\": " << measuredFrames << ",\n";
+	outFile << "\t\"warmupFrames\": " << warmupFrames << ",\n";
+	outFile << "\t\"frameMs\": ";
+	frameTimes.WriteJson(outFile);
+	outFile << ",\n\t\"gpuMs\": ";
+	gpuTimes.WriteJson(outFile);
+	outFile << ",\n";
+	outFile << "\t\"drawCallsPerFrame\": " << drawCallTotal / framesDivisor << ",\n";
+	outFile << "\t\"trianglesPerFrame\": " << triangleTotal / framesDivisor << ",\n";
+	outFile << "\t\"trianglesPerSecond\": " << trianglesPerSecond << ",\n";
+	outFile << "\t\"heapAllocsPerFrame\": " << heapAllocs / framesDivisor << ",\n";
+	outFile << "\t\"heapAllocsMaxFrame\": " << maxFrameAllocs << "\n";
+	outFile << "}\n";
+
+	FrameStats::Summary summary = frameTimes.Summarize();
+	std::cout << preset->name << ": p50 " << summary.p50 << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99
+			  << " ms, " << trianglesPerSecond / 1000000.0 << " Mtris/s" << std::endl;
+
+	// Steady state frames are supposed to run without touching the heap
+	if (allocCheck && heapAllocs > 0)
+	{
+		std::cout << "Heap allocations in steady state frames: " << heapAllocs << " over " << measuredFrames
+				  << " frames, at most " << maxFrameAllocs << " in one frame" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,152 @@
+//*****************************************************************************
+//	File:   BenchScene.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Stress scene for benchmarking. Fills a grid in front of the
+//		camera with spinning spheres, with the object count, light count,
+//		sphere detail and render mode all set from outside
+//*****************************************************************************
+
+#include "BenchScene.h"
+#include "DckGfxEngine.h"
+#include "GfxMath.h"
+#include "LightingSystem.h"
+#include "RenderObject.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Size of the cube the grid fills, centered in front of the starting camera
+static const float gridSize = 16.0f;
+static const glm::vec4 gridCenter = GfxMath::Point(0, 0, 10);
+
+static BenchSceneParams params;
+static std::vector<RenderObject*> objects;
+
+//*****************************************************************************
+//  Description:
+//		Builds a sphere with smooth normals, plus points and lines along its
+//		rings and segments so it can be drawn in any render mode
+//
+//	Param rings:
+//		How many rings go from pole to pole, there are twice as many segments
+//*****************************************************************************
+static Mesh* BuildSphere(int rings)
+{
+	int segments = rings * 2;
+	Mesh* sphere = new Mesh("BenchSphere" + std::to_string(rings));
+	sphere->Reserve((rings + 1) * (segments + 1), (rings + 1) * (segments + 1), rings * segments * 2, rings * segments * 2);
+
+	const float pi = 3.14159265f;
+	for (int ring = 0; ring <= rings; ++ring)
+	{
+		float phi = pi * ring / rings;
+		for (int segment = 0; segment <= segments; ++segment)
+		{
+			float theta = 2.0f * pi * segment / segments;
+			glm::vec4 normal = GfxMath::Vector(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+			glm::vec3 color(0.5f + 0.5f * normal.x, 0.5f + 0.5f * normal.y, 0.5f + 0.5f * normal.z);
+			sphere->AddVertex(GfxMath::Point(normal.x, normal.y, normal.z), color, normal);
+			sphere->AddPoint(ring * (segments + 1) + segment);
+		}
+	}
+
+	for (int ring = 0; ring < rings; ++ring)
+	{
+		for (int segment = 0; segment < segments; ++segment)
+		{
+			unsigned int v0 = ring * (segments + 1) + segment;
+			unsigned int v1 = v0 + 1;
+			unsigned int v2 = v0 + segments + 1;
+			unsigned int v3 = v2 + 1;
+			sphere->AddFace(v0, v2, v1);
+			sphere->AddFace(v1, v2, v3);
+			sphere->AddEdge(v0, v1);
+			sphere->AddEdge(v0, v2);
+		}
+	}
+	return sphere;
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets what the scene is filled with the next time it loads
+//
+//	Param newParams:
+//		The scene parameters
+//*****************************************************************************
+void BenchSceneSetParams(const BenchSceneParams& newParams)
+{
+	params = newParams;
+}
+
+void BenchSceneLoad()
+{
+	// One sphere mesh shared by every object, pickable since there is only the one copy of it
+	int rings = std::max(params.meshDetail, 2);
+	std::string meshName = "BenchSphere" + std::to_string(rings);
+	if (!MeshLibraryGet(meshName))
+	{
+		Mesh* sphere = BuildSphere(rings);
+		MeshLibraryLoad(meshName, sphere, true);
+		delete sphere;
+	}
+	DckMesh* sphereMesh = MeshLibraryGet(meshName);
+
+	// Fill a grid out to the edges of a cube, leaving room between the spheres
+	int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(std::max(params.objectCount, 1)))));
+	float spacing = gridSize / side;
+	glm::vec4 corner = gridCenter - GfxMath::Vector(gridSize * 0.5f, gridSize * 0.5f, gridSize * 0.5f) + GfxMath::Vector(spacing * 0.5f, spacing * 0.5f, spacing * 0.5f);
+
+	objects.reserve(params.objectCount);
+	for (int i = 0; i < params.objectCount; ++i)
+	{
+		int x = i % side;
+		int y = (i / side) % side;
+		int z = i / (side * side);
+
+		RenderObject* object = new RenderObject("Bench" + std::to_string(i));
+		object->SetMesh(sphereMesh);
+		object->SetRenderMode(params.renderMode);
+		object->SetPosition(corner + GfxMath::Vector(x * spacing, y * spacing, z * spacing));
+		object->SetScale(glm::vec3(spacing * 0.4f));
+		object->SetRotation(GfxMath::Vector(0, 1, 0), static_cast<float>(i % 360));
+		object->SetTint(glm::vec3(0.2f, 0.6f, 1.0f));
+		object->SetDiffuse(glm::vec3(0.8f, 0.8f, 0.8f));
+		object->SetSpecular(glm::vec3(1.0f, 1.0f, 1.0f), 16.0f);
+		DckEObjectManagerAdd(object);
+		objects.push_back(object);
+	}
+
+	// Lights go around the grid in a circle
+	int lightCount = std::min(params.lightCount, maxLights);
+	for (int i = 0; i < lightCount; ++i)
+	{
+		float angle = 6.2831853f * i / lightCount;
+		glm::vec4 lightPos = gridCenter + GfxMath::Vector(std::cos(angle) * gridSize, gridSize * 0.5f, std::sin(angle) * gridSize);
+		DckEAddLight(lightPos, glm::vec3(1.0f, 1.0f, 1.0f) / static_cast<float>(lightCount));
+	}
+}
+
+void BenchSceneInit()
+{
+}
+
+void BenchSceneUpdate(float dt)
+{
+	// Keep every transform changing so the transform update costs the same every frame
+	GfxMath::Quat spin = GfxMath::QuatFromAxisAngle(GfxMath::Vector(0, 1, 0), 45.0f * dt);
+	for (RenderObject* object : objects)
+		object->Rotate(spin);
+}
+
+void BenchSceneShutdown()
+{
+}
+
+void BenchSceneUnload()
+{
+	// The object manager owns and deletes the objects
+	objects.clear();
+}
@@ -0,0 +1,42 @@
+#pragma once
+//*****************************************************************************
+//	File:   BenchScene.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Stress scene for benchmarking. Fills a grid in front of the
+//		camera with spinning spheres, with the object count, light count,
+//		sphere detail and render mode all set from outside
+//*****************************************************************************
+
+#include "Mesh.h"
+
+struct BenchSceneParams {
+
+	// How many spheres are in the grid
+	int objectCount;
+
+	// How many lights there are, up to the lighting system's max
+	int lightCount;
+
+	// Rings of the sphere mesh, each with twice as many segments. Triangles go up with the square of this
+	int meshDetail;
+
+	// How every sphere is drawn
+	RenderType renderMode;
+
+	BenchSceneParams() :
+		objectCount(1000),
+		lightCount(2),
+		meshDetail(16),
+		renderMode(RenderType::Triangles)
+	{}
+
+};
+
+void BenchSceneSetParams(const BenchSceneParams& params);
+
+void BenchSceneLoad();
+void BenchSceneInit();
+void BenchSceneUpdate(float dt);
+void BenchSceneShutdown();
+void BenchSceneUnload();
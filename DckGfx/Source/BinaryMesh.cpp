@@ -0,0 +1,393 @@
+//*****************************************************************************
+//	File:   BinaryMesh.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Versioned binary mesh format (.dmesh). The file is a header
+//		followed by aligned vertex, color, normal, and index blobs, so it can
+//		be memory mapped and handed straight to OpenGL
+//*****************************************************************************
+
+#include "BinaryMesh.h"
+#include "FileReader.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The blobs are uploaded as is, so their layouts have to match what OpenGL reads
+static_assert(sizeof(glm::vec4) == 16, "vec4 must be tightly packed");
+static_assert(sizeof(glm::vec3) == 12, "vec3 must be tightly packed");
+static_assert(sizeof(Mesh::Edge) == 2 * sizeof(unsigned int), "Edge must be two indices");
+static_assert(sizeof(Mesh::Face) == 3 * sizeof(unsigned int), "Face must be three indices");
+
+//*****************************************************************************
+//  Description:
+//		Rounds an offset up to the blob alignment
+//*****************************************************************************
+static uint64_t AlignOffset(uint64_t offset)
+{
+	return (offset + dmeshAlignment - 1) & ~(dmeshAlignment - 1);
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks that a blob lies inside the file and is aligned
+//
+//	Return:
+//		Returns true if the blob can be read from the mapping
+//*****************************************************************************
+static bool BlobIsValid(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+{
+	if (count == 0)
+		return true;
+	if (offset % dmeshAlignment != 0 || offset < sizeof(DMeshHeader))
+		return false;
+	return offset <= fileSize && count * elementSize <= fileSize - offset;
+}
+
+//*****************************************************************************
+//  Description:
+//		Constructor for a binary mesh, nothing is mapped until Open is called
+//*****************************************************************************
+BinaryMesh::BinaryMesh() :
+	data_(nullptr),
+	size_(0),
+	fileHandle_(nullptr),
+	mapHandle_(nullptr),
+	name_(),
+	view_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Memory maps a .dmesh file and validates its header
+//
+//	Param filepath:
+//		The filepath of the .dmesh file to map
+//
+//	Return:
+//		Returns true if the file was mapped and is a valid .dmesh file
+//*****************************************************************************
+bool BinaryMesh::Open(const char* filepath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "Failed to open binary mesh file: " << filepath << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		std::cout << "Binary mesh file is empty: " << filepath << std::endl;
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		std::cout << "Failed to map binary mesh file: " << filepath << std::endl;
+		return false;
+	}
+
+	fileHandle_ = file;
+	mapHandle_ = mapping;
+	size_ = static_cast<uint64_t>(fileSize.QuadPart);
+	data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	int file = open(filepath, O_RDONLY);
+	if (file < 0)
+	{
+		std::cout << "Failed to open binary mesh file: " << filepath << std::endl;
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(file);
+		std::cout << "Binary mesh file is empty: " << filepath << std::endl;
+		return false;
+	}
+
+	// The mapping keeps the file alive, so the descriptor can be closed right away
+	void* mapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	size_ = static_cast<uint64_t>(fileStat.st_size);
+	data_ = mapped == MAP_FAILED ? nullptr : static_cast<const char*>(mapped);
+#endif
+
+	if (!data_)
+	{
+		std::cout << "Failed to map binary mesh file: " << filepath << std::endl;
+		Close();
+		return false;
+	}
+
+	// Validate the header before trusting any of the offsets in it
+	DMeshHeader header;
+	if (size_ < sizeof(DMeshHeader))
+	{
+		std::cout << "Binary mesh file is too small: " << filepath << std::endl;
+		Close();
+		return false;
+	}
+	memcpy(&header, data_, sizeof(DMeshHeader));
+
+	if (memcmp(header.magic, dmeshMagic, sizeof(dmeshMagic)) != 0 || header.version != dmeshVersion)
+	{
+		std::cout << "Not a supported binary mesh file: " << filepath << std::endl;
+		Close();
+		return false;
+	}
+
+	bool hasNormals = (header.flags & DMeshHeader::HasNormals) != 0;
+	if (!BlobIsValid(header.vertexOffset, header.vertexCount, sizeof(glm::vec4), size_) ||
+		!BlobIsValid(header.colorOffset, header.vertexCount, sizeof(glm::vec3), size_) ||
+		(hasNormals && !BlobIsValid(header.normalOffset, header.vertexCount, sizeof(glm::vec4), size_)) ||
+		!BlobIsValid(header.pointOffset, header.pointCount, sizeof(unsigned int), size_) ||
+		!BlobIsValid(header.edgeOffset, header.edgeCount, sizeof(Mesh::Edge), size_) ||
+		!BlobIsValid(header.faceOffset, header.faceCount, sizeof(Mesh::Face), size_))
+	{
+		std::cout << "Binary mesh file is corrupt: " << filepath << std::endl;
+		Close();
+		return false;
+	}
+
+	// Point the view straight into the mapping
+	header.name[sizeof(header.name) - 1] = '\0';
+	name_ = header.name;
+
+	view_.vertexCount = static_cast<int>(header.vertexCount);
+	view_.pointCount = static_cast<int>(header.pointCount);
+	view_.edgeCount = static_cast<int>(header.edgeCount);
+	view_.faceCount = static_cast<int>(header.faceCount);
+
+	view_.vertices = header.vertexCount ? reinterpret_cast<const glm::vec4*>(data_ + header.vertexOffset) : nullptr;
+	view_.colors = header.vertexCount ? reinterpret_cast<const glm::vec3*>(data_ + header.colorOffset) : nullptr;
+	view_.normals = hasNormals && header.vertexCount ? reinterpret_cast<const glm::vec4*>(data_ + header.normalOffset) : nullptr;
+	view_.points = header.pointCount ? reinterpret_cast<const unsigned int*>(data_ + header.pointOffset) : nullptr;
+	view_.edges = header.edgeCount ? reinterpret_cast<const Mesh::Edge*>(data_ + header.edgeOffset) : nullptr;
+	view_.faces = header.faceCount ? reinterpret_cast<const Mesh::Face*>(data_ + header.faceOffset) : nullptr;
+
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Unmaps the file, invalidating the view
+//*****************************************************************************
+void BinaryMesh::Close()
+{
+#ifdef _WIN32
+	if (data_)
+		UnmapViewOfFile(data_);
+	if (mapHandle_)
+		CloseHandle(static_cast<HANDLE>(mapHandle_));
+	if (fileHandle_)
+		CloseHandle(static_cast<HANDLE>(fileHandle_));
+#else
+	if (data_)
+		munmap(const_cast<char*>(data_), size_);
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	fileHandle_ = nullptr;
+	mapHandle_ = nullptr;
+	name_.clear();
+	view_ = MeshView();
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if a file is currently mapped
+//
+//	Return:
+//		Returns true if a valid .dmesh file is mapped
+//*****************************************************************************
+bool BinaryMesh::IsOpen()
+{
+	return data_ != nullptr;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the name that was stored in the file
+//
+//	Return:
+//		Returns the name of the mesh
+//*****************************************************************************
+std::string BinaryMesh::GetName()
+{
+	return name_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the view of the mapped mesh data
+//
+//	Return:
+//		Returns a view pointing into the mapped file
+//*****************************************************************************
+const MeshView& BinaryMesh::GetView()
+{
+	return view_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Destructor for the binary mesh, which unmaps the file
+//*****************************************************************************
+BinaryMesh::~BinaryMesh()
+{
+	Close();
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes padding so the next blob starts aligned
+//*****************************************************************************
+static void WritePadding(std::ofstream& file, uint64_t currentOffset, uint64_t nextOffset)
+{
+	static const char zeroes[dmeshAlignment] = {};
+	file.write(zeroes, static_cast<std::streamsize>(nextOffset - currentOffset));
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes a mesh to a .dmesh file
+//
+//	Param mesh:
+//		The mesh to write
+//
+//	Param filepath:
+//		Where to write the file
+//
+//	Return:
+//		Returns true if the whole file was written
+//*****************************************************************************
+bool WriteBinaryMeshFile(Mesh* mesh, const char* filepath)
+{
+	if (!mesh)
+		return false;
+
+	MeshView view = mesh->GetView();
+
+	// Fill out the header, laying out each blob after the previous one
+	DMeshHeader header;
+	memset(&header, 0, sizeof(DMeshHeader));
+	memcpy(header.magic, dmeshMagic, sizeof(dmeshMagic));
+	header.version = dmeshVersion;
+	header.flags = view.normals ? DMeshHeader::HasNormals : 0;
+	header.vertexCount = static_cast<uint32_t>(view.vertexCount);
+	header.pointCount = static_cast<uint32_t>(view.pointCount);
+	header.edgeCount = static_cast<uint32_t>(view.edgeCount);
+	header.faceCount = static_cast<uint32_t>(view.faceCount);
+	strncpy(header.name, mesh->GetName().c_str(), sizeof(header.name) - 1);
+
+	uint64_t offset = AlignOffset(sizeof(DMeshHeader));
+	const uint64_t vertexBytes = sizeof(glm::vec4) * header.vertexCount;
+	const uint64_t colorBytes = sizeof(glm::vec3) * header.vertexCount;
+	const uint64_t normalBytes = view.normals ? sizeof(glm::vec4) * header.vertexCount : 0;
+	const uint64_t pointBytes = sizeof(unsigned int) * header.pointCount;
+	const uint64_t edgeBytes = sizeof(Mesh::Edge) * header.edgeCount;
+	const uint64_t faceBytes = sizeof(Mesh::Face) * header.faceCount;
+
+	if (vertexBytes) { header.vertexOffset = offset; offset = AlignOffset(offset + vertexBytes); }
+	if (colorBytes) { header.colorOffset = offset; offset = AlignOffset(offset + colorBytes); }
+	if (normalBytes) { header.normalOffset = offset; offset = AlignOffset(offset + normalBytes); }
+	if (pointBytes) { header.pointOffset = offset; offset = AlignOffset(offset + pointBytes); }
+	if (edgeBytes) { header.edgeOffset = offset; offset = AlignOffset(offset + edgeBytes); }
+	if (faceBytes) { header.faceOffset = offset; offset = AlignOffset(offset + faceBytes); }
+
+	std::ofstream meshFile(filepath, std::ios::binary | std::ios::trunc);
+	if (!meshFile.is_open())
+	{
+		std::cout << "Failed to open or create file: " << filepath << std::endl;
+		return false;
+	}
+
+	// Write the header, then every blob in the order they were laid out
+	meshFile.write(reinterpret_cast<const char*>(&header), sizeof(DMeshHeader));
+	uint64_t written = sizeof(DMeshHeader);
+
+	const struct {
+		uint64_t offset;
+		uint64_t bytes;
+		const void* data;
+	} blobs[] = {
+		{ header.vertexOffset, vertexBytes, view.vertices },
+		{ header.colorOffset, colorBytes, view.colors },
+		{ header.normalOffset, normalBytes, view.normals },
+		{ header.pointOffset, pointBytes, view.points },
+		{ header.edgeOffset, edgeBytes, view.edges },
+		{ header.faceOffset, faceBytes, view.faces }
+	};
+
+	for (const auto& blob : blobs)
+	{
+		if (!blob.bytes)
+			continue;
+		WritePadding(meshFile, written, blob.offset);
+		meshFile.write(static_cast<const char*>(blob.data), static_cast<std::streamsize>(blob.bytes));
+		written = blob.offset + blob.bytes;
+	}
+
+	if (!meshFile.good())
+	{
+		std::cout << "Failed to write binary mesh file: " << filepath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Converts a text mesh file (Data/Shapes/*.txt) to a .dmesh file next to
+//		it with the same name
+//
+//	Param textFilepath:
+//		The filepath of the text mesh file to convert
+//
+//	Return:
+//		Returns true if the mesh was read and the binary file was written
+//*****************************************************************************
+bool ConvertMeshFile(const char* textFilepath)
+{
+	Mesh* mesh = ReadMeshFile(textFilepath);
+	if (!mesh)
+	{
+		std::cout << "Failed to read mesh file: " << textFilepath << std::endl;
+		return false;
+	}
+
+	// Swap the extension out for .dmesh
+	std::string binaryFilepath(textFilepath);
+	size_t extension = binaryFilepath.find_last_of('.');
+	size_t directory = binaryFilepath.find_last_of("/\\");
+	if (extension != std::string::npos && (directory == std::string::npos || extension > directory))
+		binaryFilepath.erase(extension);
+	binaryFilepath += ".dmesh";
+
+	bool worked = WriteBinaryMeshFile(mesh, binaryFilepath.c_str());
+	delete mesh;
+	return worked;
+}
@@ -0,0 +1,89 @@
+#pragma once
+//*****************************************************************************
+//	File:   BinaryMesh.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Versioned binary mesh format (.dmesh). The file is a header
+//		followed by aligned vertex, color, normal, and index blobs, so it can
+//		be memory mapped and handed straight to OpenGL
+//*****************************************************************************
+
+#include "Mesh.h"
+#include <cstdint>
+#include <string>
+
+// Magic, version, and blob alignment of .dmesh files
+static const char dmeshMagic[4] = { 'D', 'M', 'S', 'H' };
+static const uint32_t dmeshVersion = 1;
+static const uint64_t dmeshAlignment = 16;
+
+//*****************************************************************************
+//  Description:
+//		Header at the start of every .dmesh file. Offsets are from the start
+//		of the file, and a blob with a count of zero has an offset of zero
+//*****************************************************************************
+struct DMeshHeader {
+	enum Flags {
+		HasNormals = 1 << 0
+	};
+
+	char magic[4];
+	uint32_t version;
+	uint32_t flags;
+	uint32_t vertexCount;
+	uint32_t pointCount;
+	uint32_t edgeCount;
+	uint32_t faceCount;
+	uint32_t reserved;
+
+	uint64_t vertexOffset;
+	uint64_t colorOffset;
+	uint64_t normalOffset;
+	uint64_t pointOffset;
+	uint64_t edgeOffset;
+	uint64_t faceOffset;
+
+	char name[64];
+};
+
+//*****************************************************************************
+//  Description:
+//		A .dmesh file that has been memory mapped. The view points directly
+//		into the mapping, so it is only valid while this object is alive
+//*****************************************************************************
+class BinaryMesh {
+public:
+
+	BinaryMesh();
+
+	bool Open(const char* filepath);
+	void Close();
+
+	bool IsOpen();
+
+	std::string GetName();
+	const MeshView& GetView();
+
+	~BinaryMesh();
+
+private:
+
+	// Not copyable, the mapping is owned by this object
+	BinaryMesh(const BinaryMesh&);
+	BinaryMesh& operator=(const BinaryMesh&);
+
+	// The mapped file data and its size
+	const char* data_;
+	uint64_t size_;
+
+	// Platform handles for the mapping
+	void* fileHandle_;
+	void* mapHandle_;
+
+	// Name and view of the mapped mesh
+	std::string name_;
+	MeshView view_;
+};
+
+bool WriteBinaryMeshFile(Mesh* mesh, const char* filepath);
+bool ConvertMeshFile(const char* textFilepath);
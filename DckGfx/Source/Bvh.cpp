@@ -0,0 +1,854 @@
+//*****************************************************************************
+//	File:   Bvh.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Dynamic bounding volume hierarchy of axis aligned boxes, for
+//		culling and spatial queries. Can be built all at once with the
+//		surface area heuristic, and kept up to date with inserts, removes
+//		and refits as things move
+//*****************************************************************************
+
+#include "Bvh.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cfloat>
+
+// How many buckets centers are sorted into when looking for the best split
+static const int sahBinCount = 12;
+
+// Relative cost of stepping through a node compared to testing a leaf
+static const float sahTraversalCost = 1.0f;
+
+//*****************************************************************************
+//  Description:
+//		Makes an empty box, which grows to fit whatever is added to it
+//*****************************************************************************
+Aabb::Aabb() :
+	min(FLT_MAX),
+	max(-FLT_MAX)
+{
+}
+
+Aabb::Aabb(const glm::vec3& boxMin, const glm::vec3& boxMax) :
+	min(boxMin),
+	max(boxMax)
+{
+}
+
+void Aabb::Grow(const Aabb& other)
+{
+	min = glm::min(min, other.min);
+	max = glm::max(max, other.max);
+}
+
+bool Aabb::Contains(const Aabb& other) const
+{
+	return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+		   max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+}
+
+bool Aabb::Overlaps(const Aabb& other) const
+{
+	return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+		   max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+}
+
+bool Aabb::IsEmpty() const
+{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the surface area of the box, which is how likely a random ray
+//		is to hit it. An empty box has none
+//*****************************************************************************
+float Aabb::SurfaceArea() const
+{
+	if (IsEmpty())
+		return 0.0f;
+
+	glm::vec3 size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+glm::vec3 Aabb::GetCenter() const
+{
+	return 0.5f * (min + max);
+}
+
+glm::vec3 Aabb::GetExtents() const
+{
+	return 0.5f * (max - min);
+}
+
+//*****************************************************************************
+//  Description:
+//		Distance along a ray to where it enters the box. A ray starting
+//		inside the box enters it right away
+//
+//	Param origin:
+//		Where the ray starts
+//
+//	Param invDir:
+//		One over each component of the ray's direction
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Return:
+//		Returns the distance, or a negative number if the ray misses the box
+//		or only reaches it after maxDist
+//*****************************************************************************
+float Aabb::RayDistance(const glm::vec3& origin, const glm::vec3& invDir, float maxDist) const
+{
+	glm::vec3 t0 = (min - origin) * invDir;
+	glm::vec3 t1 = (max - origin) * invDir;
+	glm::vec3 tNear = glm::min(t0, t1);
+	glm::vec3 tFar = glm::max(t0, t1);
+	float enter = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+	float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDist));
+	return enter <= exit ? enter : -1.0f;
+}
+
+Aabb Aabb::Union(const Aabb& first, const Aabb& second)
+{
+	return Aabb(glm::min(first.min, second.min), glm::max(first.max, second.max));
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the box around a transformed box
+//
+//	Param box:
+//		The box in object space
+//
+//	Param trans:
+//		The object to world matrix
+//
+//	Return:
+//		The axis aligned box in world space that holds the transformed box
+//*****************************************************************************
+Aabb Aabb::Transform(const Aabb& box, const glm::mat4& trans)
+{
+	glm::vec3 center(trans * glm::vec4(box.GetCenter(), 1.0f));
+	glm::vec3 extents = box.GetExtents();
+	glm::vec3 worldExtents = glm::abs(glm::vec3(trans[0])) * extents.x + glm::abs(glm::vec3(trans[1])) * extents.y +
+							 glm::abs(glm::vec3(trans[2])) * extents.z;
+	return Aabb(center - worldExtents, center + worldExtents);
+}
+
+//*****************************************************************************
+//  Description:
+//		Constructor for a tree
+//
+//	Param margin:
+//		How much leaf boxes are grown by on every side, as a fraction of
+//		their size. Trees of things that move use a margin so small moves
+//		don't change the tree, trees of things that don't should use 0
+//*****************************************************************************
+Bvh::Bvh(float margin) :
+	margin_(margin),
+	nodes_(),
+	root_(nullNode),
+	freeNode_(nullNode),
+	proxies_(),
+	freeProxy_(nullNode),
+	proxyCount_(0),
+	refitCount_(0),
+	buildItems_(),
+	stack_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a box to the tree. It goes next to whichever node makes the
+//		tree's total surface area grow the least
+//
+//	Param box:
+//		The box to add
+//
+//	Return:
+//		Returns the proxy id for the box
+//*****************************************************************************
+int Bvh::Insert(const Aabb& box)
+{
+	int proxy;
+	if (freeProxy_ != nullNode)
+	{
+		proxy = freeProxy_;
+		freeProxy_ = proxies_[proxy].nextFree;
+	}
+	else
+	{
+		proxy = static_cast<int>(proxies_.size());
+		proxies_.push_back(Proxy());
+	}
+
+	int leaf = AllocateNode();
+	nodes_[leaf].box = Fatten(box);
+	nodes_[leaf].proxy = proxy;
+	proxies_[proxy].box = box;
+	proxies_[proxy].leaf = leaf;
+	proxies_[proxy].nextFree = nullNode;
+	++proxyCount_;
+
+	InsertLeaf(leaf);
+	return proxy;
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes a box out of the tree. Its sibling takes its parent's place
+//
+//	Param proxy:
+//		The proxy id from Insert
+//*****************************************************************************
+void Bvh::Remove(int proxy)
+{
+	int leaf = proxies_[proxy].leaf;
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+
+	proxies_[proxy].leaf = nullNode;
+	proxies_[proxy].nextFree = freeProxy_;
+	freeProxy_ = proxy;
+	--proxyCount_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Changes the box of something in the tree. If it still fits in its
+//		leaf nothing else changes, otherwise the leaf is grown and every
+//		node above it is refit, without changing the shape of the tree
+//
+//	Param proxy:
+//		The proxy id from Insert
+//
+//	Param box:
+//		The new box
+//
+//	Return:
+//		Returns true if the tree had to be refit
+//*****************************************************************************
+bool Bvh::Move(int proxy, const Aabb& box)
+{
+	proxies_[proxy].box = box;
+	int leaf = proxies_[proxy].leaf;
+	if (nodes_[leaf].box.Contains(box))
+		return false;
+
+	nodes_[leaf].box = Fatten(box);
+	RefitUpFrom(nodes_[leaf].parent);
+	++refitCount_;
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Rebuilds the whole tree from top to bottom. Each node is split where
+//		the surface area heuristic says rays or frustums will have to check
+//		the fewest boxes, which makes a much better tree than inserting one
+//		at a time
+//*****************************************************************************
+void Bvh::Build()
+{
+	DCK_PROFILE_ZONE("Build BVH");
+
+	nodes_.clear();
+	freeNode_ = nullNode;
+	root_ = nullNode;
+	refitCount_ = 0;
+
+	buildItems_.clear();
+	for (int proxy = 0; proxy < static_cast<int>(proxies_.size()); ++proxy)
+	{
+		if (proxies_[proxy].leaf == nullNode)
+			continue;
+
+		BuildItem item;
+		item.box = proxies_[proxy].box;
+		item.center = item.box.GetCenter();
+		item.proxy = proxy;
+		buildItems_.push_back(item);
+	}
+
+	if (buildItems_.empty())
+		return;
+
+	nodes_.reserve(2 * buildItems_.size() - 1);
+	root_ = BuildRange(buildItems_.data(), static_cast<int>(buildItems_.size()), nullNode);
+}
+
+//*****************************************************************************
+//  Description:
+//		Rebuilds the tree if enough has moved since the last build that the
+//		refit boxes are probably much bigger than they need to be
+//
+//	Return:
+//		Returns true if the tree was rebuilt
+//*****************************************************************************
+bool Bvh::Optimize()
+{
+	if (refitCount_ <= proxyCount_ / 2)
+		return false;
+
+	Build();
+	return true;
+}
+
+void Bvh::Clear()
+{
+	nodes_.clear();
+	root_ = nullNode;
+	freeNode_ = nullNode;
+	proxies_.clear();
+	freeProxy_ = nullNode;
+	proxyCount_ = 0;
+	refitCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the box something was given, without the margin
+//*****************************************************************************
+const Aabb& Bvh::GetBox(int proxy)
+{
+	return proxies_[proxy].box;
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds everything that could be seen in a frustum. Once a node is all
+//		the way inside, everything under it is added without checking. Those
+//		nodes go on the stack flipped negative
+//
+//	Param frustum:
+//		The frustum to check against
+//
+//	Param results:
+//		Proxy ids of every box at least partly inside are added to this
+//*****************************************************************************
+void Bvh::QueryFrustum(const Frustum& frustum, std::vector<int>& results)
+{
+	if (root_ == nullNode)
+		return;
+
+	stack_.clear();
+	stack_.push_back(root_);
+	while (!stack_.empty())
+	{
+		int index = stack_.back();
+		stack_.pop_back();
+
+		if (index < 0)
+		{
+			const Node& inside = nodes_[~index];
+			if (inside.proxy != nullNode)
+				results.push_back(inside.proxy);
+			else
+			{
+				stack_.push_back(~inside.children[0]);
+				stack_.push_back(~inside.children[1]);
+			}
+			continue;
+		}
+
+		const Node& node = nodes_[index];
+
+		// Leaves check the box they were given, which is tighter than the leaf's
+		if (node.proxy != nullNode)
+		{
+			const Aabb& box = proxies_[node.proxy].box;
+			if (frustum.BoxVisible(box.GetCenter(), box.GetExtents()))
+				results.push_back(node.proxy);
+			continue;
+		}
+
+		Frustum::Containment containment = frustum.ClassifyBox(node.box.GetCenter(), node.box.GetExtents());
+		if (containment == Frustum::Inside)
+			stack_.push_back(~index);
+		else if (containment == Frustum::Intersects)
+		{
+			stack_.push_back(node.children[0]);
+			stack_.push_back(node.children[1]);
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds every box that touches a sphere
+//
+//	Param center:
+//		The center of the sphere
+//
+//	Param radius:
+//		The radius of the sphere
+//
+//	Param results:
+//		Proxy ids of every box touching the sphere are added to this
+//*****************************************************************************
+void Bvh::QuerySphere(const glm::vec3& center, float radius, std::vector<int>& results)
+{
+	if (root_ == nullNode)
+		return;
+
+	float radiusSq = radius * radius;
+	stack_.clear();
+	stack_.push_back(root_);
+	while (!stack_.empty())
+	{
+		const Node& node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		// Distance from the center to the closest point in the box
+		const Aabb& box = node.proxy != nullNode ? proxies_[node.proxy].box : node.box;
+		glm::vec3 offset = center - glm::clamp(center, box.min, box.max);
+		if (glm::dot(offset, offset) > radiusSq)
+			continue;
+
+		if (node.proxy != nullNode)
+			results.push_back(node.proxy);
+		else
+		{
+			stack_.push_back(node.children[0]);
+			stack_.push_back(node.children[1]);
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds every box that overlaps another box
+//
+//	Param box:
+//		The box to check against
+//
+//	Param results:
+//		Proxy ids of every overlapping box are added to this
+//*****************************************************************************
+void Bvh::QueryBox(const Aabb& box, std::vector<int>& results)
+{
+	if (root_ == nullNode)
+		return;
+
+	stack_.clear();
+	stack_.push_back(root_);
+	while (!stack_.empty())
+	{
+		const Node& node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		const Aabb& nodeBox = node.proxy != nullNode ? proxies_[node.proxy].box : node.box;
+		if (!nodeBox.Overlaps(box))
+			continue;
+
+		if (node.proxy != nullNode)
+			results.push_back(node.proxy);
+		else
+		{
+			stack_.push_back(node.children[0]);
+			stack_.push_back(node.children[1]);
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds the closest thing a ray hits. Children are visited closest
+//		first, and anything further than the closest hit so far is skipped
+//
+//	Param origin:
+//		Where the ray starts
+//
+//	Param dir:
+//		Which way the ray goes, distances are in multiples of its length
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Param hitTest:
+//		Checks the actual shape of each proxy the ray reaches the box of. If
+//		empty, hitting the box counts
+//
+//	Param hitProxy:
+//		Set to the proxy id that was hit, or -1 if nothing was
+//
+//	Return:
+//		Returns how far along the ray the closest hit was, or a negative
+//		number if nothing was hit
+//*****************************************************************************
+float Bvh::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, const RayHitTest& hitTest, int* hitProxy)
+{
+	*hitProxy = nullNode;
+	if (root_ == nullNode)
+		return -1.0f;
+
+	// Axes the ray doesn't move along get a huge inverse, so the slabs still compare correctly
+	glm::vec3 invDir;
+	for (int axis = 0; axis < 3; ++axis)
+		invDir[axis] = dir[axis] != 0.0f ? 1.0f / dir[axis] : FLT_MAX;
+
+	float closest = maxDist;
+	stack_.clear();
+	if (nodes_[root_].box.RayDistance(origin, invDir, closest) >= 0.0f)
+		stack_.push_back(root_);
+
+	while (!stack_.empty())
+	{
+		const Node& node = nodes_[stack_.back()];
+		stack_.pop_back();
+
+		if (node.proxy != nullNode)
+		{
+			float boxDist = proxies_[node.proxy].box.RayDistance(origin, invDir, closest);
+			if (boxDist < 0.0f)
+				continue;
+
+			float hitDist = hitTest ? hitTest(node.proxy, closest) : boxDist;
+			if (hitDist >= 0.0f && hitDist <= closest)
+			{
+				closest = hitDist;
+				*hitProxy = node.proxy;
+			}
+			continue;
+		}
+
+		// Pushed furthest first, so the closer child is looked at next
+		float dist0 = nodes_[node.children[0]].box.RayDistance(origin, invDir, closest);
+		float dist1 = nodes_[node.children[1]].box.RayDistance(origin, invDir, closest);
+		int first = node.children[0];
+		int second = node.children[1];
+		if (dist1 >= 0.0f && (dist0 < 0.0f || dist1 < dist0))
+		{
+			std::swap(first, second);
+			std::swap(dist0, dist1);
+		}
+		if (dist1 >= 0.0f)
+			stack_.push_back(second);
+		if (dist0 >= 0.0f)
+			stack_.push_back(first);
+	}
+
+	return *hitProxy != nullNode ? closest : -1.0f;
+}
+
+int Bvh::GetCount()
+{
+	return proxyCount_;
+}
+
+int Bvh::GetHeight()
+{
+	return root_ == nullNode ? 0 : Height(root_);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the surface area heuristic cost of the tree, which is roughly
+//		how many boxes a random ray has to check relative to the root.
+//		Lower is better, for comparing builds
+//*****************************************************************************
+float Bvh::GetCost()
+{
+	if (root_ == nullNode)
+		return 0.0f;
+
+	float rootArea = nodes_[root_].box.SurfaceArea();
+	if (rootArea <= 0.0f)
+		return 0.0f;
+
+	float internalArea = 0.0f;
+	float leafArea = 0.0f;
+	for (const Proxy& proxy : proxies_)
+	{
+		if (proxy.leaf != nullNode)
+			leafArea += nodes_[proxy.leaf].box.SurfaceArea();
+	}
+
+	stack_.clear();
+	stack_.push_back(root_);
+	while (!stack_.empty())
+	{
+		const Node& node = nodes_[stack_.back()];
+		stack_.pop_back();
+		if (node.proxy != nullNode)
+			continue;
+
+		internalArea += node.box.SurfaceArea();
+		stack_.push_back(node.children[0]);
+		stack_.push_back(node.children[1]);
+	}
+	return (sahTraversalCost * internalArea + leafArea) / rootArea;
+}
+
+Bvh::~Bvh()
+{
+}
+
+int Bvh::AllocateNode()
+{
+	int node;
+	if (freeNode_ != nullNode)
+	{
+		node = freeNode_;
+		freeNode_ = nodes_[node].parent;
+	}
+	else
+	{
+		node = static_cast<int>(nodes_.size());
+		nodes_.push_back(Node());
+	}
+
+	nodes_[node].box = Aabb();
+	nodes_[node].parent = nullNode;
+	nodes_[node].children[0] = nullNode;
+	nodes_[node].children[1] = nullNode;
+	nodes_[node].proxy = nullNode;
+	return node;
+}
+
+void Bvh::FreeNode(int node)
+{
+	nodes_[node].parent = freeNode_;
+	nodes_[node].proxy = nullNode;
+	freeNode_ = node;
+}
+
+//*****************************************************************************
+//  Description:
+//		Puts a leaf into the tree. Walks down from the root, at each node
+//		weighing up making the leaf its sibling against going further down,
+//		where the cost is how much surface area the tree gains
+//*****************************************************************************
+void Bvh::InsertLeaf(int leaf)
+{
+	if (root_ == nullNode)
+	{
+		root_ = leaf;
+		nodes_[leaf].parent = nullNode;
+		return;
+	}
+
+	const Aabb leafBox = nodes_[leaf].box;
+	int index = root_;
+	while (nodes_[index].proxy == nullNode)
+	{
+		const Node& node = nodes_[index];
+		float area = node.box.SurfaceArea();
+		float combinedArea = Aabb::Union(node.box, leafBox).SurfaceArea();
+
+		// Making a new parent for this node and the leaf, and what every node above already gains
+		float siblingCost = 2.0f * combinedArea;
+		float inheritedCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		for (int i = 0; i < 2; ++i)
+		{
+			const Node& child = nodes_[node.children[i]];
+			float childCombined = Aabb::Union(child.box, leafBox).SurfaceArea();
+			if (child.proxy != nullNode)
+				childCosts[i] = childCombined + inheritedCost;
+			else
+				childCosts[i] = childCombined - child.box.SurfaceArea() + inheritedCost;
+		}
+
+		if (siblingCost < childCosts[0] && siblingCost < childCosts[1])
+			break;
+
+		index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	// New parent for the chosen sibling and the leaf
+	int sibling = index;
+	int oldParent = nodes_[sibling].parent;
+	int newParent = AllocateNode();
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].box = Aabb::Union(leafBox, nodes_[sibling].box);
+	nodes_[newParent].children[0] = sibling;
+	nodes_[newParent].children[1] = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+
+	if (oldParent == nullNode)
+		root_ = newParent;
+	else
+	{
+		Node& parent = nodes_[oldParent];
+		parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+	}
+
+	RefitUpFrom(oldParent);
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes a leaf out of the tree and frees its parent, with the leaf's
+//		sibling moving up into the parent's place
+//*****************************************************************************
+void Bvh::RemoveLeaf(int leaf)
+{
+	if (leaf == root_)
+	{
+		root_ = nullNode;
+		return;
+	}
+
+	int parent = nodes_[leaf].parent;
+	int grandParent = nodes_[parent].parent;
+	int sibling = nodes_[parent].children[nodes_[parent].children[0] == leaf ? 1 : 0];
+
+	if (grandParent == nullNode)
+	{
+		root_ = sibling;
+		nodes_[sibling].parent = nullNode;
+	}
+	else
+	{
+		Node& above = nodes_[grandParent];
+		above.children[above.children[0] == parent ? 0 : 1] = sibling;
+		nodes_[sibling].parent = grandParent;
+		RefitUpFrom(grandParent);
+	}
+	FreeNode(parent);
+}
+
+//*****************************************************************************
+//  Description:
+//		Remakes the boxes of a node and everything above it from their
+//		children, stopping early once a box doesn't change
+//*****************************************************************************
+void Bvh::RefitUpFrom(int node)
+{
+	while (node != nullNode)
+	{
+		Node& current = nodes_[node];
+		Aabb box = Aabb::Union(nodes_[current.children[0]].box, nodes_[current.children[1]].box);
+		if (box.min == current.box.min && box.max == current.box.max)
+			return;
+
+		current.box = box;
+		node = current.parent;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds the tree for a range of proxies. Centers are sorted into
+//		buckets along the longest axis, and the split between buckets with
+//		the lowest surface area cost is used. If every center is in the same
+//		place the range is just cut in half
+//
+//	Return:
+//		Returns the node for the range
+//*****************************************************************************
+int Bvh::BuildRange(BuildItem* items, int count, int parent)
+{
+	int index = AllocateNode();
+	nodes_[index].parent = parent;
+
+	if (count == 1)
+	{
+		nodes_[index].box = Fatten(items[0].box);
+		nodes_[index].proxy = items[0].proxy;
+		proxies_[items[0].proxy].leaf = index;
+		return index;
+	}
+
+	Aabb centerBox;
+	for (int i = 0; i < count; ++i)
+		centerBox.Grow(Aabb(items[i].center, items[i].center));
+
+	glm::vec3 centerSize = centerBox.max - centerBox.min;
+	int axis = centerSize.x > centerSize.y ? (centerSize.x > centerSize.z ? 0 : 2) : (centerSize.y > centerSize.z ? 1 : 2);
+
+	int middle = count / 2;
+	if (centerSize[axis] > 0.0f)
+	{
+		// Sort the centers into buckets and grow each bucket's box
+		Aabb binBoxes[sahBinCount];
+		int binCounts[sahBinCount] = {};
+		float binScale = sahBinCount / centerSize[axis];
+		auto binOf = [&](const BuildItem& item) {
+			int bin = static_cast<int>((item.center[axis] - centerBox.min[axis]) * binScale);
+			return bin < sahBinCount ? bin : sahBinCount - 1;
+		};
+		for (int i = 0; i < count; ++i)
+		{
+			int bin = binOf(items[i]);
+			++binCounts[bin];
+			binBoxes[bin].Grow(items[i].box);
+		}
+
+		// Area and count on the left of each split, then walk back from the right for the costs
+		float leftAreas[sahBinCount - 1];
+		int leftCounts[sahBinCount - 1];
+		Aabb left;
+		int leftCount = 0;
+		for (int i = 0; i < sahBinCount - 1; ++i)
+		{
+			left.Grow(binBoxes[i]);
+			leftCount += binCounts[i];
+			leftAreas[i] = left.SurfaceArea();
+			leftCounts[i] = leftCount;
+		}
+
+		int bestSplit = -1;
+		float bestCost = FLT_MAX;
+		Aabb right;
+		int rightCount = 0;
+		for (int i = sahBinCount - 1; i > 0; --i)
+		{
+			right.Grow(binBoxes[i]);
+			rightCount += binCounts[i];
+			if (leftCounts[i - 1] == 0 || rightCount == 0)
+				continue;
+
+			float cost = leftAreas[i - 1] * leftCounts[i - 1] + right.SurfaceArea() * rightCount;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		if (bestSplit > 0)
+		{
+			BuildItem* split = std::partition(items, items + count, [&](const BuildItem& item) { return binOf(item) < bestSplit; });
+			middle = static_cast<int>(split - items);
+		}
+		else
+		{
+			std::nth_element(items, items + middle, items + count, [&](const BuildItem& first, const BuildItem& second) {
+				return first.center[axis] < second.center[axis];
+			});
+		}
+	}
+
+	int firstChild = BuildRange(items, middle, index);
+	int secondChild = BuildRange(items + middle, count - middle, index);
+	nodes_[index].children[0] = firstChild;
+	nodes_[index].children[1] = secondChild;
+	nodes_[index].box = Aabb::Union(nodes_[firstChild].box, nodes_[secondChild].box);
+	return index;
+}
+
+int Bvh::Height(int node)
+{
+	if (nodes_[node].proxy != nullNode)
+		return 1;
+	return 1 + std::max(Height(nodes_[node].children[0]), Height(nodes_[node].children[1]));
+}
+
+//*****************************************************************************
+//  Description:
+//		Grows a box by the margin, so it can move a little without leaving
+//		its leaf
+//*****************************************************************************
+Aabb Bvh::Fatten(const Aabb& box)
+{
+	glm::vec3 grow = (box.max - box.min) * margin_;
+	return Aabb(box.min - grow, box.max + grow);
+}
@@ -0,0 +1,144 @@
+#pragma once
+//*****************************************************************************
+//	File:   Bvh.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Dynamic bounding volume hierarchy of axis aligned boxes, for
+//		culling and spatial queries. Can be built all at once with the
+//		surface area heuristic, and kept up to date with inserts, removes
+//		and refits as things move
+//*****************************************************************************
+
+#include "Frustum.h"
+#include <functional>
+#include <vector>
+
+//*****************************************************************************
+//  Description:
+//		Axis aligned bounding box
+//*****************************************************************************
+struct Aabb {
+	glm::vec3 min;
+	glm::vec3 max;
+
+	Aabb();
+	Aabb(const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+	void Grow(const Aabb& other);
+	bool Contains(const Aabb& other) const;
+	bool Overlaps(const Aabb& other) const;
+	bool IsEmpty() const;
+	float SurfaceArea() const;
+
+	glm::vec3 GetCenter() const;
+	glm::vec3 GetExtents() const;
+	float RayDistance(const glm::vec3& origin, const glm::vec3& invDir, float maxDist) const;
+
+	static Aabb Union(const Aabb& first, const Aabb& second);
+	static Aabb Transform(const Aabb& box, const glm::mat4& trans);
+};
+
+//*****************************************************************************
+//  Description:
+//		The hierarchy. Everything put in gets a proxy id that stays the same
+//		until it is removed, even when the tree is rebuilt
+//*****************************************************************************
+class Bvh {
+public:
+
+	// Called on each proxy a ray reaches, returns how far along the ray it was hit, or a negative
+	// number for a miss
+	typedef std::function<float(int proxy, float maxDist)> RayHitTest;
+
+	Bvh(float margin = 0.0f);
+
+	int Insert(const Aabb& box);
+	void Remove(int proxy);
+	bool Move(int proxy, const Aabb& box);
+	void Build();
+	bool Optimize();
+	void Clear();
+
+	const Aabb& GetBox(int proxy);
+
+	void QueryFrustum(const Frustum& frustum, std::vector<int>& results);
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& results);
+	void QueryBox(const Aabb& box, std::vector<int>& results);
+	float RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, const RayHitTest& hitTest, int* hitProxy);
+
+	int GetCount();
+	int GetHeight();
+	float GetCost();
+
+	~Bvh();
+
+private:
+
+	static const int nullNode = -1;
+
+	//*************************************************************************
+	//  Description:
+	//		A node in the tree. Leaves have a proxy and no children, and
+	//		their box is the proxy's box grown by the margin
+	//*************************************************************************
+	struct Node {
+		Aabb box;
+		int parent;
+		int children[2];
+		int proxy;
+	};
+
+	//*************************************************************************
+	//  Description:
+	//		Something put in the tree, with the box it was given and the
+	//		leaf it is in. Free proxies point to the next free one instead
+	//*************************************************************************
+	struct Proxy {
+		Aabb box;
+		int leaf;
+		int nextFree;
+	};
+
+	//*************************************************************************
+	//  Description:
+	//		A proxy being built into the tree. Kept next to each other so
+	//		splitting a range doesn't jump around memory
+	//*************************************************************************
+	struct BuildItem {
+		Aabb box;
+		glm::vec3 center;
+		int proxy;
+	};
+
+	int AllocateNode();
+	void FreeNode(int node);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	void RefitUpFrom(int node);
+	int BuildRange(BuildItem* items, int count, int parent);
+	int Height(int node);
+	Aabb Fatten(const Aabb& box);
+
+	// How much leaf boxes are grown by on every side, as a fraction of their size
+	float margin_;
+
+	// Tree nodes, with unused ones linked through their parent
+	std::vector<Node> nodes_;
+	int root_;
+	int freeNode_;
+
+	// Everything in the tree, with unused ones linked through nextFree
+	std::vector<Proxy> proxies_;
+	int freeProxy_;
+	int proxyCount_;
+
+	// Leaves that had to grow since the last build, for deciding when the tree is worth rebuilding
+	int refitCount_;
+
+	// Scratch for building
+	std::vector<BuildItem> buildItems_;
+
+	// Scratch for walking the tree, kept so queries don't allocate once it has grown
+	std::vector<int> stack_;
+
+};
@@ -43,6 +43,7 @@ Camera::Camera(glm::vec4 eye, glm::vec4 lookAt, float fov, float aspect, float n
 	eyePoint_(eye),
 	fov_(fov),
 	lookAtVec_(lookAt),
+	orientation_(),
 	rightVec_(),
 	upVec_(),
 	backVec_(),
@@ -63,6 +64,9 @@ Camera::Camera(glm::vec4 eye, glm::vec4 lookAt, float fov, float aspect, float n
 	// Calculate up vector
 	upVec_ = GfxMath::CrossProduct(backVec_, rightVec_);
 
+	// Keep the orientation as a quaternion, so turning the camera doesn't slowly skew the vectors
+	orientation_ = GfxMath::QuatFromMatrix(glm::mat3(glm::vec3(rightVec_), glm::vec3(upVec_), glm::vec3(backVec_)));
+
 	// Calculate the viewport distance (half-way between near and far)
 	viewportDist_ = nearDist_ + (farDist_ - nearDist_) / 2.0f;
 
@@ -109,13 +113,7 @@ void Camera::SideMove(float amount)
 //*****************************************************************************
 void Camera::Yaw(float angle)
 {
-	glm::mat4 rotation = GfxMath::Rotate3D(upVec_, angle);
-
-	rightVec_ = rotation * rightVec_;
-	upVec_ = rotation * upVec_;
-	backVec_ = rotation * backVec_;
-
-	SetDirtyFlags(true);
+	RotateAround(upVec_, angle);
 }
 
 //*****************************************************************************
@@ -128,13 +126,7 @@ void Camera::Yaw(float angle)
 //*****************************************************************************
 void Camera::Pitch(float angle)
 {
-	glm::mat4 rotation = GfxMath::Rotate3D(rightVec_, angle);
-
-	rightVec_ = rotation * rightVec_;
-	upVec_ = rotation * upVec_;
-	backVec_ = rotation * backVec_;
-
-	SetDirtyFlags(true);
+	RotateAround(rightVec_, angle);
 }
 
 //*****************************************************************************
@@ -147,13 +139,7 @@ void Camera::Pitch(float angle)
 //*****************************************************************************
 void Camera::Roll(float angle)
 {
-	glm::mat4 rotation = GfxMath::Rotate3D(backVec_, angle);
-
-	rightVec_ = rotation * rightVec_;
-	upVec_ = rotation * upVec_;
-	backVec_ = rotation * backVec_;
-
-	SetDirtyFlags(true);
+	RotateAround(backVec_, angle);
 }
 
 void Camera::SetAspect(float aspect)
@@ -234,6 +220,28 @@ void Camera::SetDirtyFlags(bool val)
 	perspIsDirty_ = val;
 }
 
+//*****************************************************************************
+//  Description:
+//		Rotates the camera's orientation and remakes the orientation vectors
+//		from it
+// 
+//	Param axis:
+//		The vector to rotate around
+// 
+//	Param angle:
+//		The angle in degrees to rotate the camera by
+//*****************************************************************************
+void Camera::RotateAround(const glm::vec4& axis, float angle)
+{
+	orientation_ = GfxMath::QuatNormalize(GfxMath::QuatFromAxisAngle(axis, angle) * orientation_);
+
+	rightVec_ = GfxMath::QuatRotate(orientation_, GfxMath::Vector(1, 0, 0));
+	upVec_ = GfxMath::QuatRotate(orientation_, GfxMath::Vector(0, 1, 0));
+	backVec_ = GfxMath::QuatRotate(orientation_, GfxMath::Vector(0, 0, 1));
+
+	SetDirtyFlags(true);
+}
+
 //*****************************************************************************
 //  Description:
 //		Calculates (if needed) and gets the camera to world matrix of the
@@ -45,6 +45,9 @@ private:
 	// Private function for setting dirty flag
 	void SetDirtyFlags(bool val);
 
+	// Private function for turning the camera around one of its own vectors
+	void RotateAround(const glm::vec4& axis, float angle);
+
 	// Matrices from camera
 	glm::mat4 camToWorldMat_;
 	glm::mat4 viewMat_;
@@ -64,7 +67,8 @@ private:
 	// Look At Vector for the Camera
 	glm::vec4 lookAtVec_;
 
-	// Orientation vectors for the camera
+	// Orientation of the camera, and the orientation vectors made from it
+	GfxMath::Quat orientation_;
 	glm::vec4 rightVec_;
 	glm::vec4 upVec_;
 	glm::vec4 backVec_;
@@ -25,17 +25,24 @@ static const glm::vec4 xDir = GfxMath::Point(1, 0, 0);
 static const glm::vec4 yDir = GfxMath::Point(0, 1, 0);
 static const glm::vec4 zDir = GfxMath::Point(0, 0, 1);
 
-CameraSystem::CameraSystem() : System(SysType::CameraSys),
+CameraSystem::CameraSystem() : System(Type),
 	prevMousePos_(GfxMath::Point(0, 0)),
 	currMousePos_(GfxMath::Point(0, 0)),
 	oMesh_(nullptr),
 	cameras_(),
-	activeCam_(nullptr)
+	activeCam_(nullptr),
+	inputSys_(nullptr)
 {
+	// Moving the camera only reads input and touches cameras, so it can run off of the main thread.
+	// Everything else that draws culls against the camera, so its debug drawing is queued alone
+	RunsAfter(InputSys);
+	SetMainThreadOnly(false);
 }
 
 void CameraSystem::Initialize()
 {
+	inputSys_ = GetParent()->Get<InputSystem>();
+
 	// Create an initial camera and add it to the camera map
 	Camera* startCam = new Camera(GfxMath::Point(0, 0, -10), GfxMath::Vector(0, 0, 1), 90.0f, 16.0f / 9.0f, 1.0f, 100.0f);
 	std::pair<unsigned int, Camera*> camToAdd(1, startCam);
@@ -53,40 +60,39 @@ void CameraSystem::Update(float dt)
 	}
 
 	// Handle any input for the current camera here
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(GetParent()->GetSystem(SysType::InputSys));
-	if (inputSys)
+	if (inputSys_)
 	{
-		// Basic movement of the camera's position
-		if (inputSys->KeyIsDown(SDLK_d))
+		// Basic movement of the camera's position, by where the keys are so it works on any layout
+		if (inputSys_->KeyIsDown(SDL_SCANCODE_D))
 			activeCam_->SideMove(moveAmount*dt);
-		else if (inputSys->KeyIsDown(SDLK_a))
+		else if (inputSys_->KeyIsDown(SDL_SCANCODE_A))
 			activeCam_->SideMove(-moveAmount*dt);
 
-		if (inputSys->KeyIsDown(SDLK_w))
+		if (inputSys_->KeyIsDown(SDL_SCANCODE_W))
 			activeCam_->ForwardMove(moveAmount*dt);
-		else if (inputSys->KeyIsDown(SDLK_s))
+		else if (inputSys_->KeyIsDown(SDL_SCANCODE_S))
 			activeCam_->ForwardMove(-moveAmount*dt);
 
 		// Orientation of the camera
-		if (inputSys->KeyIsDown(SDLK_LEFT))
+		if (inputSys_->KeyIsDown(SDL_SCANCODE_LEFT))
 			activeCam_->Roll(rotAngle * dt);
-		else if (inputSys->KeyIsDown(SDLK_RIGHT))
+		else if (inputSys_->KeyIsDown(SDL_SCANCODE_RIGHT))
 			activeCam_->Roll(-rotAngle * dt);
 
 		// Zoom of the camera
-		if (inputSys->KeyIsDown(SDLK_UP))
+		if (inputSys_->KeyIsDown(SDL_SCANCODE_UP))
 			activeCam_->Zoom(rotAngle * dt);
-		else if (inputSys->KeyIsDown(SDLK_DOWN))
+		else if (inputSys_->KeyIsDown(SDL_SCANCODE_DOWN))
 			activeCam_->Zoom(rotAngle * -dt);
 
 		// Mouse input for orientation of the camera
-		if (inputSys->RMIsTriggered())
-			inputSys->GetMouseScreenPos(&currMousePos_.x, &currMousePos_.y);
-		else if (inputSys->RMIsDown())
+		if (inputSys_->RMIsTriggered())
+			inputSys_->GetMouseScreenPos(&currMousePos_.x, &currMousePos_.y);
+		else if (inputSys_->RMIsDown())
 		{
 			// Update mouse position stuff
 			prevMousePos_ = currMousePos_;
-			inputSys->GetMouseScreenPos(&currMousePos_.x, &currMousePos_.y);
+			inputSys_->GetMouseScreenPos(&currMousePos_.x, &currMousePos_.y);
 
 			glm::vec4 mouseDist = GfxMath::Vector(currMousePos_.x - prevMousePos_.x, currMousePos_.y - prevMousePos_.y);
 
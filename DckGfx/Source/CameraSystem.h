@@ -12,9 +12,13 @@
 #include "MeshLib.h"
 #include <map>
 
+class InputSystem;
+
 class CameraSystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::CameraSys;
+
 	CameraSystem();
 
 	void Initialize() override;
@@ -42,4 +46,7 @@ private:
 	// Pointer to the current active camera
 	Camera* activeCam_;
 
+	// Systems this one uses, looked up once in Initialize
+	InputSystem* inputSys_;
+
 };
\ No newline at end of file
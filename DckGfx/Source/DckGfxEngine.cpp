@@ -14,6 +14,8 @@
 #include "SceneSystem.h"
 #include "ShaderLib.h"
 #include "MeshLib.h"
+#include "AssetLoader.h"
+#include "Profiler.h"
 #include <iostream>
 #include <stdexcept>
 
@@ -24,15 +26,47 @@ static Engine* theEngine;
 //  Description:
 //		Initializes the engine, allocating memory to the engine
 //		and initializing the engine. Throws exception if error occurs
+// 
+//	Param config:
+//		Options for the engine, such as drawing on a render thread or running
+//		headless
 //*****************************************************************************
-void DckEInitialize()
+void DckEInitialize(const EngineConfig& config)
 {
-	theEngine = new Engine();
+#ifdef DCK_PROFILE
+	// Started first so initialization shows up in the trace too
+	ProfilerInit();
+#endif
+	DCK_PROFILE_THREAD("Main Thread");
+	DCK_PROFILE_ZONE("Engine Initialize");
+
+	theEngine = new Engine(config);
 	if (theEngine)
 	{
-		theEngine->Initialize();
-		ShaderLibraryInit();
-		MeshLibraryInit();
+		{
+			DCK_PROFILE_ZONE("Systems Init");
+			theEngine->Initialize();
+		}
+		{
+			DCK_PROFILE_ZONE("Asset Loader Init");
+			AssetLoaderInit(theEngine->GetJobSystem());
+		}
+		{
+			DCK_PROFILE_ZONE("Shader Library Init");
+			ShaderLibraryInit();
+		}
+		{
+			DCK_PROFILE_ZONE("Mesh Library Init");
+			MeshLibraryInit(theEngine->GetJobSystem());
+		}
+
+		// The base meshes and shaders are loaded, so the context can go to the render thread.
+		// Anything loaded after this gets uploaded over there
+		if (config.renderThread)
+		{
+			MeshLibraryDeferUploads(true);
+			theEngine->StartRenderThread();
+		}
 	}
 	else
 	{
@@ -63,11 +97,20 @@ void DckEShutdown()
 {
 	if (theEngine)
 	{
+		// Take the context back from the render thread, then stop loading before the
+		// meshes being loaded into get deleted
+		theEngine->StopRenderThread();
+		AssetLoaderShutdown();
 		MeshLibraryShutdown();
 		ShaderLibraryShutdown();
 		theEngine->Shutdown();
 		delete theEngine;
 	}
+
+#ifdef DCK_PROFILE
+	// Every thread that profiled has stopped by now
+	ProfilerShutdown();
+#endif
 }
 
 //*****************************************************************************
@@ -83,6 +126,22 @@ bool DckEIsRunning()
 		return theEngine->IsRunning();
 }
 
+//*****************************************************************************
+//  Description:
+//		Gets the stats of the last frame that was drawn, including how long
+//		each pass took on the GPU
+//
+//	Return:
+//		Returns the render stats, all zero if the engine isn't running
+//*****************************************************************************
+RenderSystem::RenderStats DckEGetStats()
+{
+	RenderSystem* renderSys = theEngine ? theEngine->Get<RenderSystem>() : nullptr;
+	if (renderSys)
+		return renderSys->GetStats();
+	return RenderSystem::RenderStats();
+}
+
 //*****************************************************************************
 //  Description:
 //		Renders a mesh with given parameters
@@ -103,6 +162,19 @@ void DckERender(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 		theEngine->Render(mesh, type, modelMat, tint, diff, spec, sExp);
 }
 
+//*****************************************************************************
+//  Description:
+//		Renders a mesh with a normal matrix that was already made, so it
+//		doesn't have to be made from the model matrix again. Culling can be
+//		skipped for meshes that are already known to be visible
+//*****************************************************************************
+void DckERender(DckMesh* mesh, RenderType type, const glm::mat4& modelMat, const glm::mat4& normalMat,
+				glm::vec3 tint, glm::vec3 diff, glm::vec3 spec, float sExp, bool cull)
+{
+	if (theEngine)
+		theEngine->Render(mesh, type, modelMat, normalMat, tint, diff, spec, sExp, cull);
+}
+
 //*****************************************************************************
 //  Description:
 //		Checks if the given key is in the triggered state
@@ -115,7 +187,7 @@ void DckERender(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 //*****************************************************************************
 bool DckEKeyIsTriggered(SDL_Keycode key)
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->KeyIsTriggered(key);
 	return false;
@@ -133,7 +205,7 @@ bool DckEKeyIsTriggered(SDL_Keycode key)
 //*****************************************************************************
 bool DckEKeyIsDown(SDL_Keycode key)
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->KeyIsDown(key);
 	return false;
@@ -151,7 +223,61 @@ bool DckEKeyIsDown(SDL_Keycode key)
 //*****************************************************************************
 bool DckEKeyIsReleased(SDL_Keycode key)
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
+	if (inputSys)
+		return inputSys->KeyIsReleased(key);
+	return false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if the given key is in the triggered state
+//	
+//	Param key:
+//		Scancode of the key to check the triggered state of
+// 
+//	Return:
+//		Returns true if the key is triggered, false otherwise
+//*****************************************************************************
+bool DckEKeyIsTriggered(SDL_Scancode key)
+{
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
+	if (inputSys)
+		return inputSys->KeyIsTriggered(key);
+	return false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if the given key is in the down state or not
+//	
+//	Param key:
+//		Scancode of the key to check the down state of
+// 
+//	Return:
+//		Returns true if the key is triggered, false otherwise
+//*****************************************************************************
+bool DckEKeyIsDown(SDL_Scancode key)
+{
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
+	if (inputSys)
+		return inputSys->KeyIsDown(key);
+	return false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if the given key is in the released state or not
+//	
+//	Param key:
+//		Scancode of the key to check the released state of
+// 
+//	Return:
+//		Returns true if the key is released, false otherwise
+//*****************************************************************************
+bool DckEKeyIsReleased(SDL_Scancode key)
+{
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->KeyIsReleased(key);
 	return false;
@@ -166,7 +292,7 @@ bool DckEKeyIsReleased(SDL_Keycode key)
 //*****************************************************************************
 bool DckELeftMouseIsTriggered()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->LMIsTriggered();
 	return false;
@@ -181,7 +307,7 @@ bool DckELeftMouseIsTriggered()
 //*****************************************************************************
 bool DckELeftMouseIsDown()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->LMIsDown();
 	return false;
@@ -196,7 +322,7 @@ bool DckELeftMouseIsDown()
 //*****************************************************************************
 bool DckELeftMouseIsReleased()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->LMIsReleased();
 	return false;
@@ -211,7 +337,7 @@ bool DckELeftMouseIsReleased()
 //*****************************************************************************
 bool DckERightMouseIsTriggered()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->RMIsTriggered();
 	return false;
@@ -226,7 +352,7 @@ bool DckERightMouseIsTriggered()
 //*****************************************************************************
 bool DckERightMouseIsDown()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->RMIsDown();
 	return false;
@@ -241,7 +367,7 @@ bool DckERightMouseIsDown()
 //*****************************************************************************
 bool DckERightMouseIsReleased()
 {
-	InputSystem* inputSys = dynamic_cast<InputSystem*>(theEngine->GetSystem(System::SysType::InputSys));
+	InputSystem* inputSys = theEngine->Get<InputSystem>();
 	if (inputSys)
 		return inputSys->RMIsReleased();
 	return false;
@@ -256,7 +382,7 @@ bool DckERightMouseIsReleased()
 //*****************************************************************************
 void DckESetBackColor(glm::vec3 newColor)
 {
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(theEngine->GetSystem(System::SysType::GraphicsSys));
+	GraphicsSystem* graphics = theEngine->Get<GraphicsSystem>();
 	if (graphics)
 		graphics->SetBackColor(newColor);
 }
@@ -271,7 +397,7 @@ void DckESetBackColor(glm::vec3 newColor)
 //*****************************************************************************
 glm::vec3 DckEGetBackColor()
 {
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(theEngine->GetSystem(System::SysType::GraphicsSys));
+	GraphicsSystem* graphics = theEngine->Get<GraphicsSystem>();
 	if (graphics)
 		return graphics->GetBackColor();
 	return glm::vec3(0);
@@ -286,29 +412,45 @@ glm::vec3 DckEGetBackColor()
 //*****************************************************************************
 void DckESetNextScene(SceneID nextScene)
 {
-	SceneSystem* sceneSys = dynamic_cast<SceneSystem*>(theEngine->GetSystem(System::SysType::SceneSys));
+	SceneSystem* sceneSys = theEngine->Get<SceneSystem>();
 	if (sceneSys)
 		sceneSys->SetNextScene(nextScene);
 }
 
 void DckEAddLight(glm::vec4 pos, glm::vec3 color)
 {
-	LightingSystem* lightSys = dynamic_cast<LightingSystem*>(theEngine->GetSystem(System::SysType::LightingSys));
+	LightingSystem* lightSys = theEngine->Get<LightingSystem>();
 	if (lightSys)
 		lightSys->AddLight(pos, color);
 }
 
-void DckEObjectManagerAdd(RenderObject* object)
+ObjectHandle DckEObjectManagerAdd(RenderObject* object)
 {
-	ObjectManagerSystem* objManSys = dynamic_cast<ObjectManagerSystem*>(theEngine->GetSystem(System::SysType::ObjectManagerSys));
+	ObjectManagerSystem* objManSys = theEngine->Get<ObjectManagerSystem>();
 	if (objManSys)
-		objManSys->AddObject(object);
+		return objManSys->AddObject(object);
+	return ObjectHandle();
 }
 
 RenderObject* DckEObjectManagerGet(std::string name)
 {
-	ObjectManagerSystem* objManSys = dynamic_cast<ObjectManagerSystem*>(theEngine->GetSystem(System::SysType::ObjectManagerSys));
+	ObjectManagerSystem* objManSys = theEngine->Get<ObjectManagerSystem>();
 	if (objManSys)
 		return objManSys->GetObject(name);
 	return nullptr;
 }
+
+RenderObject* DckEObjectManagerGet(ObjectHandle handle)
+{
+	ObjectManagerSystem* objManSys = theEngine->Get<ObjectManagerSystem>();
+	if (objManSys)
+		return objManSys->GetObject(handle);
+	return nullptr;
+}
+
+void DckEObjectManagerRemove(ObjectHandle handle)
+{
+	ObjectManagerSystem* objManSys = theEngine->Get<ObjectManagerSystem>();
+	if (objManSys)
+		objManSys->RemoveObject(handle);
+}
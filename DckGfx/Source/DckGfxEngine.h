@@ -13,20 +13,30 @@
 #include "GfxMath.h"
 #include "SceneList.h"
 #include "RenderObject.h"
+#include "RenderSystem.h"
+#include "ObjectManagerSystem.h"
 
-void DckEInitialize();
+void DckEInitialize(const EngineConfig& config = EngineConfig());
 void DckEUpdate(float dt);
 void DckEShutdown();
 
 bool DckEIsRunning();
 
+RenderSystem::RenderStats DckEGetStats();
+
 void DckERender(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 				glm::vec3 tint = glm::vec3(0), glm::vec3 diff = glm::vec3(0), glm::vec3 spec = glm::vec3(0), float sExp = 0.0f);
+void DckERender(DckMesh* mesh, RenderType type, const glm::mat4& modelMat, const glm::mat4& normalMat,
+				glm::vec3 tint, glm::vec3 diff, glm::vec3 spec, float sExp, bool cull = true);
 
 bool DckEKeyIsTriggered(SDL_Keycode key);
 bool DckEKeyIsDown(SDL_Keycode key);
 bool DckEKeyIsReleased(SDL_Keycode key);
 
+bool DckEKeyIsTriggered(SDL_Scancode key);
+bool DckEKeyIsDown(SDL_Scancode key);
+bool DckEKeyIsReleased(SDL_Scancode key);
+
 bool DckELeftMouseIsTriggered();
 bool DckELeftMouseIsDown();
 bool DckELeftMouseIsReleased();
@@ -42,5 +52,7 @@ void DckESetNextScene(SceneID nextScene);
 
 void DckEAddLight(glm::vec4 pos, glm::vec3 color);
 
-void DckEObjectManagerAdd(RenderObject* object);
+ObjectHandle DckEObjectManagerAdd(RenderObject* object);
 RenderObject* DckEObjectManagerGet(std::string name);
+RenderObject* DckEObjectManagerGet(ObjectHandle handle);
+void DckEObjectManagerRemove(ObjectHandle handle);
@@ -16,35 +16,75 @@
 #include "LightingSystem.h"
 #include "RenderSystem.h"
 #include "ImGUISystem.h"
+#include "Profiler.h"
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef DCK_PROFILE
+// Profiler zone names for each system, in SysType order
+static const char* const updateZoneNames[System::SystemCount] = {
+	"Window Update",
+	"Input Update",
+	"Camera Update",
+	"Graphics Update",
+	"Object Manager Update",
+	"Lighting Update",
+	"Render Update",
+	"ImGui Update",
+	"Scene Update"
+};
+
+static const char* const submitZoneNames[System::SystemCount] = {
+	"Window Submit",
+	"Input Submit",
+	"Camera Submit",
+	"Graphics Submit",
+	"Object Manager Submit",
+	"Lighting Submit",
+	"Render Submit",
+	"ImGui Submit",
+	"Scene Submit"
+};
+#endif
 
 //*****************************************************************************
 //  Description:
 //		Constructor for the engine class, which created and adds any necessary
 //		Systems
+// 
+//	Param config:
+//		Options for the engine. Headless engines have no input or ImGui
 //*****************************************************************************
-Engine::Engine() : systems_{nullptr}, isRunning_(false)
+Engine::Engine(const EngineConfig& config) : systems_{nullptr}, isRunning_(false), config_(config), jobSystem_(), updateOrder_{0},
+	updateCount_(0), addedSystems_(0), finishedSystems_(0), packets_(), recordPacket_(0), submitPacket_(0), renderThread_(), packetMutex_(),
+	packetReady_(), packetDone_(), packetPending_(false), stopRendering_(false), frameNumber_(0), lastFrameTicks_(0),
+	frameTimes_(), gpuPassTimes_()
 {
 	// Create the new systems
 	System* windowSys = new WindowSystem();
-	System* inputSys = new InputSystem();
 	System* camSys = new CameraSystem();
 	System* sceneSys = new SceneSystem();
 	System* graphicSys = new GraphicsSystem();
 	System* objManSys = new ObjectManagerSystem();
 	System* lightSys = new LightingSystem();
 	System* renderSys = new RenderSystem();
-	System* imGuiSys = new ImGUISystem();
 
 	// Add the systems to the engine
 	AddSystem(windowSys);
-	AddSystem(inputSys);
 	AddSystem(camSys);
 	AddSystem(sceneSys);
 	AddSystem(graphicSys);
 	AddSystem(objManSys);
 	AddSystem(lightSys);
 	AddSystem(renderSys);
-	AddSystem(imGuiSys);
+
+	// Nothing to take input from or show ImGui on without a display, but replayed input
+	// doesn't need one
+	if (!config_.headless || config_.replayInputPath)
+		AddSystem(new InputSystem());
+	if (!config_.headless)
+		AddSystem(new ImGUISystem());
 }
 
 //*****************************************************************************
@@ -54,28 +94,104 @@ Engine::Engine() : systems_{nullptr}, isRunning_(false)
 //*****************************************************************************
 void Engine::Initialize()
 {
+	jobSystem_.Initialize();
+
 	for (System* sys : systems_)
 	{
 		if (sys)
 			sys->Initialize();
 	}
+
+	BuildUpdateOrder();
 	isRunning_ = true;
+	lastFrameTicks_ = SDL_GetPerformanceCounter();
 }
 
 //*****************************************************************************
 //  Description:
-//		Updates all the systems in the engine
+//		Updates all the systems in the engine. A system starts as soon as its
+//		dependencies are done. Main thread systems run right here, the rest
+//		are handed to the job system, and the main thread helps run jobs
+//		while it waits on them
 // 
 //	Param dt:
-//		Delta time, used for updating the components relative to the framerate
+//		Delta time, used for updating the components relative to the framerate.
+//		Replays use the dt each frame was recorded with instead, and a fixed
+//		dt in the config overrides both
 //*****************************************************************************
 void Engine::Update(float dt)
 {
-	for (System* sys : systems_)
+	DCK_PROFILE_FRAME();
+	DCK_PROFILE_ZONE("Engine Update");
+
+	InputSystem* inputSys = Get<InputSystem>();
+	if (inputSys)
+		dt = inputSys->BeginFrame(dt);
+	if (config_.fixedDt > 0.0f)
+		dt = config_.fixedDt;
+
+	finishedSystems_ = 0;
+	unsigned int started = 0;
+	JobCounter running(0);
+
+	while (finishedSystems_ != addedSystems_)
 	{
-		if (sys)
-			sys->Update(dt);
+		// Start the first system in the order that is ready to go
+		bool startedAny = false;
+		for (int i = 0; i < updateCount_; ++i)
+		{
+			int type = updateOrder_[i];
+			unsigned int bit = 1u << type;
+			System* sys = systems_[type];
+			if ((started & bit) || (sys->GetDependencies() & addedSystems_ & ~finishedSystems_) != 0)
+				continue;
+
+			started |= bit;
+			startedAny = true;
+			if (sys->IsMainThreadOnly())
+				UpdateSystem(type, dt);
+			else
+			{
+				// Captures little enough that std::function keeps it inline instead of allocating
+				jobSystem_.Run([this, type, dt]() { UpdateSystem(type, dt); }, &running);
+			}
+			break;
+		}
+
+		// Nothing can start until something else finishes, so help with jobs in the meantime
+		if (!startedAny && !jobSystem_.RunPendingJob())
+			std::this_thread::yield();
+	}
+
+	// The jobs still touch the counter right after finishing
+	jobSystem_.Wait(&running);
+
+	// Without a render thread the frame just gets drawn now
+	if (!renderThread_.joinable())
+	{
+		SubmitFrame(packets_[recordPacket_]);
+		packets_[recordPacket_].Reset();
+	}
+	else
+	{
+		// Wait for the render thread to finish the last frame, then hand this one over and record into the other
+		{
+			DCK_PROFILE_ZONE("Wait For Render Thread");
+			std::unique_lock<std::mutex> lock(packetMutex_);
+			packetDone_.wait(lock, [this]() { return !packetPending_; });
+			submitPacket_ = recordPacket_;
+			recordPacket_ = 1 - recordPacket_;
+			packetPending_ = true;
+		}
+		packetReady_.notify_one();
 	}
+
+	RecordFrameStats();
+
+	// Runs with a set frame count stop on their own
+	++frameNumber_;
+	if (config_.frameCount > 0 && frameNumber_ >= config_.frameCount)
+		isRunning_ = false;
 }
 
 //*****************************************************************************
@@ -84,11 +200,77 @@ void Engine::Update(float dt)
 //*****************************************************************************
 void Engine::Shutdown()
 {
+	StopRenderThread();
+	WriteFrameStats();
+
 	for (int i = System::SysType::SystemCount - 1; i >= 0; --i)
 	{
 		if (systems_[i])
 			systems_[i]->Shutdown();
 	}
+
+	jobSystem_.Shutdown();
+}
+
+//*****************************************************************************
+//  Description:
+//		Moves drawing onto its own thread, which takes the GL context from the
+//		main thread. From then on the main thread records frame N+1 while the
+//		render thread draws frame N. Nothing on the main thread can call
+//		OpenGL after this, so it should be started once everything that needs
+//		the context up front has loaded
+//*****************************************************************************
+void Engine::StartRenderThread()
+{
+	WindowSystem* windowSys = Get<WindowSystem>();
+	if (renderThread_.joinable() || !windowSys)
+		return;
+
+	windowSys->ReleaseContext();
+	stopRendering_ = false;
+	packetPending_ = false;
+	renderThread_ = std::thread(&Engine::RenderLoop, this);
+}
+
+//*****************************************************************************
+//  Description:
+//		Draws whatever frame is still pending, stops the render thread, and
+//		gives the GL context back to the main thread
+//*****************************************************************************
+void Engine::StopRenderThread()
+{
+	if (!renderThread_.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(packetMutex_);
+		stopRendering_ = true;
+	}
+	packetReady_.notify_one();
+	renderThread_.join();
+
+	WindowSystem* windowSys = Get<WindowSystem>();
+	if (windowSys)
+		windowSys->MakeContextCurrent();
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if frames are being drawn on a render thread
+//*****************************************************************************
+bool Engine::IsRenderThreaded()
+{
+	return renderThread_.joinable();
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the packet the current frame is being recorded into. Only valid
+//		during an update, from the systems updating
+//*****************************************************************************
+FramePacket* Engine::GetFramePacket()
+{
+	return &packets_[recordPacket_];
 }
 
 //*****************************************************************************
@@ -122,6 +304,25 @@ void Engine::AddSystem(System* newSys)
 	}
 }
 
+//*****************************************************************************
+//  Description:
+//		Gets the job system, for systems that want to split their work up
+//		across threads
+//*****************************************************************************
+JobSystem* Engine::GetJobSystem()
+{
+	return &jobSystem_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the options the engine was created with
+//*****************************************************************************
+const EngineConfig& Engine::GetConfig()
+{
+	return config_;
+}
+
 //*****************************************************************************
 //  Description:
 //		Gets the current state of whether or not the engine is running
@@ -162,11 +363,23 @@ void Engine::SetIsRunning(bool running)
 void Engine::Render(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 					glm::vec3 tint, glm::vec3 diff, glm::vec3 spec, float sExp)
 {
-	RenderSystem* renderSys = dynamic_cast<RenderSystem*>(systems_[System::SysType::RenderSys]);
+	RenderSystem* renderSys = Get<RenderSystem>();
 	if (renderSys)
 		renderSys->Render(mesh, type, modelMat, tint, diff, spec, sExp);
 }
 
+//*****************************************************************************
+//  Description:
+//		Renders a given mesh with a normal matrix that was already made
+//*****************************************************************************
+void Engine::Render(DckMesh* mesh, RenderType type, const glm::mat4& modelMat, const glm::mat4& normalMat,
+					glm::vec3 tint, glm::vec3 diff, glm::vec3 spec, float sExp, bool cull)
+{
+	RenderSystem* renderSys = Get<RenderSystem>();
+	if (renderSys)
+		renderSys->Render(mesh, type, modelMat, normalMat, tint, diff, spec, sExp, cull);
+}
+
 //*****************************************************************************
 //  Description:
 //		Renders a given mesh with certain parameters as debug (will always be
@@ -183,11 +396,175 @@ void Engine::Render(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 //*****************************************************************************
 void Engine::DebugRender(DckMesh* mesh, RenderType type, glm::mat4 modelMat)
 {
-	RenderSystem* renderSys = dynamic_cast<RenderSystem*>(systems_[System::SysType::RenderSys]);
+	RenderSystem* renderSys = Get<RenderSystem>();
 	if (renderSys)
 		renderSys->RenderDebug(mesh, type, modelMat);
 }
 
+//*****************************************************************************
+//  Description:
+//		Sorts the systems so every system comes after the ones it depends on.
+//		Ties go to the lower system type, so systems without dependencies
+//		between them keep the order they are declared in. Dependencies on
+//		systems that were never added are ignored
+//*****************************************************************************
+void Engine::BuildUpdateOrder()
+{
+	addedSystems_ = 0;
+	for (int i = 0; i < System::SysType::SystemCount; ++i)
+	{
+		if (systems_[i])
+			addedSystems_ |= 1u << i;
+	}
+
+	unsigned int ordered = 0;
+	updateCount_ = 0;
+	while (ordered != addedSystems_)
+	{
+		int next = -1;
+		for (int i = 0; i < System::SysType::SystemCount && next < 0; ++i)
+		{
+			unsigned int bit = 1u << i;
+			if ((addedSystems_ & bit) && !(ordered & bit) &&
+				(systems_[i]->GetDependencies() & addedSystems_ & ~ordered) == 0)
+				next = i;
+		}
+
+		if (next < 0)
+		{
+			std::cout << "System dependencies have a cycle" << std::endl;
+			throw std::runtime_error("System dependencies have a cycle");
+		}
+
+		updateOrder_[updateCount_++] = next;
+		ordered |= 1u << next;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Updates one system and marks it as finished for the frame, on
+//		whichever thread it was started on
+//*****************************************************************************
+void Engine::UpdateSystem(int type, float dt)
+{
+	DCK_PROFILE_ZONE(updateZoneNames[type]);
+	systems_[type]->Update(dt);
+	finishedSystems_ |= 1u << type;
+}
+
+//*****************************************************************************
+//  Description:
+//		Has every system submit its part of a frame to OpenGL, in update order
+//
+//	Param packet:
+//		The recorded frame
+//*****************************************************************************
+void Engine::SubmitFrame(FramePacket& packet)
+{
+	DCK_PROFILE_ZONE("Submit Frame");
+	for (int i = 0; i < updateCount_; ++i)
+	{
+		DCK_PROFILE_ZONE(submitZoneNames[updateOrder_[i]]);
+		systems_[updateOrder_[i]]->Submit(packet);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Render thread loop. Draws each packet as it is handed over, and empties
+//		it for the main thread to record into again
+//*****************************************************************************
+void Engine::RenderLoop()
+{
+	DCK_PROFILE_THREAD("Render Thread");
+	WindowSystem* windowSys = Get<WindowSystem>();
+	windowSys->MakeContextCurrent();
+
+	while (true)
+	{
+		int packet = 0;
+		{
+			std::unique_lock<std::mutex> lock(packetMutex_);
+			packetReady_.wait(lock, [this]() { return packetPending_ || stopRendering_; });
+			if (!packetPending_)
+				break;
+			packet = submitPacket_;
+		}
+
+		SubmitFrame(packets_[packet]);
+		packets_[packet].Reset();
+
+		{
+			std::lock_guard<std::mutex> lock(packetMutex_);
+			packetPending_ = false;
+		}
+		packetDone_.notify_one();
+	}
+
+	windowSys->ReleaseContext();
+}
+
+//*****************************************************************************
+//  Description:
+//		Keeps how long the frame took, measured from the end of the last one,
+//		and the newest GPU pass times. Only kept when there is a stats file to
+//		write them to, and not for the warmup frames
+//*****************************************************************************
+void Engine::RecordFrameStats()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	float frameMs = static_cast<float>((now - lastFrameTicks_) * 1000.0 / SDL_GetPerformanceFrequency());
+	lastFrameTicks_ = now;
+
+	if (!config_.statsPath || frameNumber_ < config_.warmupFrames)
+		return;
+
+	frameTimes_.Add(frameMs);
+	RenderSystem* renderSys = Get<RenderSystem>();
+	if (renderSys)
+	{
+		RenderSystem::RenderStats stats = renderSys->GetStats();
+		for (int pass = 0; pass < RenderSystem::PassCount; ++pass)
+			gpuPassTimes_[pass].Add(stats.gpuPassMs[pass]);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes the frame and GPU pass time stats as JSON to the stats path
+//		from the config, if there is one
+//*****************************************************************************
+void Engine::WriteFrameStats()
+{
+	if (!config_.statsPath)
+		return;
+
+	std::ofstream statsFile(config_.statsPath, std::ios::trunc);
+	if (!statsFile.is_open())
+	{
+		std::cout << "Failed to write frame stats: " << config_.statsPath << std::endl;
+		return;
+	}
+
+	statsFile << "{\n";
+	statsFile << "\t\"frames\": " << frameNumber_ << ",\n";
+	statsFile << "\t\"warmupFrames\": " << config_.warmupFrames << ",\n";
+	statsFile << "\t\"headless\": " << (config_.headless ? "true" : "false") << ",\n";
+	statsFile << "\t\"renderThread\": " << (config_.renderThread ? "true" : "false") << ",\n";
+	statsFile << "\t\"width\": " << config_.width << ",\n";
+	statsFile << "\t\"height\": " << config_.height << ",\n";
+	statsFile << "\t\"frameMs\": ";
+	frameTimes_.WriteJson(statsFile);
+	statsFile << ",\n\t\"gpuMainMs\": ";
+	gpuPassTimes_[RenderSystem::MainPass].WriteJson(statsFile);
+	statsFile << ",\n\t\"gpuDebugMs\": ";
+	gpuPassTimes_[RenderSystem::DebugPass].WriteJson(statsFile);
+	statsFile << ",\n\t\"gpuImGuiMs\": ";
+	gpuPassTimes_[RenderSystem::ImGuiPass].WriteJson(statsFile);
+	statsFile << "\n}\n";
+}
+
 //*****************************************************************************
 //  Description:
 //		Destructor for the engine, deallocating any data allocated to systems
@@ -9,6 +9,15 @@
 
 #include "System.h"
 #include "MeshLib.h"
+#include "JobSystem.h"
+#include "FramePacket.h"
+#include "EngineConfig.h"
+#include "FrameStats.h"
+#include "SDL2/SDL.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 //*****************************************************************************
 //  Description:
@@ -18,20 +27,34 @@
 class Engine {
 public:
 
-	Engine();
+	Engine(const EngineConfig& config = EngineConfig());
 
 	void Initialize();
 	void Update(float dt);
 	void Shutdown();
 
+	void StartRenderThread();
+	void StopRenderThread();
+	bool IsRenderThreaded();
+
+	FramePacket* GetFramePacket();
+
 	System* GetSystem(System::SysType sysType);
 	void AddSystem(System* newSys);
 
+	template <typename T>
+	T* Get();
+
+	JobSystem* GetJobSystem();
+	const EngineConfig& GetConfig();
+
 	bool IsRunning();
 	void SetIsRunning(bool running);
 
 	void Render(DckMesh* mesh, RenderType type, glm::mat4 modelMat,
 			    glm::vec3 tint = glm::vec3(0), glm::vec3 diff = glm::vec3(0), glm::vec3 spec = glm::vec3(0), float sExp = 0.0f);
+	void Render(DckMesh* mesh, RenderType type, const glm::mat4& modelMat, const glm::mat4& normalMat,
+			    glm::vec3 tint, glm::vec3 diff, glm::vec3 spec, float sExp, bool cull = true);
 
 	void DebugRender(DckMesh* mesh, RenderType type, glm::mat4 modelMat);
 
@@ -39,7 +62,60 @@ public:
 
 private:
 
+	void BuildUpdateOrder();
+	void UpdateSystem(int type, float dt);
+	void SubmitFrame(FramePacket& packet);
+	void RenderLoop();
+	void RecordFrameStats();
+	void WriteFrameStats();
+
 	System* systems_[System::SysType::SystemCount]; // The container of systems
 	bool isRunning_;                                // Whether or not the engine is running
+	EngineConfig config_;                           // Options the engine was created with
+
+	// Threads that systems and their jobs run on
+	JobSystem jobSystem_;
+
+	// Systems sorted so each comes after its dependencies, and a bit for each system that was added
+	int updateOrder_[System::SysType::SystemCount];
+	int updateCount_;
+	unsigned int addedSystems_;
+
+	// A bit for each system that has finished updating this frame
+	std::atomic<unsigned int> finishedSystems_;
 
-};
\ No newline at end of file
+	// Frames being recorded and drawn. Without a render thread only the first one is used
+	FramePacket packets_[2];
+	int recordPacket_;
+	int submitPacket_;
+
+	// Render thread, which owns the GL context while it is running. A packet is pending from
+	// when the main thread hands it over until the render thread has drawn it
+	std::thread renderThread_;
+	std::mutex packetMutex_;
+	std::condition_variable packetReady_;
+	std::condition_variable packetDone_;
+	bool packetPending_;
+	bool stopRendering_;
+
+	// Frame count, and frame and GPU pass times kept for the stats file
+	int frameNumber_;
+	Uint64 lastFrameTicks_;
+	FrameStats frameTimes_;
+	FrameStats gpuPassTimes_[RenderSystem::PassCount];
+
+};
+
+//*****************************************************************************
+//  Description:
+//		Gets a system from the engine by its type. Each system type only ever
+//		goes in its own slot, so no runtime type check is needed
+//
+//	Return:
+//		Returns a pointer to the system, or nullptr if it was never added
+//*****************************************************************************
+template <typename T>
+T* Engine::Get()
+{
+	return static_cast<T*>(systems_[T::Type]);
+}
\ No newline at end of file
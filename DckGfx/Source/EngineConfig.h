@@ -0,0 +1,55 @@
+#pragma once
+//*****************************************************************************
+//	File:   EngineConfig.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Options the engine is created with, for things that have to
+//		be decided before the systems start up
+//*****************************************************************************
+
+struct EngineConfig {
+
+	// Draw on a render thread, so the next frame updates while the last one is drawn
+	bool renderThread;
+
+	// Draw into an offscreen framebuffer behind a hidden window, without input or ImGui,
+	// so the engine can run on machines without a display
+	bool headless;
+
+	// Size of the window, or of the offscreen framebuffer when headless
+	int width;
+	int height;
+
+	// Stop running after this many frames, 0 runs until the window is closed
+	int frameCount;
+
+	// Frames at the start that are left out of the frame stats, while everything warms up
+	int warmupFrames;
+
+	// Where frame time stats get written on shutdown, nullptr to not keep them at all
+	const char* statsPath;
+
+	// Where to record every frame's input and dt, nullptr to not record
+	const char* recordInputPath;
+
+	// Recording to play back instead of taking live input, nullptr for live input. The
+	// engine stops once the recording runs out, and runs with input even when headless
+	const char* replayInputPath;
+
+	// Time step every frame runs with no matter how long it took, 0 to use the given dt
+	float fixedDt;
+
+	EngineConfig() :
+		renderThread(false),
+		headless(false),
+		width(1280),
+		height(720),
+		frameCount(0),
+		warmupFrames(0),
+		statsPath(nullptr),
+		recordInputPath(nullptr),
+		replayInputPath(nullptr),
+		fixedDt(0.0f)
+	{}
+
+};
@@ -9,11 +9,20 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
 #include "FileReader.h"
+#include "JobSystem.h"
 
 static const std::string shapesPath = "Data/Shapes/";
 static const glm::vec3 black(0, 0, 0);
 
+// How many records each job parses when a section is split up. Kept small, since the
+// jobs share threads with the frame and whichever thread picks one up is stuck with it
+static const size_t parallelRecordCount = 1 << 16;
+
 //*****************************************************************************
 //	Description:
 //		This functions reads from a file that should be a shader and
@@ -129,121 +138,373 @@ void WriteMeshFile(Mesh* mesh)
 	return;
 }
 
-Mesh* ReadMeshFile(const char* filepath)
+//*****************************************************************************
+//	Description:
+//		Reads a whole file into memory with a single read
+//
+//	Param filepath:
+//		The filepath of the file to read
+//
+//	Param contents:
+//		The string to fill with the contents of the file
+//
+//	Return:
+//		Returns true if the whole file was read
+//*****************************************************************************
+static bool ReadWholeFile(const char* filepath, std::string* contents)
 {
-	Mesh* readMesh = nullptr;
-	std::ifstream meshFile;
-	meshFile.exceptions(std::ifstream::badbit);
-	try {
-		meshFile.open(filepath);
-		if (meshFile.is_open())
+	std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::streamoff size = file.tellg();
+	if (size < 0)
+		return false;
+
+	contents->resize(static_cast<size_t>(size));
+	file.seekg(0, std::ios::beg);
+	if (size > 0 && !file.read(&(*contents)[0], size))
+		return false;
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Reads the next line of text, without the line ending
+//
+//	Param curr:
+//		The current position in the text, moved to the start of the next line
+//
+//	Param end:
+//		The end of the text
+//
+//	Return:
+//		Returns a view of the line that was read
+//*****************************************************************************
+static std::string_view ReadLine(const char*& curr, const char* end)
+{
+	const char* lineEnd = static_cast<const char*>(memchr(curr, '\n', end - curr));
+	if (!lineEnd)
+		lineEnd = end;
+
+	std::string_view line(curr, lineEnd - curr);
+	if (!line.empty() && line.back() == '\r')
+		line.remove_suffix(1);
+
+	curr = lineEnd < end ? lineEnd + 1 : end;
+	return line;
+}
+
+//*****************************************************************************
+//	Description:
+//		Skips a number of lines of text (memchr is much faster than parsing,
+//		so this is how sections get split up between threads)
+//
+//	Param curr:
+//		The position to start skipping from
+//
+//	Param end:
+//		The end of the text
+//
+//	Param lineCount:
+//		How many lines to skip
+//
+//	Return:
+//		Returns the start of the line after the skipped lines
+//*****************************************************************************
+static const char* SkipLines(const char* curr, const char* end, size_t lineCount)
+{
+	for (size_t i = 0; i < lineCount && curr < end; ++i)
+	{
+		const char* lineEnd = static_cast<const char*>(memchr(curr, '\n', end - curr));
+		curr = lineEnd ? lineEnd + 1 : end;
+	}
+	return curr;
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses the next number in the text, skipping any whitespace before it
+//
+//	Param curr:
+//		The current position in the text, moved past the number
+//
+//	Param end:
+//		The end of the text
+//
+//	Param value:
+//		Where to put the parsed number
+//
+//	Return:
+//		Returns true if a number was parsed
+//*****************************************************************************
+template <typename T>
+static bool ParseValue(const char*& curr, const char* end, T& value)
+{
+	while (curr < end && (*curr == ' ' || *curr == '\t' || *curr == '\r' || *curr == '\n'))
+		++curr;
+
+	std::from_chars_result result = std::from_chars(curr, end, value);
+	if (result.ec != std::errc())
+		return false;
+
+	curr = result.ptr;
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Checks that a section could fit in what is left of the file, before
+//		making room for it. Every value takes at least a digit and a space
+//		or line ending, so a count bigger than that is a bad header
+//
+//	Param curr:
+//		The start of the section's first record
+//
+//	Param end:
+//		The end of the text
+//
+//	Param recordCount:
+//		How many records the section says it has
+//
+//	Param valuesPerRecord:
+//		How many numbers each record has
+//
+//	Return:
+//		Returns true if the records could fit
+//*****************************************************************************
+static bool SectionFits(const char* curr, const char* end, size_t recordCount, size_t valuesPerRecord)
+{
+	size_t remaining = static_cast<size_t>(end - curr);
+	return recordCount <= (remaining + 1) / (valuesPerRecord * 2);
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses every record of a section. Large sections are split into chunks
+//		of whole records and the chunks are parsed as jobs, each writing
+//		straight into its own part of the output
+//
+//	Param curr:
+//		The start of the section's first record, moved past the section
+//
+//	Param end:
+//		The end of the text
+//
+//	Param recordCount:
+//		How many records are in the section
+//
+//	Param linesPerRecord:
+//		How many lines each record takes up in the file
+//
+//	Param jobSystem:
+//		Job system to parse the chunks on, nullptr to parse on this thread
+//
+//	Param parseRecord:
+//		Function that parses a single record given its index
+//
+//	Return:
+//		Returns true if every record was parsed
+//*****************************************************************************
+template <typename ParseFunc>
+static bool ParseSection(const char*& curr, const char* end, size_t recordCount, size_t linesPerRecord, JobSystem* jobSystem,
+						 ParseFunc parseRecord)
+{
+	// Figure out how many chunks this section is worth splitting into
+	size_t chunkCount = recordCount / parallelRecordCount;
+	if (!jobSystem || jobSystem->GetThreadCount() == 1)
+		chunkCount = 1;
+
+	if (chunkCount <= 1)
+	{
+		for (size_t i = 0; i < recordCount; ++i)
 		{
-			// Start reading in data from the file
-			std::string currLine;
-			std::getline(meshFile, currLine);
-			if (currLine == "Mesh")
-			{
-				// Read in each line
-				while (std::getline(meshFile, currLine))
-				{
-					// If current line is name, read next line as name for mesh
-					if (currLine == "Name")
-					{
-						std::getline(meshFile, currLine);
-						readMesh = new Mesh(currLine);
-						continue;
-					}
-
-					// Start reading in vertex of the mesh
-					if (currLine == "Vertices")
-					{
-						std::getline(meshFile, currLine);
-						std::istringstream vertCountText(currLine);
-						int vertexCount;
-						vertCountText >> vertexCount;
-						for (int i = 0; i < vertexCount; ++i)
-						{
-							std::getline(meshFile, currLine);
-							std::istringstream vertData(currLine);
-							std::getline(meshFile, currLine);
-							std::istringstream colorData(currLine);
-							float x, y, z;
-							float r, g, b;
-							vertData >> x >> y >> z;
-							colorData >> r >> g >> b;
-							if (readMesh)
-								readMesh->AddVertex(GfxMath::Point(x, y, z),glm::vec3(r, g, b));
-						}
-						continue;
-					}
-
-					// Start reading in point data of the mesh
-					if (currLine == "Points")
-					{
-						std::getline(meshFile, currLine);
-						std::istringstream pointCountText(currLine);
-						int pointCount;
-						pointCountText >> pointCount;
-						for (int i = 0; i < pointCount; ++i)
-						{
-							std::getline(meshFile, currLine);
-							std::istringstream pointData(currLine);
-							unsigned int v;
-							pointData >> v;
-							if (readMesh)
-								readMesh->AddPoint(v);
-						}
-						continue;
-					}
-
-					// Start reading in edge data of the mesh
-					if (currLine == "Edges")
-					{
-						std::getline(meshFile, currLine);
-						std::istringstream edgeCountText(currLine);
-						int edgeCount;
-						edgeCountText >> edgeCount;
-						for (int i = 0; i < edgeCount; ++i)
-						{
-							std::getline(meshFile, currLine);
-							std::istringstream edgeData(currLine);
-							unsigned int v1, v2;
-							edgeData >> v1 >> v2;
-							if (readMesh)
-								readMesh->AddEdge(v1, v2);
-						}
-						continue;
-					}
-
-					// start reading in face data of the mesh
-					if (currLine == "Faces")
-					{
-						std::getline(meshFile, currLine);
-						std::istringstream faceCountText(currLine);
-						int faceCount;
-						faceCountText >> faceCount;
-						for (int i = 0; i < faceCount; ++i)
-						{
-							std::getline(meshFile, currLine);
-							std::istringstream faceData(currLine);
-							unsigned int v1, v2, v3;
-							faceData >> v1 >> v2 >> v3;
-							if (readMesh)
-								readMesh->AddFace(v1, v2, v3);
-						}
-						continue;
-					}
-				}
-			}
+			if (!parseRecord(curr, end, i))
+				return false;
+		}
 
-			meshFile.close();
+		// Move past the end of the last record's line
+		if (recordCount > 0)
+			curr = SkipLines(curr, end, 1);
+		return true;
+	}
+
+	// Find where each chunk starts by skipping whole records
+	size_t chunkRecords = (recordCount + chunkCount - 1) / chunkCount;
+	std::vector<const char*> chunkStarts(chunkCount + 1);
+	chunkStarts[0] = curr;
+	for (size_t i = 1; i <= chunkCount; ++i)
+	{
+		size_t records = std::min(chunkRecords, recordCount - std::min(recordCount, (i - 1) * chunkRecords));
+		chunkStarts[i] = SkipLines(chunkStarts[i - 1], end, records * linesPerRecord);
+	}
+
+	// Every chunk after the first is its own job, the first chunk is parsed here while they run
+	std::vector<char> chunkWorked(chunkCount, 0);
+	auto parseChunk = [&](size_t chunk) {
+		const char* chunkCurr = chunkStarts[chunk];
+		size_t first = chunk * chunkRecords;
+		size_t last = std::min(recordCount, first + chunkRecords);
+		for (size_t i = first; i < last; ++i)
+		{
+			if (!parseRecord(chunkCurr, chunkStarts[chunk + 1], i))
+				return;
 		}
+		chunkWorked[chunk] = 1;
+	};
+
+	JobCounter counter(0);
+	for (size_t i = 1; i < chunkCount; ++i)
+		jobSystem->Run([&parseChunk, i]() { parseChunk(i); }, &counter);
+	parseChunk(0);
+	jobSystem->Wait(&counter);
+
+	curr = chunkStarts[chunkCount];
+	return std::find(chunkWorked.begin(), chunkWorked.end(), 0) == chunkWorked.end();
+}
+
+//*****************************************************************************
+//	Description:
+//		Reads a mesh from a text mesh file. The whole file is read in at once
+//		and the numbers are parsed with from_chars, with large sections being
+//		split up into jobs
+//
+//	Param filepath:
+//		The filepath of the mesh file to read
+//
+//	Param jobSystem:
+//		Job system to parse large sections on, nullptr to parse everything on
+//		the calling thread
+//
+//	Return:
+//		Returns the mesh that was read, or nullptr if the file couldn't be read
+//*****************************************************************************
+Mesh* ReadMeshFile(const char* filepath, JobSystem* jobSystem)
+{
+	std::string contents;
+	if (!ReadWholeFile(filepath, &contents))
+	{
+		std::cout << "Failed to read from file: " << filepath << std::endl;
+		return nullptr;
 	}
-	catch (std::ifstream::failure error) {
+
+	const char* curr = contents.data();
+	const char* end = curr + contents.size();
+
+	// Make sure this file is of a mesh
+	if (ReadLine(curr, end) != "Mesh")
+		return nullptr;
+
+	bool hasName = false;
+	std::string name;
+	std::vector<glm::vec4> vertices;
+	std::vector<glm::vec3> colors;
+	std::vector<unsigned int> points;
+	std::vector<Mesh::Edge> edges;
+	std::vector<Mesh::Face> faces;
+
+	bool worked = true;
+	while (worked && curr < end)
+	{
+		std::string_view currLine = ReadLine(curr, end);
+
+		// If current line is name, read next line as name for mesh
+		if (currLine == "Name")
+		{
+			name = std::string(ReadLine(curr, end));
+			hasName = true;
+			continue;
+		}
+
+		// Every other section starts with how many records it has
+		bool isVertices = currLine == "Vertices";
+		bool isPoints = currLine == "Points";
+		bool isEdges = currLine == "Edges";
+		bool isFaces = currLine == "Faces";
+		if (!isVertices && !isPoints && !isEdges && !isFaces)
+			continue;
+
+		// The count comes straight from the file, so it is checked against the file's size
+		// before anything is made big enough to hold it
+		size_t count = 0;
+		if (!ParseValue(curr, end, count))
+		{
+			worked = false;
+			break;
+		}
+		curr = SkipLines(curr, end, 1);
+
+		size_t valuesPerRecord = isVertices ? 6 : (isPoints ? 1 : (isEdges ? 2 : 3));
+		if (!SectionFits(curr, end, count, valuesPerRecord))
+		{
+			worked = false;
+			break;
+		}
+
+		// Start reading in vertex of the mesh, each vertex is a position line and a color line
+		if (isVertices)
+		{
+			vertices.resize(count);
+			colors.resize(count);
+			worked = ParseSection(curr, end, count, 2, jobSystem, [&](const char*& c, const char* e, size_t i) {
+				glm::vec4& vert = vertices[i];
+				glm::vec3& color = colors[i];
+				vert.w = 1.0f;
+				return ParseValue(c, e, vert.x) && ParseValue(c, e, vert.y) && ParseValue(c, e, vert.z) &&
+					ParseValue(c, e, color.r) && ParseValue(c, e, color.g) && ParseValue(c, e, color.b);
+			});
+		}
+
+		// Start reading in point data of the mesh
+		else if (isPoints)
+		{
+			points.resize(count);
+			worked = ParseSection(curr, end, count, 1, jobSystem, [&](const char*& c, const char* e, size_t i) {
+				return ParseValue(c, e, points[i]);
+			});
+		}
+
+		// Start reading in edge data of the mesh
+		else if (isEdges)
+		{
+			edges.resize(count);
+			worked = ParseSection(curr, end, count, 1, jobSystem, [&](const char*& c, const char* e, size_t i) {
+				return ParseValue(c, e, edges[i].v1) && ParseValue(c, e, edges[i].v2);
+			});
+		}
+
+		// start reading in face data of the mesh
+		else
+		{
+			faces.resize(count);
+			worked = ParseSection(curr, end, count, 1, jobSystem, [&](const char*& c, const char* e, size_t i) {
+				return ParseValue(c, e, faces[i].v1) && ParseValue(c, e, faces[i].v2) && ParseValue(c, e, faces[i].v3);
+			});
+		}
+	}
+
+	if (!worked || !hasName)
+	{
 		std::cout << "Failed to read from file: " << filepath << std::endl;
-		if (readMesh)
-			delete readMesh;
 		return nullptr;
 	}
+
+	// Drop any points, edges or faces that reference vertices that don't exist
+	unsigned int vertexCount = static_cast<unsigned int>(vertices.size());
+	points.erase(std::remove_if(points.begin(), points.end(), [vertexCount](unsigned int v) {
+		return v >= vertexCount;
+	}), points.end());
+	edges.erase(std::remove_if(edges.begin(), edges.end(), [vertexCount](const Mesh::Edge& edge) {
+		return edge.v1 >= vertexCount || edge.v2 >= vertexCount;
+	}), edges.end());
+	faces.erase(std::remove_if(faces.begin(), faces.end(), [vertexCount](const Mesh::Face& face) {
+		return face.v1 >= vertexCount || face.v2 >= vertexCount || face.v3 >= vertexCount;
+	}), faces.end());
+
+	Mesh* readMesh = new Mesh(name);
+	readMesh->SetVertices(std::move(vertices), std::move(colors));
+	readMesh->SetPoints(std::move(points));
+	readMesh->SetEdges(std::move(edges));
+	readMesh->SetFaces(std::move(faces));
 	return readMesh;
 }
@@ -10,7 +10,9 @@
 #include <string>
 #include "Mesh.h"
 
+class JobSystem;
+
 std::string ReadShaderFile(const char* filepath);
 
 void WriteMeshFile(Mesh* mesh);
-Mesh* ReadMeshFile(const char* filepath);
\ No newline at end of file
+Mesh* ReadMeshFile(const char* filepath, JobSystem* jobSystem = nullptr);
\ No newline at end of file
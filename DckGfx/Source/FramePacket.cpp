@@ -0,0 +1,107 @@
+//*****************************************************************************
+//	File:   FramePacket.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Everything needed to draw one frame, recorded by the systems
+//		while they update and then submitted to OpenGL. With a render thread
+//		there are two of these, so one frame can be recorded while the last
+//		one is drawn
+//*****************************************************************************
+
+#include "FramePacket.h"
+#include <cstring>
+
+// Starting size of a packet's arena, grows to fit a frame if it ever runs out
+static const size_t packetArenaSize = 1 << 20;
+
+//*****************************************************************************
+//  Description:
+//		Copies an ImVector into another, reusing the memory it already has
+//*****************************************************************************
+template <typename T>
+static void CopyImVector(ImVector<T>& dst, const ImVector<T>& src)
+{
+	dst.resize(src.Size);
+	if (src.Size)
+		memcpy(dst.Data, src.Data, sizeof(T) * src.Size);
+}
+
+FramePacket::FramePacket() :
+	arena(packetArenaSize),
+	renderQueue(&arena),
+	debugQueue(&arena),
+	culledCount(0),
+	perspMat(0),
+	viewMat(0),
+	eyePoint(0),
+	shader(nullptr),
+	backColor(0),
+	viewportWidth(0),
+	viewportHeight(0),
+	useLighting(false),
+	lightPos(),
+	lightColor(),
+	ambientColor(0),
+	lightCount(0),
+	imGuiDrawData(nullptr),
+	imGuiCopy_(),
+	imGuiLists_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Empties the packet so the next frame can be recorded into it. The
+//		queues forget their memory before the arena takes it back
+//*****************************************************************************
+void FramePacket::Reset()
+{
+	renderQueue.Reset();
+	debugQueue.Reset();
+	arena.Reset();
+	culledCount = 0;
+	shader = nullptr;
+	useLighting = false;
+	lightCount = 0;
+	imGuiDrawData = nullptr;
+}
+
+//*****************************************************************************
+//  Description:
+//		Copies ImGui's draw data into the packet so it can be drawn on another
+//		thread while ImGui builds the next frame. The copied draw lists are
+//		kept around and reused every frame
+//
+//	Param drawData:
+//		The draw data from ImGui::GetDrawData
+//*****************************************************************************
+void FramePacket::CopyImGuiData(ImDrawData* drawData)
+{
+	imGuiDrawData = nullptr;
+	if (!drawData || !drawData->Valid)
+		return;
+
+	while (static_cast<int>(imGuiLists_.size()) < drawData->CmdListsCount)
+		imGuiLists_.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+	for (int i = 0; i < drawData->CmdListsCount; ++i)
+	{
+		const ImDrawList* src = drawData->CmdLists[i];
+		ImDrawList* dst = imGuiLists_[i];
+		CopyImVector(dst->CmdBuffer, src->CmdBuffer);
+		CopyImVector(dst->IdxBuffer, src->IdxBuffer);
+		CopyImVector(dst->VtxBuffer, src->VtxBuffer);
+		dst->Flags = src->Flags;
+	}
+
+	imGuiCopy_ = *drawData;
+	imGuiCopy_.CmdLists = imGuiLists_.data();
+	imGuiDrawData = &imGuiCopy_;
+}
+
+FramePacket::~FramePacket()
+{
+	for (ImDrawList* list : imGuiLists_)
+		IM_DELETE(list);
+	imGuiLists_.clear();
+}
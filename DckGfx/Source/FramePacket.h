@@ -0,0 +1,62 @@
+#pragma once
+//*****************************************************************************
+//	File:   FramePacket.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Everything needed to draw one frame, recorded by the systems
+//		while they update and then submitted to OpenGL. With a render thread
+//		there are two of these, so one frame can be recorded while the last
+//		one is drawn
+//*****************************************************************************
+
+#include "RenderSystem.h"
+#include "LightingSystem.h"
+#include "LinearArena.h"
+#include "imgui/imgui.h"
+#include <vector>
+
+struct FramePacket {
+
+	FramePacket();
+
+	void Reset();
+	void CopyImGuiData(ImDrawData* drawData);
+
+	~FramePacket();
+
+	// Render commands for the frame, allocated out of the packet's own arena
+	LinearArena arena;
+	ArenaArray<RenderSystem::RenderData> renderQueue;
+	ArenaArray<RenderSystem::RenderData> debugQueue;
+
+	// Objects culled while the frame was recorded, counted as each one is skipped
+	int culledCount;
+
+	// Camera the frame is drawn from
+	glm::mat4 perspMat;
+	glm::mat4 viewMat;
+	glm::vec4 eyePoint;
+
+	// Graphics state for the frame
+	Shader* shader;
+	glm::vec3 backColor;
+	int viewportWidth;
+	int viewportHeight;
+
+	// Light data, only uploaded if the active shader uses lighting
+	bool useLighting;
+	glm::vec4 lightPos[maxLights];
+	glm::vec3 lightColor[maxLights];
+	glm::vec3 ambientColor;
+	int lightCount;
+
+	// ImGui draw data for the frame, either ImGui's own or the packet's copy of it
+	ImDrawData* imGuiDrawData;
+
+private:
+
+	// Copy of ImGui's draw lists, since ImGui reuses its own as soon as the next frame starts
+	ImDrawData imGuiCopy_;
+	std::vector<ImDrawList*> imGuiLists_;
+
+};
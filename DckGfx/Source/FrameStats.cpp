@@ -0,0 +1,104 @@
+//*****************************************************************************
+//	File:   FrameStats.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Collects a timing sample every frame and summarizes them as
+//		an average and percentiles, for benchmarking
+//*****************************************************************************
+
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+
+//*****************************************************************************
+//  Description:
+//		Gets a percentile out of sorted samples with the nearest rank method,
+//		so the result is always one of the samples
+//*****************************************************************************
+static float Percentile(const std::vector<float>& sorted, float percent)
+{
+	int rank = static_cast<int>(std::ceil(percent / 100.0f * sorted.size()));
+	return sorted[std::min(std::max(rank - 1, 0), static_cast<int>(sorted.size()) - 1)];
+}
+
+FrameStats::FrameStats() :
+	samples_()
+{
+}
+
+void FrameStats::Add(float ms)
+{
+	samples_.push_back(ms);
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes room for samples ahead of time, so adding them doesn't allocate
+//*****************************************************************************
+void FrameStats::Reserve(int count)
+{
+	samples_.reserve(count);
+}
+
+void FrameStats::Clear()
+{
+	samples_.clear();
+}
+
+int FrameStats::GetCount()
+{
+	return static_cast<int>(samples_.size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Summarizes every sample added so far
+//
+//	Return:
+//		Returns the summary, all zero if there are no samples
+//*****************************************************************************
+FrameStats::Summary FrameStats::Summarize()
+{
+	Summary summary = Summary();
+	if (samples_.empty())
+		return summary;
+
+	std::vector<float> sorted(samples_);
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (float sample : sorted)
+		total += sample;
+
+	summary.count = static_cast<int>(sorted.size());
+	summary.mean = static_cast<float>(total / sorted.size());
+	summary.min = sorted.front();
+	summary.max = sorted.back();
+	summary.p50 = Percentile(sorted, 50.0f);
+	summary.p95 = Percentile(sorted, 95.0f);
+	summary.p99 = Percentile(sorted, 99.0f);
+	return summary;
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes the summary as a JSON object
+//
+//	Param out:
+//		Stream to write to
+//*****************************************************************************
+void FrameStats::WriteJson(std::ostream& out)
+{
+	Summary summary = Summarize();
+	out << "{ \"count\": " << summary.count
+		<< ", \"mean\": " << summary.mean
+		<< ", \"min\": " << summary.min
+		<< ", \"max\": " << summary.max
+		<< ", \"p50\": " << summary.p50
+		<< ", \"p95\": " << summary.p95
+		<< ", \"p99\": " << summary.p99 << " }";
+}
+
+FrameStats::~FrameStats()
+{
+}
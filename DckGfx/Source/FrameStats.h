@@ -0,0 +1,42 @@
+#pragma once
+//*****************************************************************************
+//	File:   FrameStats.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Collects a timing sample every frame and summarizes them as
+//		an average and percentiles, for benchmarking
+//*****************************************************************************
+
+#include <ostream>
+#include <vector>
+
+class FrameStats {
+public:
+
+	struct Summary {
+		int count;
+		float mean;
+		float min;
+		float max;
+		float p50;
+		float p95;
+		float p99;
+	};
+
+	FrameStats();
+
+	void Add(float ms);
+	void Reserve(int count);
+	void Clear();
+	int GetCount();
+
+	Summary Summarize();
+	void WriteJson(std::ostream& out);
+
+	~FrameStats();
+
+private:
+
+	std::vector<float> samples_;
+
+};
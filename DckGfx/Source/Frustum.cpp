@@ -0,0 +1,204 @@
+//*****************************************************************************
+//	File:   Frustum.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: View frustum for culling. Planes are kept as a structure of
+//		arrays so sphere and box tests check four planes at a time with SSE
+//*****************************************************************************
+
+#include "Frustum.h"
+#include <cmath>
+
+#ifdef DCK_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+//*****************************************************************************
+//  Description:
+//		Constructor for a frustum. Starts with every plane letting everything
+//		through until planes are extracted
+//*****************************************************************************
+Frustum::Frustum()
+{
+	for (int i = 0; i < planeSlots; ++i)
+	{
+		nx_[i] = ny_[i] = nz_[i] = 0.0f;
+		absNx_[i] = absNy_[i] = absNz_[i] = 0.0f;
+		d_[i] = 1.0f;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Extracts the frustum planes from a perspective * view matrix
+//
+//	Param viewProj:
+//		The perspective matrix times the view matrix
+//*****************************************************************************
+void Frustum::Extract(const glm::mat4& viewProj)
+{
+	glm::vec4 planes[6];
+	GfxMath::FrustumPlanes(viewProj, planes);
+
+	for (int i = 0; i < 6; ++i)
+	{
+		nx_[i] = planes[i].x;
+		ny_[i] = planes[i].y;
+		nz_[i] = planes[i].z;
+		absNx_[i] = std::fabs(planes[i].x);
+		absNy_[i] = std::fabs(planes[i].y);
+		absNz_[i] = std::fabs(planes[i].z);
+		d_[i] = planes[i].w;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if a sphere is at least partly inside the frustum
+//
+//	Param center:
+//		The center of the sphere in world space
+//
+//	Param radius:
+//		The radius of the sphere
+//
+//	Return:
+//		Returns false if the sphere is completely outside of any plane
+//*****************************************************************************
+bool Frustum::SphereVisible(const glm::vec3& center, float radius) const
+{
+#ifdef DCK_FRUSTUM_SSE
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+	__m128 negRadius = _mm_set1_ps(-radius);
+
+	for (int i = 0; i < planeSlots; i += 4)
+	{
+		// Signed distance from four planes at once
+		__m128 dist = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx_ + i), cx), _mm_mul_ps(_mm_load_ps(ny_ + i), cy)),
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nz_ + i), cz), _mm_load_ps(d_ + i)));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(dist, negRadius)))
+			return false;
+	}
+	return true;
+#else
+	for (int i = 0; i < planeSlots; ++i)
+	{
+		float dist = nx_[i] * center.x + ny_[i] * center.y + nz_[i] * center.z + d_[i];
+		if (dist < -radius)
+			return false;
+	}
+	return true;
+#endif
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if an axis aligned box is at least partly inside the frustum,
+//		by checking the corner of the box furthest along each plane normal
+//
+//	Param center:
+//		The center of the box in world space
+//
+//	Param extents:
+//		Half of the size of the box on each axis
+//
+//	Return:
+//		Returns false if the box is completely outside of any plane
+//*****************************************************************************
+bool Frustum::BoxVisible(const glm::vec3& center, const glm::vec3& extents) const
+{
+#ifdef DCK_FRUSTUM_SSE
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+	__m128 ex = _mm_set1_ps(extents.x);
+	__m128 ey = _mm_set1_ps(extents.y);
+	__m128 ez = _mm_set1_ps(extents.z);
+	__m128 zero = _mm_setzero_ps();
+
+	for (int i = 0; i < planeSlots; i += 4)
+	{
+		// Distance of the center plus how far the box reaches towards each plane
+		__m128 dist = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx_ + i), cx), _mm_mul_ps(_mm_load_ps(ny_ + i), cy)),
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nz_ + i), cz), _mm_load_ps(d_ + i)));
+		__m128 reach = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(absNx_ + i), ex), _mm_mul_ps(_mm_load_ps(absNy_ + i), ey)),
+			_mm_mul_ps(_mm_load_ps(absNz_ + i), ez));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, reach), zero)))
+			return false;
+	}
+	return true;
+#else
+	for (int i = 0; i < planeSlots; ++i)
+	{
+		float dist = nx_[i] * center.x + ny_[i] * center.y + nz_[i] * center.z + d_[i];
+		float reach = absNx_[i] * extents.x + absNy_[i] * extents.y + absNz_[i] * extents.z;
+		if (dist + reach < 0.0f)
+			return false;
+	}
+	return true;
+#endif
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks how much of an axis aligned box is inside the frustum. Used
+//		for culling hierarchies, since nothing in a box that is all the way
+//		inside needs to be checked again
+//
+//	Param center:
+//		The center of the box in world space
+//
+//	Param extents:
+//		Half of the size of the box on each axis
+//
+//	Return:
+//		Returns Outside if the box is completely outside of any plane, Inside
+//		if it is completely inside every plane, and Intersects otherwise
+//*****************************************************************************
+Frustum::Containment Frustum::ClassifyBox(const glm::vec3& center, const glm::vec3& extents) const
+{
+#ifdef DCK_FRUSTUM_SSE
+	__m128 cx = _mm_set1_ps(center.x);
+	__m128 cy = _mm_set1_ps(center.y);
+	__m128 cz = _mm_set1_ps(center.z);
+	__m128 ex = _mm_set1_ps(extents.x);
+	__m128 ey = _mm_set1_ps(extents.y);
+	__m128 ez = _mm_set1_ps(extents.z);
+	__m128 zero = _mm_setzero_ps();
+	int crossing = 0;
+
+	for (int i = 0; i < planeSlots; i += 4)
+	{
+		__m128 dist = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx_ + i), cx), _mm_mul_ps(_mm_load_ps(ny_ + i), cy)),
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(nz_ + i), cz), _mm_load_ps(d_ + i)));
+		__m128 reach = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_load_ps(absNx_ + i), ex), _mm_mul_ps(_mm_load_ps(absNy_ + i), ey)),
+			_mm_mul_ps(_mm_load_ps(absNz_ + i), ez));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, reach), zero)))
+			return Outside;
+		crossing |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(dist, reach), zero));
+	}
+	return crossing ? Intersects : Inside;
+#else
+	bool crossing = false;
+	for (int i = 0; i < planeSlots; ++i)
+	{
+		float dist = nx_[i] * center.x + ny_[i] * center.y + nz_[i] * center.z + d_[i];
+		float reach = absNx_[i] * extents.x + absNy_[i] * extents.y + absNz_[i] * extents.z;
+		if (dist + reach < 0.0f)
+			return Outside;
+		if (dist - reach < 0.0f)
+			crossing = true;
+	}
+	return crossing ? Intersects : Inside;
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+//*****************************************************************************
+//	File:   Frustum.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: View frustum for culling. Planes are kept as a structure of
+//		arrays so sphere and box tests check four planes at a time with SSE
+//*****************************************************************************
+
+#include "GfxMath.h"
+
+// SSE is always there on x86/x64, anything else falls back to plain floats
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define DCK_FRUSTUM_SSE 1
+#endif
+
+class Frustum {
+public:
+
+	// Where a box is compared to the frustum
+	enum Containment {
+		Outside,
+		Intersects,
+		Inside
+	};
+
+	Frustum();
+
+	void Extract(const glm::mat4& viewProj);
+
+	bool SphereVisible(const glm::vec3& center, float radius) const;
+	bool BoxVisible(const glm::vec3& center, const glm::vec3& extents) const;
+	Containment ClassifyBox(const glm::vec3& center, const glm::vec3& extents) const;
+
+private:
+
+	// Six planes padded out to eight with planes everything is in front of
+	static const int planeSlots = 8;
+
+	// Plane normals, absolute values of the normals (for boxes), and offsets
+	alignas(16) float nx_[planeSlots];
+	alignas(16) float ny_[planeSlots];
+	alignas(16) float nz_[planeSlots];
+	alignas(16) float absNx_[planeSlots];
+	alignas(16) float absNy_[planeSlots];
+	alignas(16) float absNz_[planeSlots];
+	alignas(16) float d_[planeSlots];
+
+};
@@ -196,6 +196,244 @@ glm::mat4 GfxMath::Rotate3D(const glm::vec4 &rotVec, float angle)
 	return result;
 }
 
+//*****************************************************************************
+//  Description:
+//		Composes two rotations
+// 
+//	Param other:
+//		The rotation to do first
+// 
+//	Return:
+//		Returns a quaternion that rotates by other, then by this one
+//*****************************************************************************
+GfxMath::Quat GfxMath::Quat::operator*(const Quat& other) const
+{
+	return Quat(
+		w * other.x + x * other.w + y * other.z - z * other.y,
+		w * other.y - x * other.z + y * other.w + z * other.x,
+		w * other.z + x * other.y - y * other.x + z * other.w,
+		w * other.w - x * other.x - y * other.y - z * other.z
+	);
+}
+
+//*****************************************************************************
+//  Description:
+//		Creates a quaternion that rotates around a vector by a given amount,
+//		the same rotation Rotate3D makes a matrix for
+// 
+//	Param rotVec:
+//		The vector to rotate around in 3D, doesn't need to be unit length
+// 
+//	Param angle:
+//		The amount to rotate by in degrees
+// 
+//	Return:
+//		A unit quaternion for the rotation
+//*****************************************************************************
+GfxMath::Quat GfxMath::QuatFromAxisAngle(const glm::vec4& rotVec, float angle)
+{
+	float vecLength = glm::length(glm::vec3(rotVec));
+	if (vecLength <= 0.0f)
+		return Quat();
+
+	float halfRadians = glm::radians(angle) * 0.5f;
+	float coeff = sinf(halfRadians) / vecLength;
+	return Quat(rotVec.x * coeff, rotVec.y * coeff, rotVec.z * coeff, cosf(halfRadians));
+}
+
+//*****************************************************************************
+//  Description:
+//		Creates a quaternion from a rotation matrix
+// 
+//	Param rotation:
+//		A 3x3 matrix with orthonormal columns
+// 
+//	Return:
+//		A unit quaternion for the same rotation
+//*****************************************************************************
+GfxMath::Quat GfxMath::QuatFromMatrix(const glm::mat3& rotation)
+{
+	// Works out from whichever part of the quaternion is largest, so it never divides by something near 0
+	float trace = rotation[0][0] + rotation[1][1] + rotation[2][2];
+	Quat result;
+	if (trace > 0.0f)
+	{
+		float s = sqrtf(trace + 1.0f) * 2.0f;
+		result = Quat((rotation[1][2] - rotation[2][1]) / s, (rotation[2][0] - rotation[0][2]) / s,
+					  (rotation[0][1] - rotation[1][0]) / s, 0.25f * s);
+	}
+	else if (rotation[0][0] > rotation[1][1] && rotation[0][0] > rotation[2][2])
+	{
+		float s = sqrtf(1.0f + rotation[0][0] - rotation[1][1] - rotation[2][2]) * 2.0f;
+		result = Quat(0.25f * s, (rotation[1][0] + rotation[0][1]) / s,
+					  (rotation[2][0] + rotation[0][2]) / s, (rotation[1][2] - rotation[2][1]) / s);
+	}
+	else if (rotation[1][1] > rotation[2][2])
+	{
+		float s = sqrtf(1.0f + rotation[1][1] - rotation[0][0] - rotation[2][2]) * 2.0f;
+		result = Quat((rotation[1][0] + rotation[0][1]) / s, 0.25f * s,
+					  (rotation[2][1] + rotation[1][2]) / s, (rotation[2][0] - rotation[0][2]) / s);
+	}
+	else
+	{
+		float s = sqrtf(1.0f + rotation[2][2] - rotation[0][0] - rotation[1][1]) * 2.0f;
+		result = Quat((rotation[2][0] + rotation[0][2]) / s, (rotation[2][1] + rotation[1][2]) / s,
+					  0.25f * s, (rotation[0][1] - rotation[1][0]) / s);
+	}
+	return QuatNormalize(result);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the vector and angle a quaternion rotates around
+// 
+//	Param q:
+//		The quaternion to get the rotation of
+// 
+//	Param rotVec:
+//		Filled in with the unit vector rotated around, or the y axis if there
+//		is no rotation
+// 
+//	Param angle:
+//		Filled in with the amount rotated in degrees, from 0 to 360
+//*****************************************************************************
+void GfxMath::QuatToAxisAngle(const Quat& q, glm::vec4* rotVec, float* angle)
+{
+	Quat unit = QuatNormalize(q);
+	float w = glm::clamp(unit.w, -1.0f, 1.0f);
+	float sinHalf = sqrtf(1.0f - w * w);
+
+	*angle = glm::degrees(2.0f * acosf(w));
+	if (sinHalf < 1e-6f)
+		*rotVec = Vector(0, 1, 0);
+	else
+		*rotVec = Vector(unit.x / sinHalf, unit.y / sinHalf, unit.z / sinHalf);
+}
+
+//*****************************************************************************
+//  Description:
+//		Scales a quaternion back to unit length, which keeps rounding error
+//		from building up over many compositions
+// 
+//	Param q:
+//		The quaternion to normalize
+// 
+//	Return:
+//		The unit quaternion, or no rotation if q was all 0
+//*****************************************************************************
+GfxMath::Quat GfxMath::QuatNormalize(const Quat& q)
+{
+	float lengthSq = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+	if (lengthSq <= 0.0f)
+		return Quat();
+
+	float invLength = 1.0f / sqrtf(lengthSq);
+	return Quat(q.x * invLength, q.y * invLength, q.z * invLength, q.w * invLength);
+}
+
+//*****************************************************************************
+//  Description:
+//		Spherical linear interpolation between two rotations, which turns at
+//		a constant speed the short way around
+// 
+//	Param from:
+//		The rotation at t = 0
+// 
+//	Param to:
+//		The rotation at t = 1
+// 
+//	Param t:
+//		How far to go from one rotation to the other
+// 
+//	Return:
+//		A unit quaternion between the two rotations
+//*****************************************************************************
+GfxMath::Quat GfxMath::QuatSlerp(const Quat& from, const Quat& to, float t)
+{
+	// q and -q are the same rotation, pick whichever one is closer
+	float cosTheta = from.x * to.x + from.y * to.y + from.z * to.z + from.w * to.w;
+	Quat end = to;
+	if (cosTheta < 0.0f)
+	{
+		cosTheta = -cosTheta;
+		end = Quat(-to.x, -to.y, -to.z, -to.w);
+	}
+
+	// Nearly the same rotation, a straight line is close enough and avoids dividing by a tiny sine
+	float fromCoeff = 1.0f - t;
+	float toCoeff = t;
+	if (cosTheta < 0.9995f)
+	{
+		float theta = acosf(cosTheta);
+		float invSin = 1.0f / sinf(theta);
+		fromCoeff = sinf(fromCoeff * theta) * invSin;
+		toCoeff = sinf(toCoeff * theta) * invSin;
+	}
+
+	return QuatNormalize(Quat(
+		fromCoeff * from.x + toCoeff * end.x,
+		fromCoeff * from.y + toCoeff * end.y,
+		fromCoeff * from.z + toCoeff * end.z,
+		fromCoeff * from.w + toCoeff * end.w
+	));
+}
+
+//*****************************************************************************
+//  Description:
+//		Generates a 4x4 rotation matrix from a quaternion. No trig is needed,
+//		so this is much cheaper than Rotate3D
+// 
+//	Param q:
+//		The quaternion to make a matrix from, doesn't need to be unit length
+// 
+//	Return:
+//		A 4x4 matrix that rotates a 3D object the same as the quaternion
+//*****************************************************************************
+glm::mat4 GfxMath::QuatToMatrix(const Quat& q)
+{
+	float lengthSq = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+	float s = lengthSq > 0.0f ? 2.0f / lengthSq : 0.0f;
+
+	float xx = q.x * q.x * s;
+	float yy = q.y * q.y * s;
+	float zz = q.z * q.z * s;
+	float xy = q.x * q.y * s;
+	float xz = q.x * q.z * s;
+	float yz = q.y * q.z * s;
+	float wx = q.w * q.x * s;
+	float wy = q.w * q.y * s;
+	float wz = q.w * q.z * s;
+
+	return glm::mat4(
+		1.0f - yy - zz, xy + wz, xz - wy, 0,
+		xy - wz, 1.0f - xx - zz, yz + wx, 0,
+		xz + wy, yz - wx, 1.0f - xx - yy, 0,
+		0, 0, 0, 1
+	);
+}
+
+//*****************************************************************************
+//  Description:
+//		Rotates a vector or point by a unit quaternion, without making a
+//		matrix
+// 
+//	Param q:
+//		The unit quaternion to rotate by
+// 
+//	Param v:
+//		The vector or point to rotate, w is kept as is
+// 
+//	Return:
+//		The rotated vector or point
+//*****************************************************************************
+glm::vec4 GfxMath::QuatRotate(const Quat& q, const glm::vec4& v)
+{
+	glm::vec3 qVec(q.x, q.y, q.z);
+	glm::vec3 vec(v);
+	glm::vec3 t = 2.0f * glm::cross(qVec, vec);
+	return glm::vec4(vec + q.w * t + glm::cross(qVec, t), v.w);
+}
+
 //*****************************************************************************
 //  Description:
 //		Generates a 4x4 Affine matrix given 4 column vectors
@@ -287,3 +525,40 @@ glm::vec4 GfxMath::CrossProduct(const glm::vec4& u, const glm::vec4& v)
 	glm::vec3 crossResult = glm::cross(u3, v3);
 	return glm::vec4(crossResult, u.w);
 }
+
+
+//*****************************************************************************
+//  Description:
+//		Extracts the six planes of the view frustum from a combined
+//		perspective * view matrix. Each plane is xyz normal pointing into the
+//		frustum and w offset, normalized so plane dot a point is the distance
+//		to the plane
+// 
+//	Param viewProj:
+//		The perspective matrix times the view matrix
+// 
+//	Param planes:
+//		Array filled with the left, right, bottom, top, near, and far planes
+//*****************************************************************************
+void GfxMath::FrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6])
+{
+	// Rows of the matrix (glm is column major)
+	glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+	glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+	glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+	glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+	planes[0] = row3 + row0;
+	planes[1] = row3 - row0;
+	planes[2] = row3 + row1;
+	planes[3] = row3 - row1;
+	planes[4] = row3 + row2;
+	planes[5] = row3 - row2;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		float length = glm::length(glm::vec3(planes[i]));
+		if (length > 0.0f)
+			planes[i] /= length;
+	}
+}
\ No newline at end of file
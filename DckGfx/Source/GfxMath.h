@@ -10,6 +10,36 @@
 #include "glm/glm.hpp"
 
 namespace GfxMath {
+
+	//*************************************************************************
+	//  Description:
+	//		Quaternion for 3D rotations, xyz is the vector part and w the
+	//		scalar part. Multiplying two together gives the rotation of the
+	//		right one followed by the left one
+	//*************************************************************************
+	struct Quat {
+		float x;
+		float y;
+		float z;
+		float w;
+
+		Quat() :
+			x(0),
+			y(0),
+			z(0),
+			w(1)
+		{}
+
+		Quat(float qx, float qy, float qz, float qw) :
+			x(qx),
+			y(qy),
+			z(qz),
+			w(qw)
+		{}
+
+		Quat operator*(const Quat& other) const;
+	};
+
 	glm::vec4 Point(float x, float y, float z=0);
 	glm::vec4 Vector(float x, float y, float z=0);
 
@@ -22,9 +52,19 @@ namespace GfxMath {
 	glm::mat4 Rotate2D(float angle);
 	glm::mat4 Rotate3D(const glm::vec4 &rotVec, float angle);
 
+	Quat QuatFromAxisAngle(const glm::vec4& rotVec, float angle);
+	Quat QuatFromMatrix(const glm::mat3& rotation);
+	void QuatToAxisAngle(const Quat& q, glm::vec4* rotVec, float* angle);
+	Quat QuatNormalize(const Quat& q);
+	Quat QuatSlerp(const Quat& from, const Quat& to, float t);
+	glm::mat4 QuatToMatrix(const Quat& q);
+	glm::vec4 QuatRotate(const Quat& q, const glm::vec4& v);
+
 	glm::mat4 Affine(const glm::vec4& v1, const glm::vec4& v2, const glm::vec4& v3, const glm::vec4& v4);
 	glm::mat4 AffineInverse(const glm::mat4& affine);
 	glm::mat4 NormalMatrix(const glm::mat4& trans);
 
 	glm::vec4 CrossProduct(const glm::vec4& u, const glm::vec4& v);
+
+	void FrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6]);
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+//*****************************************************************************
+//	File:   GpuTimer.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Times sections of GPU work with GL_TIME_ELAPSED queries. Each
+//		frame gets its own set of queries out of a ring, and results are only
+//		read once OpenGL says they are available, so timing never stalls the
+//		CPU waiting on the GPU
+//*****************************************************************************
+
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer() :
+	queries_(),
+	pending_(),
+	ms_(),
+	timerCount_(0),
+	frame_(0),
+	activeTimer_(-1)
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes the queries. Must be called on the thread with the GL context
+//
+//	Param timerCount:
+//		How many separate sections are timed each frame
+//*****************************************************************************
+void GpuTimer::Initialize(int timerCount)
+{
+	timerCount_ = timerCount;
+	frame_ = 0;
+	activeTimer_ = -1;
+
+	queries_.assign(frameLatency * timerCount, 0);
+	pending_.assign(frameLatency * timerCount, 0);
+	ms_.assign(timerCount, 0.0f);
+	glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+//*****************************************************************************
+//  Description:
+//		Deletes the queries. Must be called on the thread with the GL context
+//*****************************************************************************
+void GpuTimer::Shutdown()
+{
+	if (!queries_.empty())
+		glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+	queries_.clear();
+	pending_.clear();
+	timerCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Moves on to the next frame's queries, reading every result that has
+//		come back from the oldest frame to the newest. The queries being
+//		reused are the oldest ones, anything they still haven't finished is
+//		thrown away rather than waited on
+//*****************************************************************************
+void GpuTimer::NewFrame()
+{
+	if (queries_.empty())
+		return;
+
+	frame_ = (frame_ + 1) % frameLatency;
+	for (int i = 0; i < frameLatency; ++i)
+	{
+		int frame = (frame_ + i) % frameLatency;
+		for (int timer = 0; timer < timerCount_; ++timer)
+		{
+			int index = frame * timerCount_ + timer;
+			if (!pending_[index])
+				continue;
+
+			GLint available = 0;
+			glGetQueryObjectiv(queries_[index], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available)
+			{
+				GLuint64 elapsedNs = 0;
+				glGetQueryObjectui64v(queries_[index], GL_QUERY_RESULT, &elapsedNs);
+				ms_[timer] = static_cast<float>(elapsedNs / 1000000.0);
+				pending_[index] = 0;
+			}
+			else if (frame == frame_)
+				pending_[index] = 0;
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts timing a section. Timers can't be nested or overlap, only one
+//		can be running at a time
+//
+//	Param timer:
+//		Which section is being timed
+//*****************************************************************************
+void GpuTimer::Begin(int timer)
+{
+	if (activeTimer_ != -1 || timer < 0 || timer >= timerCount_)
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, queries_[frame_ * timerCount_ + timer]);
+	activeTimer_ = timer;
+}
+
+//*****************************************************************************
+//  Description:
+//		Stops timing the running section. The result shows up a few frames
+//		later
+//*****************************************************************************
+void GpuTimer::End()
+{
+	if (activeTimer_ == -1)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	pending_[frame_ * timerCount_ + activeTimer_] = 1;
+	activeTimer_ = -1;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the newest time a section took on the GPU
+//
+//	Param timer:
+//		Which section to get the time of
+//
+//	Return:
+//		Returns the time in milliseconds, or 0 if it hasn't been timed yet
+//*****************************************************************************
+float GpuTimer::GetMs(int timer)
+{
+	if (timer < 0 || timer >= static_cast<int>(ms_.size()))
+		return 0.0f;
+	return ms_[timer];
+}
+
+GpuTimer::~GpuTimer()
+{
+}
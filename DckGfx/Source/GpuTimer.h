@@ -0,0 +1,47 @@
+#pragma once
+//*****************************************************************************
+//	File:   GpuTimer.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Times sections of GPU work with GL_TIME_ELAPSED queries. Each
+//		frame gets its own set of queries out of a ring, and results are only
+//		read once OpenGL says they are available, so timing never stalls the
+//		CPU waiting on the GPU
+//*****************************************************************************
+
+#include "glad/glad.h"
+#include <vector>
+
+class GpuTimer {
+public:
+
+	GpuTimer();
+
+	void Initialize(int timerCount);
+	void Shutdown();
+
+	void NewFrame();
+	void Begin(int timer);
+	void End();
+
+	float GetMs(int timer);
+
+	~GpuTimer();
+
+private:
+
+	// How many frames of queries can be waiting on the GPU at once
+	static const int frameLatency = 4;
+
+	// frameLatency sets of timerCount_ queries, and whether each is waiting on a result
+	std::vector<GLuint> queries_;
+	std::vector<char> pending_;
+
+	// Newest result of each timer in milliseconds
+	std::vector<float> ms_;
+
+	int timerCount_;
+	int frame_;
+	int activeTimer_;
+
+};
@@ -11,13 +11,23 @@
 #include "Engine.h"
 #include "SDL2/SDL.h"
 #include "ShaderLib.h"
+#include "AssetLoader.h"
 #include <stdexcept>
 #include <iostream>
 
-GraphicsSystem::GraphicsSystem() : System(SysType::GraphicsSys),
+GraphicsSystem::GraphicsSystem() : System(Type),
 	activeShader_(nullptr),
-	backColor_(glm::vec3(0.5, 0.5, 0.5))
+	backColor_(glm::vec3(0.5, 0.5, 0.5)),
+	uploadBudget_(2.0f),
+	viewportWidth_(0),
+	viewportHeight_(0),
+	backbuffer_(0),
+	backbufferColor_(0),
+	backbufferDepth_(0),
+	windowSys_(nullptr)
 {
+	// Clears the frame after the last one was swapped
+	RunsAfter(WindowSys);
 }
 
 void GraphicsSystem::Initialize()
@@ -36,12 +46,15 @@ void GraphicsSystem::Initialize()
 	int worked = SDL_GL_SetSwapInterval(0);
 
 	// Get the current window size and set the viewport
-	WindowSystem* windowSys = dynamic_cast<WindowSystem*>(GetParent()->GetSystem(SysType::WindowSys));
-	if (windowSys)
+	windowSys_ = GetParent()->Get<WindowSystem>();
+	if (windowSys_)
 	{
-		int w, h;
-		windowSys->GetWindowSize(&w, &h);
-		glViewport(0, 0, w, h);
+		windowSys_->GetWindowSize(&viewportWidth_, &viewportHeight_);
+		glViewport(0, 0, viewportWidth_, viewportHeight_);
+
+		// Headless windows are never shown, so draw into a framebuffer instead
+		if (windowSys_->IsHeadless())
+			CreateBackbuffer(viewportWidth_, viewportHeight_);
 	}
 }
 
@@ -52,24 +65,56 @@ void GraphicsSystem::Update(float dt)
 		activeShader_ = ShaderLibraryGet("Phong Shader");
 	}
 
+	// Record the state the frame gets drawn with
+	FramePacket* packet = GetParent()->GetFramePacket();
+	packet->shader = activeShader_;
+	packet->backColor = backColor_;
+	if (windowSys_)
+		windowSys_->GetWindowSize(&packet->viewportWidth, &packet->viewportHeight);
+}
+
+void GraphicsSystem::Submit(FramePacket& packet)
+{
+	// Upload any meshes that finished loading in the background, as long as there is time for it
+	AssetLoaderUpload(uploadBudget_);
+
+	// Follow the window if it was resized
+	bool hasViewport = packet.viewportWidth > 0 && packet.viewportHeight > 0;
+	if (hasViewport && (packet.viewportWidth != viewportWidth_ || packet.viewportHeight != viewportHeight_))
+	{
+		viewportWidth_ = packet.viewportWidth;
+		viewportHeight_ = packet.viewportHeight;
+		glViewport(0, 0, viewportWidth_, viewportHeight_);
+	}
+
 	// Make sure to clear the screen and the depth buffer
-	glClearColor(backColor_.r, backColor_.g, backColor_.b, 1.0f);
+	glClearColor(packet.backColor.r, packet.backColor.g, packet.backColor.b, 1.0f);
 	glClearDepth(1);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// Make sure to use the current active shader here, in case it has swapped somewhere else
-	activeShader_->Use();
+	// Make sure to use the frame's shader here, in case it has swapped somewhere else
+	if (packet.shader)
+		packet.shader->Use();
 }
 
 void GraphicsSystem::Shutdown()
 {
+	if (backbuffer_)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &backbuffer_);
+		glDeleteRenderbuffers(1, &backbufferColor_);
+		glDeleteRenderbuffers(1, &backbufferDepth_);
+	}
+	backbuffer_ = 0;
+	backbufferColor_ = 0;
+	backbufferDepth_ = 0;
 }
 
 void GraphicsSystem::SetActiveShader(Shader* shader)
 {
+	// Put into use when the next frame is submitted
 	activeShader_ = shader;
-	if (activeShader_)
-		activeShader_->Use();
 }
 
 Shader* GraphicsSystem::GetActiveShader()
@@ -77,6 +122,40 @@ Shader* GraphicsSystem::GetActiveShader()
 	return activeShader_;
 }
 
+//*****************************************************************************
+//  Description:
+//		Makes a framebuffer to draw into in place of the window's, and leaves
+//		it bound. It stays bound for good, since nothing else binds framebuffers
+//
+//	Param width:
+//		Width of the framebuffer in pixels
+//
+//	Param height:
+//		Height of the framebuffer in pixels
+//*****************************************************************************
+void GraphicsSystem::CreateBackbuffer(int width, int height)
+{
+	glGenRenderbuffers(1, &backbufferColor_);
+	glBindRenderbuffer(GL_RENDERBUFFER, backbufferColor_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &backbufferDepth_);
+	glBindRenderbuffer(GL_RENDERBUFFER, backbufferDepth_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &backbuffer_);
+	glBindFramebuffer(GL_FRAMEBUFFER, backbuffer_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, backbufferColor_);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, backbufferDepth_);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Offscreen framebuffer failed to be created" << std::endl;
+		throw std::runtime_error("Offscreen framebuffer failed to be created");
+	}
+}
+
 GraphicsSystem::~GraphicsSystem()
 {
 
@@ -11,13 +11,18 @@
 #include "Shader.h"
 #include "GfxMath.h"
 
+class WindowSystem;
+
 class GraphicsSystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::GraphicsSys;
+
 	GraphicsSystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
+	void Submit(FramePacket& packet) override;
 	void Shutdown() override;
 
 	void SetActiveShader(Shader* shader);
@@ -30,7 +35,24 @@ public:
 
 private:
 
+	void CreateBackbuffer(int width, int height);
+
 	Shader* activeShader_;
 	glm::vec3 backColor_;
 
+	// Milliseconds per frame that can be spent uploading async loaded meshes
+	float uploadBudget_;
+
+	// Size the viewport was last set to, only touched while submitting
+	int viewportWidth_;
+	int viewportHeight_;
+
+	// Framebuffer drawn into instead of the window's when headless
+	GLuint backbuffer_;
+	GLuint backbufferColor_;
+	GLuint backbufferDepth_;
+
+	// Systems this one uses, looked up once in Initialize
+	WindowSystem* windowSys_;
+
 };
\ No newline at end of file
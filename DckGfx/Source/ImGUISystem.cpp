@@ -8,14 +8,30 @@
 #include "Engine.h"
 #include "WindowSystem.h"
 #include "ObjectManagerSystem.h"
+#include "RenderSystem.h"
+#include "InputSystem.h"
+#include "CameraSystem.h"
 #include "ImGUISystem.h"
+#include "FramePacket.h"
+#include "Profiler.h"
 #include "imgui/imgui_impl_sdl.h"
 #include "imgui/imgui_impl_opengl3.h"
+#include <algorithm>
 #include <iostream>
-
-ImGUISystem::ImGUISystem() : System(ImGUISys)
+#include <vector>
+
+ImGUISystem::ImGUISystem() : System(Type),
+	selectedObject_(),
+	windowSys_(nullptr),
+	objManSys_(nullptr),
+	renderSys_(nullptr),
+	inputSys_(nullptr),
+	camSys_(nullptr)
 {
-
+	// Clicks are cast from this frame's camera at where the objects are this frame
+	RunsAfter(InputSys);
+	RunsAfter(CameraSys);
+	RunsAfter(ObjectManagerSys);
 }
 
 void ImGUISystem::Initialize()
@@ -26,21 +42,28 @@ void ImGUISystem::Initialize()
 	// On initialization, create an ImGUI context
 	ImGui::CreateContext();
 
-	// Get the window system for window handle and opengl context
-	WindowSystem* windowSys = dynamic_cast<WindowSystem*>(GetParent()->GetSystem(WindowSys));
+	windowSys_ = GetParent()->Get<WindowSystem>();
+	objManSys_ = GetParent()->Get<ObjectManagerSystem>();
+	renderSys_ = GetParent()->Get<RenderSystem>();
+	inputSys_ = GetParent()->Get<InputSystem>();
+	camSys_ = GetParent()->Get<CameraSystem>();
+
+	// Get the window handle and opengl context from the window system
 	SDL_Window* handle = nullptr;
 	SDL_GLContext glCont = nullptr;
-	if (windowSys)
+	if (windowSys_)
 	{
-		handle = windowSys->GetWindowHandle();
-		glCont = windowSys->GetGLContext();
+		handle = windowSys_->GetWindowHandle();
+		glCont = windowSys_->GetGLContext();
 	}
 
 	// Initialize ImGUI with SDL
 	ImGui_ImplSDL2_InitForOpenGL(handle, glCont);
 
-	// Initialize OpenGL with ImGUI
+	// Initialize OpenGL with ImGUI. The device objects are made now so starting
+	// a frame never touches OpenGL, in case it is drawn on the render thread
 	ImGui_ImplOpenGL3_Init("#version 450");
+	ImGui_ImplOpenGL3_CreateDeviceObjects();
 }
 
 void ImGUISystem::Update(float dt)
@@ -50,14 +73,38 @@ void ImGUISystem::Update(float dt)
 	ImGui_ImplSDL2_NewFrame();
 	ImGui::NewFrame();
 
+	// Clicks that land on a window belong to it, the rest can select objects
+	PickObject();
+
 	// Call private functions here for rendering windows
 	DebugWindow(dt);
 	ObjectList();
 	SelectedObject();
+#ifdef DCK_PROFILE
+	ProfilerWindow();
+#endif
 
-	// Now to get it rendered
+	// Now to get it rendered. The render thread needs its own copy, since ImGui
+	// reuses its draw lists as soon as the next frame starts
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	FramePacket* packet = GetParent()->GetFramePacket();
+	if (GetParent()->IsRenderThreaded())
+		packet->CopyImGuiData(ImGui::GetDrawData());
+	else
+		packet->imGuiDrawData = ImGui::GetDrawData();
+}
+
+void ImGUISystem::Submit(FramePacket& packet)
+{
+	DCK_PROFILE_ZONE("ImGui Pass");
+	if (!packet.imGuiDrawData)
+		return;
+
+	if (renderSys_)
+		renderSys_->BeginPassTimer(RenderSystem::ImGuiPass);
+	ImGui_ImplOpenGL3_RenderDrawData(packet.imGuiDrawData);
+	if (renderSys_)
+		renderSys_->EndPassTimer();
 }
 
 void ImGUISystem::Shutdown()
@@ -73,6 +120,47 @@ void ImGUISystem::ProcessEvents(const SDL_Event* sdlEvent)
 	ImGui_ImplSDL2_ProcessEvent(sdlEvent);
 }
 
+//*****************************************************************************
+//  Description:
+//		Selects whatever object is under the mouse when the left button is
+//		clicked in the scene. The click is turned into a ray from the near
+//		plane to the far plane of the active camera, and cast at the objects.
+//		Clicking on nothing clears the selection
+//*****************************************************************************
+void ImGUISystem::PickObject()
+{
+	if (!inputSys_ || !camSys_ || !objManSys_ || !windowSys_)
+		return;
+	if (!inputSys_->LMIsTriggered() || ImGui::GetIO().WantCaptureMouse)
+		return;
+
+	Camera* activeCam = camSys_->GetActiveCamera();
+	int width, height;
+	windowSys_->GetWindowSize(&width, &height);
+	if (!activeCam || width <= 0 || height <= 0)
+		return;
+
+	DCK_PROFILE_ZONE("Pick Object");
+
+	// Mouse position in normalized device coordinates, y goes up instead of down
+	int mouseX, mouseY;
+	inputSys_->GetMouseScreenPos(&mouseX, &mouseY);
+	float ndcX = 2.0f * (mouseX + 0.5f) / width - 1.0f;
+	float ndcY = 1.0f - 2.0f * (mouseY + 0.5f) / height;
+
+	glm::mat4 clipToWorld = glm::inverse(activeCam->GetPerspMatrix() * activeCam->GetViewMatrix());
+	glm::vec4 nearPoint = clipToWorld * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+	glm::vec4 farPoint = clipToWorld * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+	glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+	glm::vec3 toFar = glm::vec3(farPoint) / farPoint.w - origin;
+
+	float length = glm::length(toFar);
+	if (length <= 0.0f)
+		return;
+
+	selectedObject_ = objManSys_->RayCast(origin, toFar / length, length);
+}
+
 void ImGUISystem::DebugWindow(float dt)
 {
 	// Calculate current frame rate
@@ -80,13 +168,27 @@ void ImGUISystem::DebugWindow(float dt)
 
 	// Render the debug information window
 	ImVec2 windowPos(0, 0);
-	ImVec2 windowSize(250, 50);
+	ImVec2 windowSize(250, 200);
 	ImGui::SetNextWindowPos(windowPos);
 	ImGui::SetNextWindowSize(windowSize);
 
 	// Print something
 	ImGui::Begin("Debug Info");
 	ImGui::Text("Frame Rate: %u", frameRate);
+
+	// Show how many state changes rendering took last frame
+	if (renderSys_)
+	{
+		RenderSystem::RenderStats stats = renderSys_->GetStats();
+		ImGui::Text("Objects: %d drawn, %d culled", stats.objectCount, stats.culledCount);
+		ImGui::Text("Draw Calls: %d, Triangles: %d", stats.drawCalls, stats.triangleCount);
+		ImGui::Text("VAO Binds: %d (unsorted %d)", stats.vaoBinds, stats.unsortedVaoBinds);
+		ImGui::Text("Shader Binds: %d", stats.shaderBinds);
+		ImGui::Text("Skipped Binds: %d, Uniforms: %d", stats.skippedBinds, stats.skippedUniforms);
+		ImGui::Text("Frame Arena: %zu KB, %d heap allocs", stats.arenaBytes / 1024, stats.heapAllocs);
+		ImGui::Text("GPU Main: %.2f ms", stats.gpuPassMs[RenderSystem::MainPass]);
+		ImGui::Text("GPU Debug: %.2f ms, ImGui: %.2f ms", stats.gpuPassMs[RenderSystem::DebugPass], stats.gpuPassMs[RenderSystem::ImGuiPass]);
+	}
 	prevWindowPos = ImGui::GetWindowPos();
 	prevWindowSize = ImGui::GetWindowSize();
 	ImGui::End();
@@ -94,14 +196,12 @@ void ImGUISystem::DebugWindow(float dt)
 
 void ImGUISystem::ObjectList()
 {
-	// Get the object manager system to see how many objects there are
-	ObjectManagerSystem* objManSys = dynamic_cast<ObjectManagerSystem*>(GetParent()->GetSystem(ObjectManagerSys));
-
-	if (objManSys)
+	// Use the object manager system to see how many objects there are
+	if (objManSys_)
 	{
 		// Get the object list and count of objects
-		RenderObject** objects = objManSys->GetAllObjects();
-		int objectCount = objManSys->GetCount();
+		RenderObject** objects = objManSys_->GetAllObjects();
+		int objectCount = objManSys_->GetCount();
 
 		// Calculate the size of the next window
 		ImVec2 nextWindowPos(prevWindowPos.x, prevWindowPos.y + prevWindowSize.y);
@@ -109,15 +209,21 @@ void ImGUISystem::ObjectList()
 		ImGui::SetNextWindowPos(nextWindowPos);
 		ImGui::SetNextWindowSize(nextWindowSize);
 
-		// Start creating the window
+		// Start creating the window. Only the buttons that fit in it are made
 		ImGui::Begin("Objects");
-		for (int i = 0; i < objectCount; ++i)
+		ImGuiListClipper clipper;
+		clipper.Begin(objectCount);
+		while (clipper.Step())
 		{
-			std::string buttonLabel = "Object #" + std::to_string(i+1) + " " + objects[i]->GetName();
-			if (objects[i] == currentObject_)
-				buttonLabel += " (Selected)";
-			if (ImGui::Button(buttonLabel.c_str()))
-				currentObject_ = objects[i];
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+			{
+				ObjectHandle handle = objManSys_->GetHandle(i);
+				std::string buttonLabel = "Object #" + std::to_string(i+1) + " " + objects[i]->GetName();
+				if (handle == selectedObject_)
+					buttonLabel += " (Selected)";
+				if (ImGui::Button(buttonLabel.c_str()))
+					selectedObject_ = handle;
+			}
 		}
 		prevWindowPos = ImGui::GetWindowPos();
 		prevWindowSize = ImGui::GetWindowSize();
@@ -127,15 +233,16 @@ void ImGUISystem::ObjectList()
 
 void ImGUISystem::SelectedObject()
 {
-	if (currentObject_)
+	// Nothing is shown once the selected object is gone
+	RenderObject* currentObject = objManSys_ ? objManSys_->GetObject(selectedObject_) : nullptr;
+	if (currentObject)
 	{
-		// Get the window system to figure out where this window will be
-		WindowSystem* windowSys = dynamic_cast<WindowSystem*>(GetParent()->GetSystem(WindowSys));
-		if (windowSys)
+		// Use the window system to figure out where this window will be
+		if (windowSys_)
 		{
 			// Get the window dimensions
 			int width, height;
-			windowSys->GetWindowSize(&width, &height);
+			windowSys_->GetWindowSize(&width, &height);
 
 			// Set the window's position and height
 			ImVec2 nextPos(width - 350, 0);
@@ -144,10 +251,10 @@ void ImGUISystem::SelectedObject()
 			ImGui::SetNextWindowSize(nextSize);
 
 			// Start creating the window
-			ImGui::Begin(currentObject_->GetName().c_str());
+			ImGui::Begin(currentObject->GetName().c_str());
 
 			// Start showing the position part of the object
-			glm::vec4 objPos = currentObject_->GetPosition();
+			glm::vec4 objPos = currentObject->GetPosition();
 			bool modified = false;
 			ImGui::Text("Position:");
 			if (ImGui::DragFloat("PosX", &objPos.x, 0.01f, INT_MIN, INT_MAX, "%.02f", 1.0f))
@@ -161,11 +268,11 @@ void ImGUISystem::SelectedObject()
 
 			if (modified)
 			{
-				currentObject_->SetPosition(objPos);
+				currentObject->SetPosition(objPos);
 			}
 
 			// Start showing the scale part of the object
-			glm::vec3 objScale = currentObject_->GetScale();
+			glm::vec3 objScale = currentObject->GetScale();
 			modified = false;
 			ImGui::Text("Scale:");
 			if (ImGui::DragFloat("ScaleX", &objScale.x, 0.01f, INT_MIN, INT_MAX, "%.02f", 1.0f))
@@ -177,7 +284,7 @@ void ImGUISystem::SelectedObject()
 
 			if (modified)
 			{
-				currentObject_->SetScale(objScale);
+				currentObject->SetScale(objScale);
 			}
 
 			//
@@ -185,18 +292,18 @@ void ImGUISystem::SelectedObject()
 			//
 
 			// Start showing the tint part of the object if the current mesh isn't a normal mesh
-			glm::vec3 tint = currentObject_->GetTint();
+			glm::vec3 tint = currentObject->GetTint();
 			float colors[3] = { tint.r, tint.g, tint.b };
 
 			ImGui::Text("Tint:");
 			if (ImGui::ColorEdit3("Tint Color", colors))
 			{
 				glm::vec3 newTint(colors[0], colors[1], colors[2]);
-				currentObject_->SetTint(newTint);
+				currentObject->SetTint(newTint);
 			}
 
 			// Show the diffuse coefficient of the object
-			glm::vec3 diffuse = currentObject_->GetDiffuse();
+			glm::vec3 diffuse = currentObject->GetDiffuse();
 			colors[0] = diffuse.r;
 			colors[1] = diffuse.g;
 			colors[2] = diffuse.b;
@@ -205,14 +312,14 @@ void ImGUISystem::SelectedObject()
 			if (ImGui::ColorEdit3("Diffuse Color", colors))
 			{
 				glm::vec3 newD(colors[0], colors[1], colors[2]);
-				currentObject_->SetDiffuse(newD);
+				currentObject->SetDiffuse(newD);
 			}
 
 			// Show the specular coefficient of the object
 			glm::vec3 specular;
 			float specularExp;
 			modified = false;
-			currentObject_->GetSpecular(&specular, &specularExp);
+			currentObject->GetSpecular(&specular, &specularExp);
 			colors[0] = specular.r;
 			colors[1] = specular.g;
 			colors[2] = specular.b;
@@ -225,7 +332,7 @@ void ImGUISystem::SelectedObject()
 			if (modified)
 			{
 				glm::vec3 newS(colors[0], colors[1], colors[2]);
-				currentObject_->SetSpecular(newS, specularExp);
+				currentObject->SetSpecular(newS, specularExp);
 			}
 
 			// End the window
@@ -234,6 +341,88 @@ void ImGUISystem::SelectedObject()
 	}
 }
 
+#ifdef DCK_PROFILE
+//*****************************************************************************
+//  Description:
+//		Shows the zones from the last profiled frame as bars along a timeline,
+//		one row per thread with nested zones stacked under their parent
+//*****************************************************************************
+void ImGUISystem::ProfilerWindow()
+{
+	Profiler* profiler = ProfilerGet();
+	const Profiler::Frame* frame = profiler->GetFrame(0);
+	if (!frame || !windowSys_)
+		return;
+
+	const float labelWidth = 110.0f;
+	const float barHeight = 18.0f;
+
+	// Start along the bottom of the screen
+	int width, height;
+	windowSys_->GetWindowSize(&width, &height);
+	ImGui::SetNextWindowPos(ImVec2(0, height - 220.0f), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowSize(ImVec2(static_cast<float>(width), 220.0f), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Profiler");
+
+	bool paused = profiler->IsPaused();
+	if (ImGui::Checkbox("Pause", &paused))
+		profiler->SetPaused(paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Save Trace"))
+		ProfilerSaveTrace("DckGfxTrace.json");
+	ImGui::SameLine();
+	double frameMs = profiler->ToMs(frame->end - frame->start);
+	ImGui::Text("Frame: %.2f ms, %u zones dropped", frameMs, profiler->GetDroppedCount());
+
+	// Find how deep each thread's zones go, so every row is tall enough
+	int threadCount = profiler->GetThreadCount();
+	std::vector<int> maxDepth(threadCount, 0);
+	for (const ProfileEvent& event : frame->events)
+		maxDepth[event.thread] = std::max(maxDepth[event.thread], event.depth);
+
+	std::vector<float> rowY(threadCount, 0.0f);
+	float totalHeight = 0.0f;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		rowY[i] = totalHeight;
+		totalHeight += (maxDepth[i] + 1) * barHeight + 4.0f;
+	}
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	float barWidth = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.0f);
+	float msToPixels = frameMs > 0.0 ? static_cast<float>(barWidth / frameMs) : 0.0f;
+
+	for (int i = 0; i < threadCount; ++i)
+		drawList->AddText(ImVec2(origin.x, origin.y + rowY[i]), IM_COL32(255, 255, 255, 255), profiler->GetThreadName(i));
+
+	// Zones from the render thread can start before the frame does, those are cut off at the start
+	ImVec2 mouse = ImGui::GetMousePos();
+	for (const ProfileEvent& event : frame->events)
+	{
+		float start = static_cast<float>(profiler->ToMs(event.start > frame->start ? event.start - frame->start : 0));
+		float end = static_cast<float>(profiler->ToMs(event.end > frame->start ? event.end - frame->start : 0));
+		ImVec2 min(origin.x + labelWidth + start * msToPixels, origin.y + rowY[event.thread] + event.depth * barHeight);
+		ImVec2 max(origin.x + labelWidth + std::min(end * msToPixels, barWidth), min.y + barHeight - 1.0f);
+		if (max.x - min.x < 1.0f)
+			max.x = min.x + 1.0f;
+
+		// Color by name so the same zone keeps its color between frames
+		unsigned int hash = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(event.name) >> 3) * 2654435761u;
+		drawList->AddRectFilled(min, max, ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.7f));
+		drawList->PushClipRect(min, max, true);
+		drawList->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(255, 255, 255, 255), event.name);
+		drawList->PopClipRect();
+
+		if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+			ImGui::SetTooltip("%s: %.3f ms", event.name, profiler->ToMs(event.end - event.start));
+	}
+	ImGui::Dummy(ImVec2(labelWidth + barWidth, totalHeight));
+
+	ImGui::End();
+}
+#endif
+
 ImGUISystem::~ImGUISystem()
 {
 
@@ -8,15 +8,24 @@
 
 #include "System.h"
 #include "RenderObject.h"
+#include "ObjectManagerSystem.h"
 #include "imgui/imgui.h"
 
+class WindowSystem;
+class RenderSystem;
+class InputSystem;
+class CameraSystem;
+
 class ImGUISystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::ImGUISys;
+
 	ImGUISystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
+	void Submit(FramePacket& packet) override;
 	void Shutdown() override;
 
 	void ProcessEvents(const SDL_Event* sdlEvent);
@@ -26,15 +35,26 @@ public:
 private:
 
 	// Private functions for ImGUI stuff
+	void PickObject();
 	void DebugWindow(float dt);
 	void ObjectList();
 	void SelectedObject();
+#ifdef DCK_PROFILE
+	void ProfilerWindow();
+#endif
 
 	// Previous window size and position for screen organization
 	ImVec2 prevWindowSize;
 	ImVec2 prevWindowPos;
 
-	// Currently Selected Object
-	RenderObject* currentObject_;
+	// Currently Selected Object, as a handle so it can't be used after the object is deleted
+	ObjectHandle selectedObject_;
+
+	// Systems this one uses, looked up once in Initialize
+	WindowSystem* windowSys_;
+	ObjectManagerSystem* objManSys_;
+	RenderSystem* renderSys_;
+	InputSystem* inputSys_;
+	CameraSystem* camSys_;
 
 };
\ No newline at end of file
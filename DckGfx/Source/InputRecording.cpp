@@ -0,0 +1,223 @@
+//*****************************************************************************
+//	File:   InputRecording.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Versioned binary input recording format (.dinput). Keeps the
+//		key and mouse state and the time step of every frame, so a run can be
+//		played back exactly the same way for repeatable perf runs
+//*****************************************************************************
+
+#include "InputRecording.h"
+#include <cstring>
+#include <iostream>
+
+// Bytes for the dt, mouse position, mouse buttons and key change count at the start of every frame
+static const size_t frameFixedBytes = sizeof(float) + 2 * sizeof(int16_t) + sizeof(uint8_t) + sizeof(uint16_t);
+
+// Where the state goes in a packed key change
+static const int keyStateShift = 14;
+static const uint16_t keyScancodeMask = (1 << keyStateShift) - 1;
+
+InputRecorder::InputRecorder() :
+	file_(),
+	frameBytes_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts a new recording, replacing anything already at the path
+//
+//	Param filepath:
+//		Where to write the recording
+//
+//	Return:
+//		Returns true if the file was opened
+//*****************************************************************************
+bool InputRecorder::Open(const char* filepath)
+{
+	Close();
+
+	file_.open(filepath, std::ios::binary | std::ios::trunc);
+	if (!file_.is_open())
+	{
+		std::cout << "Failed to open input recording for writing: " << filepath << std::endl;
+		return false;
+	}
+
+	DInputHeader header = DInputHeader();
+	memcpy(header.magic, dinputMagic, sizeof(dinputMagic));
+	header.version = dinputVersion;
+
+	file_.write(reinterpret_cast<const char*>(&header), sizeof(DInputHeader));
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a frame to the end of the recording
+//
+//	Param frame:
+//		The frame's input
+//*****************************************************************************
+void InputRecorder::WriteFrame(const InputFrame& frame)
+{
+	if (!file_.is_open())
+		return;
+
+	uint16_t changeCount = static_cast<uint16_t>(frame.keyChanges.size());
+	frameBytes_.resize(frameFixedBytes + changeCount * sizeof(uint16_t));
+	char* bytes = frameBytes_.data();
+
+	int16_t mouse[2] = { static_cast<int16_t>(frame.mouseX), static_cast<int16_t>(frame.mouseY) };
+	uint8_t buttons = static_cast<uint8_t>((frame.leftMouse & 3) | ((frame.rightMouse & 3) << 2));
+	memcpy(bytes, &frame.dt, sizeof(float));
+	bytes += sizeof(float);
+	memcpy(bytes, mouse, sizeof(mouse));
+	bytes += sizeof(mouse);
+	memcpy(bytes, &buttons, sizeof(uint8_t));
+	bytes += sizeof(uint8_t);
+	memcpy(bytes, &changeCount, sizeof(uint16_t));
+	bytes += sizeof(uint16_t);
+
+	for (uint16_t i = 0; i < changeCount; ++i)
+	{
+		const InputKeyChange& change = frame.keyChanges[i];
+		uint16_t packed = static_cast<uint16_t>((change.scancode & keyScancodeMask) | ((change.state & 3) << keyStateShift));
+		memcpy(bytes, &packed, sizeof(uint16_t));
+		bytes += sizeof(uint16_t);
+	}
+
+	file_.write(frameBytes_.data(), static_cast<std::streamsize>(frameBytes_.size()));
+}
+
+void InputRecorder::Close()
+{
+	if (file_.is_open())
+		file_.close();
+}
+
+bool InputRecorder::IsOpen()
+{
+	return file_.is_open();
+}
+
+InputRecorder::~InputRecorder()
+{
+	Close();
+}
+
+InputPlayer::InputPlayer() :
+	file_(),
+	frameBytes_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Opens a recording to be played back from the first frame
+//
+//	Param filepath:
+//		The recording to read
+//
+//	Return:
+//		Returns true if the file was opened and is a recording this version
+//		can read
+//*****************************************************************************
+bool InputPlayer::Open(const char* filepath)
+{
+	Close();
+
+	file_.open(filepath, std::ios::binary);
+	if (!file_.is_open())
+	{
+		std::cout << "Failed to open input recording: " << filepath << std::endl;
+		return false;
+	}
+
+	DInputHeader header = DInputHeader();
+	file_.read(reinterpret_cast<char*>(&header), sizeof(DInputHeader));
+	if (!file_ || memcmp(header.magic, dinputMagic, sizeof(dinputMagic)) != 0 || header.version != dinputVersion)
+	{
+		std::cout << "Not a supported input recording: " << filepath << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Reads the next frame of the recording
+//
+//	Param frame:
+//		Filled in with the frame's input
+//
+//	Return:
+//		Returns false once there are no whole frames left
+//*****************************************************************************
+bool InputPlayer::ReadFrame(InputFrame* frame)
+{
+	if (!file_.is_open())
+		return false;
+
+	frameBytes_.resize(frameFixedBytes);
+	file_.read(frameBytes_.data(), static_cast<std::streamsize>(frameFixedBytes));
+	if (!file_)
+		return false;
+
+	const char* bytes = frameBytes_.data();
+	int16_t mouse[2];
+	uint8_t buttons;
+	uint16_t changeCount;
+	memcpy(&frame->dt, bytes, sizeof(float));
+	bytes += sizeof(float);
+	memcpy(mouse, bytes, sizeof(mouse));
+	bytes += sizeof(mouse);
+	memcpy(&buttons, bytes, sizeof(uint8_t));
+	bytes += sizeof(uint8_t);
+	memcpy(&changeCount, bytes, sizeof(uint16_t));
+
+	frame->mouseX = mouse[0];
+	frame->mouseY = mouse[1];
+	frame->leftMouse = buttons & 3;
+	frame->rightMouse = (buttons >> 2) & 3;
+
+	frameBytes_.resize(changeCount * sizeof(uint16_t));
+	if (changeCount > 0)
+	{
+		file_.read(frameBytes_.data(), static_cast<std::streamsize>(frameBytes_.size()));
+		if (!file_)
+			return false;
+	}
+
+	frame->keyChanges.resize(changeCount);
+	bytes = frameBytes_.data();
+	for (uint16_t i = 0; i < changeCount; ++i)
+	{
+		uint16_t packed;
+		memcpy(&packed, bytes, sizeof(uint16_t));
+		bytes += sizeof(uint16_t);
+		frame->keyChanges[i].scancode = packed & keyScancodeMask;
+		frame->keyChanges[i].state = static_cast<uint8_t>(packed >> keyStateShift);
+	}
+	return true;
+}
+
+void InputPlayer::Close()
+{
+	if (file_.is_open())
+		file_.close();
+	file_.clear();
+}
+
+bool InputPlayer::IsOpen()
+{
+	return file_.is_open();
+}
+
+InputPlayer::~InputPlayer()
+{
+	Close();
+}
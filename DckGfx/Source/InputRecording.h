@@ -0,0 +1,118 @@
+#pragma once
+//*****************************************************************************
+//	File:   InputRecording.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Versioned binary input recording format (.dinput). Keeps the
+//		key and mouse state and the time step of every frame, so a run can be
+//		played back exactly the same way for repeatable perf runs
+//*****************************************************************************
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+// Magic and version of .dinput files
+static const char dinputMagic[4] = { 'D', 'I', 'N', 'P' };
+static const uint32_t dinputVersion = 2;
+
+//*****************************************************************************
+//  Description:
+//		Header at the start of every .dinput file, followed by the frames. A
+//		frame is its dt as a float, the mouse position as two int16s, the
+//		left and right mouse button states packed two bits each into a byte,
+//		then a uint16 count of key changes and a uint16 for each change. A
+//		change is the scancode in the low 14 bits and its new state in the
+//		top two
+//*****************************************************************************
+struct DInputHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t reserved[2];
+};
+
+//*****************************************************************************
+//  Description:
+//		A key that was pressed or let go during a frame, and the state it was
+//		left in. States are the values of InputSystem::KeyState
+//*****************************************************************************
+struct InputKeyChange {
+	uint16_t scancode;
+	uint8_t state;
+};
+
+//*****************************************************************************
+//  Description:
+//		The input of a single frame. Keys that aren't in the changes just
+//		move on from triggered to down and from released to none, which is
+//		what keeps recordings small
+//*****************************************************************************
+struct InputFrame {
+	float dt;
+	int mouseX;
+	int mouseY;
+	uint8_t leftMouse;
+	uint8_t rightMouse;
+	std::vector<InputKeyChange> keyChanges;
+
+	InputFrame() :
+		dt(0.0f),
+		mouseX(0),
+		mouseY(0),
+		leftMouse(0),
+		rightMouse(0),
+		keyChanges()
+	{}
+};
+
+//*****************************************************************************
+//  Description:
+//		Writes frames of input to a .dinput file as they happen
+//*****************************************************************************
+class InputRecorder {
+public:
+
+	InputRecorder();
+
+	bool Open(const char* filepath);
+	void WriteFrame(const InputFrame& frame);
+	void Close();
+
+	bool IsOpen();
+
+	~InputRecorder();
+
+private:
+
+	std::ofstream file_;
+
+	// Reused for every frame, so writing doesn't allocate
+	std::vector<char> frameBytes_;
+
+};
+
+//*****************************************************************************
+//  Description:
+//		Reads frames of input back out of a .dinput file
+//*****************************************************************************
+class InputPlayer {
+public:
+
+	InputPlayer();
+
+	bool Open(const char* filepath);
+	bool ReadFrame(InputFrame* frame);
+	void Close();
+
+	bool IsOpen();
+
+	~InputPlayer();
+
+private:
+
+	std::ifstream file_;
+
+	// Reused for every frame, so reading doesn't allocate
+	std::vector<char> frameBytes_;
+
+};
@@ -9,78 +9,83 @@
 #include "WindowSystem.h"
 #include "ImGUISystem.h"
 #include "Engine.h"
+#include <stdexcept>
 
-typedef std::pair<SDL_Keycode, InputSystem::KeyState> Key;
-
-InputSystem::InputSystem() : System(SysType::InputSys),
+InputSystem::InputSystem() : System(Type),
 inputEvent_(),
-inputMap_(),
+keys_(),
+changedKeys_(),
 mouseX_(0),
 mouseY_(0),
 mouseMask_(0),
 leftMouse_(KeyState::None),
-rightMouse_(KeyState::None)
+rightMouse_(KeyState::None),
+recorder_(),
+player_(),
+frame_(),
+hasReplayFrame_(false),
+imGuiSys_(nullptr),
+windowSys_(nullptr)
 {
+	// Events come in for the window that was just swapped
+	RunsAfter(WindowSys);
 }
 
 void InputSystem::Initialize()
 {
-	// Create the keys we want to be read
-	Key wKey(SDLK_w, KeyState::None);
-	Key aKey(SDLK_a, KeyState::None);
-	Key sKey(SDLK_s, KeyState::None);
-	Key dKey(SDLK_d, KeyState::None);
+	imGuiSys_ = GetParent()->Get<ImGUISystem>();
+	windowSys_ = GetParent()->Get<WindowSystem>();
 
-	Key upKey(SDLK_UP, KeyState::None);
-	Key leftKey(SDLK_LEFT, KeyState::None);
-	Key rightKey(SDLK_RIGHT, KeyState::None);
-	Key downKey(SDLK_DOWN, KeyState::None);
+	// Plenty for a frame of typing, so pressing keys never allocates
+	changedKeys_.reserve(64);
 
-	Key f1Key(SDLK_F1, KeyState::None);
-	Key f2Key(SDLK_F2, KeyState::None);
-	Key f3Key(SDLK_F3, KeyState::None);
-	Key f4Key(SDLK_F4, KeyState::None);
+	const EngineConfig& config = GetParent()->GetConfig();
+	if (config.replayInputPath && !player_.Open(config.replayInputPath))
+		throw std::runtime_error("Failed to open input recording");
 
-	// Add the keys to the input map
-	inputMap_.insert(wKey);
-	inputMap_.insert(aKey);
-	inputMap_.insert(sKey);
-	inputMap_.insert(dKey);
+	if (config.recordInputPath && !recorder_.Open(config.recordInputPath))
+		throw std::runtime_error("Failed to open input recording");
+}
 
-	inputMap_.insert(upKey);
-	inputMap_.insert(leftKey);
-	inputMap_.insert(rightKey);
-	inputMap_.insert(downKey);
+//*****************************************************************************
+//  Description:
+//		Starts a frame before any system updates. When replaying, this reads
+//		the next recorded frame, and stops the engine once there are none left
+//
+//	Param dt:
+//		Delta time the frame would run with
+//
+//	Return:
+//		Returns the dt the frame was recorded with when replaying, or the
+//		given dt otherwise
+//*****************************************************************************
+float InputSystem::BeginFrame(float dt)
+{
+	if (!player_.IsOpen())
+		return dt;
 
-	inputMap_.insert(f1Key);
-	inputMap_.insert(f2Key);
-	inputMap_.insert(f3Key);
-	inputMap_.insert(f4Key);
+	hasReplayFrame_ = player_.ReadFrame(&frame_);
+	if (!hasReplayFrame_)
+	{
+		GetParent()->SetIsRunning(false);
+		return dt;
+	}
+	return frame_.dt;
 }
 
 void InputSystem::Update(float dt)
 {
-	// Update any keys that are triggered or released
-	for (auto& itr : inputMap_)
+	// Replays take everything from the recording, so nothing live can change the run
+	if (player_.IsOpen())
 	{
-		switch (itr.second)
-		{
-			// If the key was triggered, it is now down
-		case KeyState::Triggered:
-			itr.second = KeyState::Down;
-			break;
-
-			// If the key was released, it is now none
-		case KeyState::Released:
-			itr.second = KeyState::None;
-			break;
-
-			// Default case
-		default:
-			break;
-		}
+		PollReplayEvents();
+		ApplyReplayFrame();
+		return;
 	}
 
+	// Update any keys that are triggered or released
+	AgeKeys();
+
 	switch (leftMouse_)
 	{
 		case KeyState::Triggered:
@@ -105,15 +110,13 @@ void InputSystem::Update(float dt)
 			break;
 	}
 
-	// Get the ImGUI system and process inputs from SDL
-	ImGUISystem* imGuiSys = dynamic_cast<ImGUISystem*>(GetParent()->GetSystem(ImGUISys));
-
+	// Process inputs from SDL, letting ImGUI see them too
 	// Loop for processing all input events
 	while (SDL_PollEvent(&inputEvent_))
 	{
 		// Process events for ImGUI
-		if (imGuiSys)
-			imGuiSys->ProcessEvents(&inputEvent_);
+		if (imGuiSys_)
+			imGuiSys_->ProcessEvents(&inputEvent_);
 
 		// Check for the quit event
 		if (inputEvent_.type == SDL_QUIT)
@@ -139,68 +142,87 @@ void InputSystem::Update(float dt)
 			case SDL_WINDOWEVENT:
 				if (inputEvent_.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
 				{
-					WindowSystem* windowSys = dynamic_cast<WindowSystem*>(GetParent()->GetSystem(WindowSys));
-					if (windowSys)
-						windowSys->UpdateWindowSize(inputEvent_.window.data1, inputEvent_.window.data2);
+					if (windowSys_)
+						windowSys_->UpdateWindowSize(inputEvent_.window.data1, inputEvent_.window.data2);
 				}
 				break;
 		}
 
-		// Otherwise, check that the current key is being checked for input
-		SDL_Keycode currentKey = inputEvent_.key.keysym.sym;
-		auto result = inputMap_.find(currentKey);
-		if (result != inputMap_.end())
+		// Otherwise, update the key the event is for. Repeats from holding a key down
+		// don't trigger it again
+		switch (inputEvent_.type)
 		{
-			switch (inputEvent_.type)
-			{
-				// If the event is keydown, the key is now triggered
-				case SDL_KEYDOWN:
-					result->second = KeyState::Triggered;
-					break;
-
-				// If the event is keyup, the key is now released
-				case SDL_KEYUP:
-					result->second = KeyState::Released;
-					break;
-
-				// Default case
-				default:
-					break;
-			}
+			// If the event is keydown, the key is now triggered
+			case SDL_KEYDOWN:
+				if (!inputEvent_.key.repeat)
+					SetKey(inputEvent_.key.keysym.scancode, KeyState::Triggered);
+				break;
+
+			// If the event is keyup, the key is now released
+			case SDL_KEYUP:
+				SetKey(inputEvent_.key.keysym.scancode, KeyState::Released);
+				break;
+
+			// Default case
+			default:
+				break;
 		}
 	}
+
+	// The mouse position is kept once per frame, so it can be recorded and read off the main thread
+	SDL_GetMouseState(&mouseX_, &mouseY_);
+
+	if (recorder_.IsOpen())
+		RecordFrame(dt);
 }
 
 void InputSystem::Shutdown()
 {
-	inputMap_.clear();
+	recorder_.Close();
+	player_.Close();
+
+	for (KeyState& key : keys_)
+		key = KeyState::None;
+	changedKeys_.clear();
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if input is coming from a recording instead of SDL
+//*****************************************************************************
+bool InputSystem::IsReplaying()
+{
+	return player_.IsOpen();
 }
 
 bool InputSystem::KeyIsTriggered(SDL_Keycode key)
 {
-	auto keyItr = inputMap_.find(key);
-	if (keyItr != inputMap_.end())
-		if (keyItr->second == KeyState::Triggered)
-			return true;
-	return false;
+	return KeyIsTriggered(SDL_GetScancodeFromKey(key));
 }
 
 bool InputSystem::KeyIsDown(SDL_Keycode key)
 {
-	auto keyItr = inputMap_.find(key);
-	if (keyItr != inputMap_.end())
-		if (keyItr->second == KeyState::Down)
-			return true;
-	return false;
+	return KeyIsDown(SDL_GetScancodeFromKey(key));
 }
 
 bool InputSystem::KeyIsReleased(SDL_Keycode key)
 {
-	auto keyItr = inputMap_.find(key);
-	if (keyItr != inputMap_.end())
-		if (keyItr->second == KeyState::Released)
-			return true;
-	return false;
+	return KeyIsReleased(SDL_GetScancodeFromKey(key));
+}
+
+bool InputSystem::KeyIsTriggered(SDL_Scancode key)
+{
+	return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && keys_[key] == KeyState::Triggered;
+}
+
+bool InputSystem::KeyIsDown(SDL_Scancode key)
+{
+	return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && keys_[key] == KeyState::Down;
+}
+
+bool InputSystem::KeyIsReleased(SDL_Scancode key)
+{
+	return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && keys_[key] == KeyState::Released;
 }
 
 bool InputSystem::LMIsTriggered()
@@ -235,7 +257,125 @@ bool InputSystem::RMIsReleased()
 
 void InputSystem::GetMouseScreenPos(int* x, int* y)
 {
-	SDL_GetMouseState(x, y);
+	*x = mouseX_;
+	*y = mouseY_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Moves the keys that were triggered last frame to down, and the ones
+//		that were released to none. Only keys that changed are looked at
+//*****************************************************************************
+void InputSystem::AgeKeys()
+{
+	for (SDL_Scancode key : changedKeys_)
+	{
+		switch (keys_[key])
+		{
+			// If the key was triggered, it is now down
+			case KeyState::Triggered:
+				keys_[key] = KeyState::Down;
+				break;
+
+			// If the key was released, it is now none
+			case KeyState::Released:
+				keys_[key] = KeyState::None;
+				break;
+
+			// Default case
+			default:
+				break;
+		}
+	}
+	changedKeys_.clear();
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets a key's state and keeps it to be aged next frame
+//
+//	Param key:
+//		Scancode of the key, ignored if it is out of range
+//
+//	Param state:
+//		The key's new state
+//*****************************************************************************
+void InputSystem::SetKey(SDL_Scancode key, KeyState state)
+{
+	if (key <= SDL_SCANCODE_UNKNOWN || key >= SDL_NUM_SCANCODES)
+		return;
+
+	keys_[key] = state;
+	changedKeys_.push_back(key);
+}
+
+//*****************************************************************************
+//  Description:
+//		Empties SDL's event queue while replaying. Closing and resizing the
+//		window still work, but key and mouse events are thrown away
+//*****************************************************************************
+void InputSystem::PollReplayEvents()
+{
+	while (SDL_PollEvent(&inputEvent_))
+	{
+		if (inputEvent_.type == SDL_QUIT)
+			GetParent()->SetIsRunning(false);
+		else if (inputEvent_.type == SDL_WINDOWEVENT && inputEvent_.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			if (windowSys_)
+				windowSys_->UpdateWindowSize(inputEvent_.window.data1, inputEvent_.window.data2);
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets every key and button to its state in the frame read by
+//		BeginFrame. Keys age the same way they do live, then the recorded
+//		changes go on top
+//*****************************************************************************
+void InputSystem::ApplyReplayFrame()
+{
+	AgeKeys();
+	if (!hasReplayFrame_)
+		return;
+
+	mouseX_ = frame_.mouseX;
+	mouseY_ = frame_.mouseY;
+	leftMouse_ = static_cast<KeyState>(frame_.leftMouse);
+	rightMouse_ = static_cast<KeyState>(frame_.rightMouse);
+
+	for (const InputKeyChange& change : frame_.keyChanges)
+		SetKey(static_cast<SDL_Scancode>(change.scancode), static_cast<KeyState>(change.state));
+}
+
+//*****************************************************************************
+//  Description:
+//		Writes this frame's input to the recording. Aging already happened,
+//		so the changed keys are just the ones this frame's events set, and
+//		they're recorded in the state the other systems will see them in
+//
+//	Param dt:
+//		Delta time the frame ran with
+//*****************************************************************************
+void InputSystem::RecordFrame(float dt)
+{
+	frame_.dt = dt;
+	frame_.mouseX = mouseX_;
+	frame_.mouseY = mouseY_;
+	frame_.leftMouse = static_cast<uint8_t>(leftMouse_);
+	frame_.rightMouse = static_cast<uint8_t>(rightMouse_);
+
+	frame_.keyChanges.clear();
+	for (SDL_Scancode key : changedKeys_)
+	{
+		InputKeyChange change;
+		change.scancode = static_cast<uint16_t>(key);
+		change.state = static_cast<uint8_t>(keys_[key]);
+		frame_.keyChanges.push_back(change);
+	}
+
+	recorder_.WriteFrame(frame_);
 }
 
 InputSystem::~InputSystem()
@@ -7,8 +7,12 @@
 //*****************************************************************************
 
 #include "System.h"
+#include "InputRecording.h"
 #include "SDL2/SDL.h"
-#include <map>
+#include <vector>
+
+class ImGUISystem;
+class WindowSystem;
 
 class InputSystem : public System {
 public:
@@ -20,16 +24,26 @@ public:
 		Released
 	};
 
+	static constexpr SysType Type = SysType::InputSys;
+
 	InputSystem();
 
 	void Initialize() override;
+	float BeginFrame(float dt);
 	void Update(float dt) override;
 	void Shutdown() override;
 
+	bool IsReplaying();
+
 	bool KeyIsTriggered(SDL_Keycode key);
 	bool KeyIsDown(SDL_Keycode key);
 	bool KeyIsReleased(SDL_Keycode key);
 
+	// Scancodes are the physical key no matter the keyboard layout, and skip the keymap lookup
+	bool KeyIsTriggered(SDL_Scancode key);
+	bool KeyIsDown(SDL_Scancode key);
+	bool KeyIsReleased(SDL_Scancode key);
+
 	bool LMIsTriggered();
 	bool LMIsDown();
 	bool LMIsReleased();
@@ -45,11 +59,35 @@ public:
 private:
 
 	SDL_Event inputEvent_;
-	std::map<SDL_Keycode, KeyState> inputMap_;
+
+	// State of every key by scancode, and the keys that were triggered or released this frame.
+	// Only those need to move on to down or none next frame, so aging costs nothing for keys
+	// that didn't change
+	KeyState keys_[SDL_NUM_SCANCODES];
+	std::vector<SDL_Scancode> changedKeys_;
+
+	void AgeKeys();
+	void SetKey(SDL_Scancode key, KeyState state);
 
 	int mouseX_, mouseY_;
 	Uint8 mouseMask_;
 
 	KeyState leftMouse_;
 	KeyState rightMouse_;
+
+	void PollReplayEvents();
+	void ApplyReplayFrame();
+	void RecordFrame(float dt);
+
+	// Recording of every frame's input, or the recording being played back instead of SDL.
+	// Replayed frames are read in BeginFrame and applied in Update
+	InputRecorder recorder_;
+	InputPlayer player_;
+	InputFrame frame_;
+	bool hasReplayFrame_;
+
+	// Systems this one uses, looked up once in Initialize
+	ImGUISystem* imGuiSys_;
+	WindowSystem* windowSys_;
+
 };
\ No newline at end of file
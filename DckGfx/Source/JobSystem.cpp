@@ -0,0 +1,338 @@
+//*****************************************************************************
+//	File:   JobSystem.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Work stealing thread pool. Every thread has its own queue of
+//		jobs, and threads that run out of work take jobs from the others
+//*****************************************************************************
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+
+// Which queue the current thread pushes to and pops from first
+static thread_local unsigned int threadQueue = 0;
+
+// Jobs a queue has room for when it first needs any
+static const size_t minQueueSize = 64;
+
+JobSystem::JobSystem() :
+	queues_(),
+	workers_(),
+	sleepMutex_(),
+	jobReady_(),
+	queuedCount_(0),
+	stopping_(false)
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts up the worker threads
+//
+//	Param workerCount:
+//		How many workers to start. Zero uses one less than the core count so
+//		the main thread keeps a core to itself
+//*****************************************************************************
+void JobSystem::Initialize(unsigned int workerCount)
+{
+	if (workerCount == 0)
+	{
+		unsigned int coreCount = std::thread::hardware_concurrency();
+		workerCount = coreCount > 1 ? coreCount - 1 : 0;
+	}
+
+	stopping_ = false;
+	for (unsigned int i = 0; i <= workerCount; ++i)
+		queues_.push_back(new JobQueue());
+
+	for (unsigned int i = 1; i <= workerCount; ++i)
+		workers_.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+//*****************************************************************************
+//  Description:
+//		Stops the workers. Jobs that never got run are thrown away
+//*****************************************************************************
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stopping_ = true;
+	}
+	jobReady_.notify_all();
+
+	for (std::thread& worker : workers_)
+		worker.join();
+	workers_.clear();
+
+	for (JobQueue* queue : queues_)
+		delete queue;
+	queues_.clear();
+	queuedCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Queues a job to be run by any thread
+//
+//	Param job:
+//		The function to run
+//
+//	Param counter:
+//		Counter that goes up now and back down once the job is done, can be
+//		nullptr if nothing needs to wait on the job
+//*****************************************************************************
+void JobSystem::Run(std::function<void()> job, JobCounter* counter)
+{
+	if (counter)
+		++(*counter);
+
+	// Nothing to queue it on before initializing, so just run it
+	if (queues_.empty())
+	{
+		Job now{ std::move(job), counter };
+		RunJob(now);
+		return;
+	}
+
+	JobQueue* queue = queues_[threadQueue < queues_.size() ? threadQueue : 0];
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->PushBack(Job{ std::move(job), counter });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		++queuedCount_;
+	}
+	jobReady_.notify_one();
+}
+
+//*****************************************************************************
+//  Description:
+//		Waits for every job on a counter to finish. The waiting thread runs
+//		other jobs in the meantime instead of sitting idle
+//
+//	Param counter:
+//		The counter the jobs were started with
+//*****************************************************************************
+void JobSystem::Wait(JobCounter* counter)
+{
+	while (*counter > 0)
+	{
+		if (!RunPendingJob())
+			std::this_thread::yield();
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Runs one queued job on the calling thread, if there are any
+//
+//	Return:
+//		Returns true if a job was run
+//*****************************************************************************
+bool JobSystem::RunPendingJob()
+{
+	Job job;
+	if (queues_.empty() || !PopJob(threadQueue < queues_.size() ? threadQueue : 0, job))
+		return false;
+
+	RunJob(job);
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Splits a range into batches and runs them across all the threads,
+//		including the calling one. Returns once the whole range is done
+//
+//	Param count:
+//		How many items are in the range
+//
+//	Param batchSize:
+//		Fewest items a single job handles, so tiny jobs don't cost more than
+//		the work in them
+//
+//	Param func:
+//		Function called with the beginning and end of each batch
+//*****************************************************************************
+void JobSystem::ParallelFor(int count, int batchSize, const std::function<void(int, int)>& func)
+{
+	if (count <= 0)
+		return;
+
+	// Aim for a few batches per thread so threads that finish early can steal the rest
+	int threadCount = static_cast<int>(GetThreadCount());
+	batchSize = std::max(batchSize, (count + threadCount * 4 - 1) / (threadCount * 4));
+	if (threadCount == 1 || count <= batchSize)
+	{
+		func(0, count);
+		return;
+	}
+
+	JobCounter counter(0);
+	for (int begin = batchSize; begin < count; begin += batchSize)
+	{
+		int end = std::min(begin + batchSize, count);
+		Run([&func, begin, end]() { func(begin, end); }, &counter);
+	}
+
+	// The calling thread takes the first batch itself, then helps with the rest
+	func(0, batchSize);
+	Wait(&counter);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many threads run jobs, the workers plus the main thread
+//*****************************************************************************
+unsigned int JobSystem::GetThreadCount()
+{
+	return static_cast<unsigned int>(workers_.size()) + 1;
+}
+
+JobSystem::~JobSystem()
+{
+	if (!queues_.empty())
+		Shutdown();
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes a job for a thread. Newest jobs come off of its own queue first
+//		since they are most likely still in cache, otherwise the oldest job is
+//		stolen from another queue
+//
+//	Param queueIndex:
+//		The queue that belongs to the thread
+//
+//	Param job:
+//		Filled in with the job that was taken
+//
+//	Return:
+//		Returns true if a job was found
+//*****************************************************************************
+bool JobSystem::PopJob(unsigned int queueIndex, Job& job)
+{
+	if (queuedCount_ <= 0)
+		return false;
+
+	JobQueue* own = queues_[queueIndex];
+	{
+		std::lock_guard<std::mutex> lock(own->mutex);
+		if (own->PopBack(job))
+		{
+			--queuedCount_;
+			return true;
+		}
+	}
+
+	unsigned int queueCount = static_cast<unsigned int>(queues_.size());
+	for (unsigned int i = 1; i < queueCount; ++i)
+	{
+		JobQueue* victim = queues_[(queueIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (victim->PopFront(job))
+		{
+			--queuedCount_;
+			return true;
+		}
+	}
+	return false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Runs a job and marks it as finished on its counter
+//*****************************************************************************
+void JobSystem::RunJob(Job& job)
+{
+	job.func();
+	if (job.counter)
+		--(*job.counter);
+}
+
+//*****************************************************************************
+//  Description:
+//		Worker thread loop. Runs jobs until there are none left anywhere, then
+//		sleeps until more get queued
+//
+//	Param queueIndex:
+//		The queue that belongs to this worker
+//*****************************************************************************
+void JobSystem::WorkerLoop(unsigned int queueIndex)
+{
+	threadQueue = queueIndex;
+	DCK_PROFILE_THREAD("Job Worker");
+	while (true)
+	{
+		Job job;
+		if (PopJob(queueIndex, job))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		jobReady_.wait(lock, [this]() { return stopping_ || queuedCount_ > 0; });
+		if (stopping_)
+			return;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a job to the back of the queue. A full queue doubles in size,
+//		with the jobs moved to the start of the new ring in order
+//*****************************************************************************
+void JobSystem::JobQueue::PushBack(Job&& job)
+{
+	if (count == jobs.size())
+	{
+		std::vector<Job> grown(std::max(minQueueSize, jobs.size() * 2));
+		for (size_t i = 0; i < count; ++i)
+			grown[i] = std::move(jobs[(first + i) % jobs.size()]);
+		jobs.swap(grown);
+		first = 0;
+	}
+
+	jobs[(first + count) % jobs.size()] = std::move(job);
+	++count;
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes the newest job off the queue
+//
+//	Return:
+//		Returns false if the queue was empty
+//*****************************************************************************
+bool JobSystem::JobQueue::PopBack(Job& job)
+{
+	if (count == 0)
+		return false;
+
+	--count;
+	job = std::move(jobs[(first + count) % jobs.size()]);
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes the oldest job off the queue
+//
+//	Return:
+//		Returns false if the queue was empty
+//*****************************************************************************
+bool JobSystem::JobQueue::PopFront(Job& job)
+{
+	if (count == 0)
+		return false;
+
+	job = std::move(jobs[first]);
+	first = (first + 1) % jobs.size();
+	--count;
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+//*****************************************************************************
+//	File:   JobSystem.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Work stealing thread pool. Every thread has its own queue of
+//		jobs, and threads that run out of work take jobs from the others
+//*****************************************************************************
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts jobs that haven't finished yet, so they can be waited on as a group
+typedef std::atomic<int> JobCounter;
+
+class JobSystem {
+public:
+
+	JobSystem();
+
+	void Initialize(unsigned int workerCount = 0);
+	void Shutdown();
+
+	void Run(std::function<void()> job, JobCounter* counter = nullptr);
+	void Wait(JobCounter* counter);
+	bool RunPendingJob();
+
+	void ParallelFor(int count, int batchSize, const std::function<void(int, int)>& func);
+
+	unsigned int GetThreadCount();
+
+	~JobSystem();
+
+private:
+
+	struct Job {
+		std::function<void()> func;
+		JobCounter* counter;
+	};
+
+	// Queue of jobs owned by a thread. The owner works from the back, thieves take from the front.
+	// Kept as a ring that only grows, so once it is big enough queueing jobs doesn't allocate
+	struct JobQueue {
+		std::mutex mutex;
+		std::vector<Job> jobs;
+		size_t first;
+		size_t count;
+
+		JobQueue() : mutex(), jobs(), first(0), count(0) {}
+
+		void PushBack(Job&& job);
+		bool PopBack(Job& job);
+		bool PopFront(Job& job);
+	};
+
+	// Not copyable, the worker threads point back at it
+	JobSystem(const JobSystem&);
+	JobSystem& operator=(const JobSystem&);
+
+	bool PopJob(unsigned int queueIndex, Job& job);
+	void RunJob(Job& job);
+	void WorkerLoop(unsigned int queueIndex);
+
+	// One queue per thread, the first one belongs to the main thread (and any thread that isn't a worker)
+	std::vector<JobQueue*> queues_;
+	std::vector<std::thread> workers_;
+
+	// Workers sleep on this while there is nothing queued anywhere
+	std::mutex sleepMutex_;
+	std::condition_variable jobReady_;
+	std::atomic<int> queuedCount_;
+	bool stopping_;
+
+};
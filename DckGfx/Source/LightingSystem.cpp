@@ -7,21 +7,25 @@
 //*****************************************************************************
 
 #include "Engine.h"
-#include "CameraSystem.h"
 #include "LightingSystem.h"
 #include "GraphicsSystem.h"
 #include "RenderSystem.h"
 #include "ShaderLib.h"
 
-LightingSystem::LightingSystem() : System(SysType::LightingSys), cubeLight_(nullptr), phongShader_(nullptr), lightPos_(), lightColor_(), ambientColor_(0.25f), lightCount_(0)
+LightingSystem::LightingSystem() : System(Type), cubeLight_(nullptr), phongShader_(nullptr), lightPos_(), lightColor_(), ambientColor_(0.25f), lightCount_(0), graphicsSys_(nullptr), renderSys_(nullptr)
 {
+	// Light cubes are culled against this frame's camera, and the lights are only used with this frame's shader
+	RunsAfter(CameraSys);
+	RunsAfter(GraphicsSys);
 }
 
 void LightingSystem::Initialize()
 {
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(GetParent()->GetSystem(GraphicsSys));
-	if (graphics)
-		graphics->SetBackColor(glm::vec3(0.25f, 0.25f, 0.25f));
+	graphicsSys_ = GetParent()->Get<GraphicsSystem>();
+	renderSys_ = GetParent()->Get<RenderSystem>();
+
+	if (graphicsSys_)
+		graphicsSys_->SetBackColor(glm::vec3(0.25f, 0.25f, 0.25f));
 }
 
 void LightingSystem::Update(float dt)
@@ -39,42 +43,18 @@ void LightingSystem::Update(float dt)
 		cubeLight_->SetScale(glm::vec3(0.25f));
 	}
 
-	glm::vec4 camEyePoint(0);
-
-	// Get the camera system so we can know what the eye point is
-	CameraSystem* camSys = dynamic_cast<CameraSystem*>(GetParent()->GetSystem(SysType::CameraSys));
-	if (camSys)
+	// Record the lights for the frame, they only get uploaded if the current shader is the Phong shader
+	FramePacket* packet = GetParent()->GetFramePacket();
+	packet->useLighting = IsActive();
+	packet->ambientColor = ambientColor_;
+	packet->lightCount = lightCount_;
+	for (int i = 0; i < lightCount_; ++i)
 	{
-		Camera* activeCam = camSys->GetActiveCamera();
-		if (activeCam)
-			camEyePoint = activeCam->GetEyePoint();
+		packet->lightPos[i] = lightPos_[i];
+		packet->lightColor[i] = lightColor_[i];
 	}
 
-	// Get the graphics system to check for the current active program
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(GetParent()->GetSystem(SysType::GraphicsSys));
-	if (graphics)
-	{
-		// If the current shader is the Phong shader, time to upload data
-		if (phongShader_ == graphics->GetActiveShader())
-		{
-			// Get all the uniform locations we need
-			GLint uEyePos = phongShader_->GetUniformLocation("eyePos");
-			GLint uAmbientColor = phongShader_->GetUniformLocation("ambientColor");
-			GLint uLightCount = phongShader_->GetUniformLocation("lightCount");
-			GLint uLightPos = phongShader_->GetUniformLocation("lightPos[0]");
-			GLint uLightColor = phongShader_->GetUniformLocation("lightColor[0]");
-
-			// Upload all the data needed
-			glUniform4fv(uEyePos, 1, &(camEyePoint[0]));
-			glUniform3fv(uAmbientColor, 1, &(ambientColor_[0]));
-			glUniform1i(uLightCount, lightCount_);
-			glUniform4fv(uLightPos, lightCount_, &(lightPos_[0][0]));
-			glUniform3fv(uLightColor, lightCount_, &(lightColor_[0][0]));
-		}
-	}
-
-	RenderSystem* renderSys = dynamic_cast<RenderSystem*>(GetParent()->GetSystem(SysType::RenderSys));
-	if (renderSys)
+	if (renderSys_)
 	{
 		for (int i = 0; i < lightCount_; ++i)
 		{
@@ -85,6 +65,48 @@ void LightingSystem::Update(float dt)
 	}
 }
 
+void LightingSystem::Submit(FramePacket& packet)
+{
+	// The instanced version of the Phong shader needs the same data, and the Phong shader gets
+	// uploaded to last so it stays in use
+	if (packet.useLighting && phongShader_)
+	{
+		Shader* phongInstanced = phongShader_->GetInstancedVariant();
+		if (phongInstanced)
+			UploadLights(phongInstanced, packet);
+		UploadLights(phongShader_, packet);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes a shader active and uploads the light data to it
+// 
+//	Param shader:
+//		The shader to upload the light data to
+// 
+//	Param packet:
+//		The frame with the lights and the eye point of the active camera
+//*****************************************************************************
+void LightingSystem::UploadLights(Shader* shader, const FramePacket& packet)
+{
+	shader->Use();
+
+	// Get all the uniform locations we need
+	GLint uEyePos = shader->GetUniformLocation("eyePos");
+	GLint uAmbientColor = shader->GetUniformLocation("ambientColor");
+	GLint uLightCount = shader->GetUniformLocation("lightCount");
+	GLint uLightPos = shader->GetUniformLocation("lightPos[0]");
+	GLint uLightColor = shader->GetUniformLocation("lightColor[0]");
+
+	// Upload all the data needed
+	glUniform4fv(uEyePos, 1, &(packet.eyePoint[0]));
+	glUniform3fv(uAmbientColor, 1, &(packet.ambientColor[0]));
+	glUniform1i(uLightCount, packet.lightCount);
+	glUniform4fv(uLightPos, packet.lightCount, &(packet.lightPos[0][0]));
+	glUniform3fv(uLightColor, packet.lightCount, &(packet.lightColor[0][0]));
+}
+
 void LightingSystem::Shutdown()
 {
 	if (cubeLight_)
@@ -110,9 +132,8 @@ void LightingSystem::ClearLights()
 
 bool LightingSystem::IsActive()
 {
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(GetParent()->GetSystem(SysType::GraphicsSys));
-	if (graphics)
-		return phongShader_ == graphics->GetActiveShader();
+	if (graphicsSys_)
+		return phongShader_ == graphicsSys_->GetActiveShader();
 	return false;
 }
 
@@ -10,17 +10,24 @@
 #include "System.h"
 #include "GfxMath.h"
 #include "glad/glad.h"
+#include "Shader.h"
 #include "RenderObject.h"
 
+class GraphicsSystem;
+class RenderSystem;
+
 static const int maxLights = 10;
 
 class LightingSystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::LightingSys;
+
 	LightingSystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
+	void Submit(FramePacket& packet) override;
 	void Shutdown() override;
 
 	void AddLight(glm::vec4 pos, glm::vec3 color);
@@ -33,6 +40,8 @@ public:
 
 private:
 
+	void UploadLights(Shader* shader, const FramePacket& packet);
+
 	// Render object for Rendering a cube at the lights
 	RenderObject* cubeLight_;
 	
@@ -49,4 +58,8 @@ private:
 	// How many lights are being used
 	int lightCount_;
 
+	// Systems this one uses, looked up once in Initialize
+	GraphicsSystem* graphicsSys_;
+	RenderSystem* renderSys_;
+
 };
\ No newline at end of file
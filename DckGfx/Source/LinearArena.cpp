@@ -0,0 +1,173 @@
+//*****************************************************************************
+//	File:   LinearArena.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Linear allocator for memory that only lives for a frame.
+//		Allocating just bumps a pointer, and everything is freed at once by
+//		resetting the arena
+//*****************************************************************************
+
+#include "LinearArena.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+//*****************************************************************************
+//  Description:
+//		Rounds a value up to a multiple of alignment (a power of two)
+//*****************************************************************************
+static uintptr_t AlignUp(uintptr_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+//*****************************************************************************
+//  Description:
+//		Constructor for a linear arena. No memory is allocated until the
+//		first allocation
+//
+//	Param capacity:
+//		How many bytes the arena starts with
+//*****************************************************************************
+LinearArena::LinearArena(size_t capacity) :
+	head_(nullptr),
+	headUsed_(0),
+	capacity_(capacity),
+	used_(0),
+	blockCount_(0),
+	heapAllocs_(0)
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Allocates memory out of the arena. If the current block is full a new
+//		one is allocated, and the arena is made big enough on the next reset
+//		that it won't have to again
+//
+//	Param size:
+//		How many bytes to allocate
+//
+//	Param alignment:
+//		What the memory needs to be aligned to (a power of two)
+//
+//	Return:
+//		Returns the allocated memory, which is good until the next reset
+//*****************************************************************************
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+	uintptr_t start = 0;
+	if (head_)
+	{
+		uintptr_t blockStart = reinterpret_cast<uintptr_t>(head_ + 1);
+		start = AlignUp(blockStart + headUsed_, alignment);
+		if (start + size > blockStart + head_->size)
+			start = 0;
+	}
+
+	// Doesn't fit in the current block, make a new one big enough for this at least
+	if (!start)
+	{
+		size_t blockSize = size + alignment > capacity_ ? size + alignment : capacity_;
+		AddBlock(blockSize);
+		start = AlignUp(reinterpret_cast<uintptr_t>(head_ + 1), alignment);
+	}
+
+	headUsed_ = start + size - reinterpret_cast<uintptr_t>(head_ + 1);
+	used_ += size;
+	return reinterpret_cast<void*>(start);
+}
+
+//*****************************************************************************
+//  Description:
+//		Frees everything allocated from the arena in one go. If the arena
+//		needed more than one block since the last reset, the blocks are
+//		replaced with a single block that fits all of them
+//*****************************************************************************
+void LinearArena::Reset()
+{
+	heapAllocs_ = 0;
+	if (blockCount_ > 1)
+	{
+		size_t totalSize = 0;
+		for (Block* block = head_; block; block = block->next)
+			totalSize += block->size;
+
+		FreeBlocks();
+		capacity_ = totalSize;
+		AddBlock(capacity_);
+	}
+
+	headUsed_ = 0;
+	used_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many bytes have been handed out since the last reset
+//*****************************************************************************
+size_t LinearArena::GetUsed()
+{
+	return used_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many bytes the arena can hand out before it needs a new block
+//*****************************************************************************
+size_t LinearArena::GetCapacity()
+{
+	return capacity_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many heap allocations the arena has made since the last
+//		reset, which is zero once the arena is big enough
+//*****************************************************************************
+int LinearArena::GetHeapAllocCount()
+{
+	return heapAllocs_;
+}
+
+LinearArena::~LinearArena()
+{
+	FreeBlocks();
+}
+
+//*****************************************************************************
+//  Description:
+//		Allocates a new block from the heap and makes it the current block
+//
+//	Param size:
+//		How many bytes the block can hand out
+//*****************************************************************************
+void LinearArena::AddBlock(size_t size)
+{
+	Block* block = static_cast<Block*>(malloc(sizeof(Block) + size));
+	if (!block)
+		throw std::bad_alloc();
+
+	block->next = head_;
+	block->size = size;
+	head_ = block;
+	headUsed_ = 0;
+	++blockCount_;
+	++heapAllocs_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Frees every block the arena has
+//*****************************************************************************
+void LinearArena::FreeBlocks()
+{
+	while (head_)
+	{
+		Block* next = head_->next;
+		free(head_);
+		head_ = next;
+	}
+	headUsed_ = 0;
+	blockCount_ = 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+//*****************************************************************************
+//	File:   LinearArena.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Linear allocator for memory that only lives for a frame, and
+//		a contiguous array that grows inside of one. Allocating just bumps a
+//		pointer, and everything is freed at once by resetting the arena
+//*****************************************************************************
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+class LinearArena {
+public:
+
+	LinearArena(size_t capacity);
+
+	void* Allocate(size_t size, size_t alignment);
+
+	template <typename T>
+	T* Allocate(size_t count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	void Reset();
+
+	size_t GetUsed();
+	size_t GetCapacity();
+	int GetHeapAllocCount();
+
+	~LinearArena();
+
+private:
+
+	// Header at the start of each heap block, the memory handed out comes right after it
+	struct Block {
+		Block* next;
+		size_t size;
+	};
+
+	// Not copyable, the blocks are owned by the arena
+	LinearArena(const LinearArena&);
+	LinearArena& operator=(const LinearArena&);
+
+	void AddBlock(size_t size);
+	void FreeBlocks();
+
+	// Newest block, which allocations come out of, and how much of it is used
+	Block* head_;
+	size_t headUsed_;
+
+	// Size the first block is made with. Grows to fit a whole frame if the arena ever overflows
+	size_t capacity_;
+
+	// How much was handed out and how many blocks were allocated since the last reset
+	size_t used_;
+	int blockCount_;
+	int heapAllocs_;
+
+};
+
+//*****************************************************************************
+//  Description:
+//		Contiguous array that allocates out of a linear arena. Growing copies
+//		into a new allocation and leaves the old one for the arena to reset.
+//		Reset forgets the memory in O(1), so it must be reset whenever its
+//		arena is. Remembers how big it got, so after the first frame it
+//		allocates once at the right size instead of growing again
+//*****************************************************************************
+template <typename T>
+class ArenaArray {
+public:
+
+	// Elements get copied around as raw memory when growing
+	static_assert(std::is_trivially_copyable<T>::value, "ArenaArray elements must be trivially copyable");
+
+	ArenaArray(LinearArena* arena) :
+		arena_(arena),
+		data_(nullptr),
+		size_(0),
+		capacity_(0),
+		sizeHint_(0)
+	{
+	}
+
+	void Push(const T& value)
+	{
+		if (size_ == capacity_)
+			Reserve(size_ + 1);
+		data_[size_++] = value;
+	}
+
+	void Resize(size_t size)
+	{
+		Reserve(size);
+		size_ = size;
+	}
+
+	void Reserve(size_t capacity)
+	{
+		if (capacity <= capacity_)
+			return;
+
+		size_t newCapacity = capacity_ * 2;
+		if (newCapacity < sizeHint_)
+			newCapacity = sizeHint_;
+		if (newCapacity < minCapacity)
+			newCapacity = minCapacity;
+		if (newCapacity < capacity)
+			newCapacity = capacity;
+
+		T* newData = arena_->Allocate<T>(newCapacity);
+		if (size_)
+			memcpy(newData, data_, sizeof(T) * size_);
+		data_ = newData;
+		capacity_ = newCapacity;
+	}
+
+	void Clear()
+	{
+		size_ = 0;
+	}
+
+	void Reset()
+	{
+		if (size_ > sizeHint_)
+			sizeHint_ = size_;
+		data_ = nullptr;
+		size_ = 0;
+		capacity_ = 0;
+	}
+
+	void Swap(ArenaArray& other)
+	{
+		T* data = data_;
+		size_t size = size_;
+		size_t capacity = capacity_;
+		data_ = other.data_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		other.data_ = data;
+		other.size_ = size;
+		other.capacity_ = capacity;
+	}
+
+	T& operator[](size_t i) { return data_[i]; }
+	T* Data() { return data_; }
+	size_t Size() { return size_; }
+	bool Empty() { return size_ == 0; }
+
+	T* begin() { return data_; }
+	T* end() { return data_ + size_; }
+
+private:
+
+	// Smallest allocation an array makes, so small arrays don't grow one element at a time
+	static const size_t minCapacity = 64;
+
+	LinearArena* arena_;
+	T* data_;
+	size_t size_;
+	size_t capacity_;
+
+	// Biggest the array has been before a reset
+	size_t sizeHint_;
+};
@@ -13,6 +13,7 @@
 #include "FileReader.h"
 #include "Shader.h"
 #include "Mesh.h"
+#include "BinaryMesh.h"
 #include "DckGfxEngine.h"
 
 // Delta time stuff
@@ -22,8 +23,60 @@ float dt = 0;
 
 int main(int argc, char* argv[]) {
 
+	// Convert any text mesh files given to binary .dmesh files and exit
+	if (argc > 1 && std::string(argv[1]) == "--convert")
+	{
+		bool worked = true;
+		for (int i = 2; i < argc; ++i)
+		{
+			if (ConvertMeshFile(argv[i]))
+				std::cout << "Converted " << argv[i] << std::endl;
+			else
+				worked = false;
+		}
+		return worked ? 0 : 1;
+	}
+
+	// Engine options from the command line
+	EngineConfig config;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--render-thread")
+			config.renderThread = true;
+		else if (arg == "--headless")
+			config.headless = true;
+		else if (arg == "--frames" && i + 1 < argc)
+			config.frameCount = std::stoi(argv[++i]);
+		else if (arg == "--warmup" && i + 1 < argc)
+			config.warmupFrames = std::stoi(argv[++i]);
+		else if (arg == "--stats" && i + 1 < argc)
+			config.statsPath = argv[++i];
+		else if (arg == "--record" && i + 1 < argc)
+			config.recordInputPath = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc)
+			config.replayInputPath = argv[++i];
+		else if (arg == "--fixed-dt" && i + 1 < argc)
+			config.fixedDt = std::stof(argv[++i]);
+		else if (arg == "--size" && i + 2 < argc)
+		{
+			config.width = std::stoi(argv[++i]);
+			config.height = std::stoi(argv[++i]);
+		}
+	}
+
+	// Headless runs are for benchmarking, so they always stop and always write stats.
+	// Replays stop on their own when the recording runs out
+	if (config.headless)
+	{
+		if (config.frameCount == 0 && !config.replayInputPath)
+			config.frameCount = 1000;
+		if (!config.statsPath)
+			config.statsPath = "FrameStats.json";
+	}
+
 	// Create and initialize the engine
-	DckEInitialize();
+	DckEInitialize(config);
 
 	// Main loop
 	while (DckEIsRunning())
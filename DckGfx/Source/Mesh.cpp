@@ -2,39 +2,26 @@
 //	File:   Mesh.cpp
 //  Author: Hunter Smith
 //  Date:   05/22/2022
-//  Description: Wrapper class for managing OpenGL meshes (mainly the vao)
+//  Description: Cpu side mesh data (vertices, colors, normals, and indices).
+//		Makes no OpenGL calls, so meshes can be built off of the GL thread
 //*****************************************************************************
 
 #include "Mesh.h"
 
-// Attribute locations, which should always stay constant with layout
-static GLint posAttribLocation = 0;
-static GLint colorAttribLocation = 1;
-static GLint normalAttribLocation = 2;
-
 //*************************************************************************
 //  Description:
-//		Constructor for a mesh class, which generates buffers for meshes
+//		Constructor for a mesh class. Only sets the name, no OpenGL objects
+//		are created until the mesh is loaded into a DckMesh
 //*************************************************************************
 Mesh::Mesh(std::string name) : 
 	name_(name),
-	posAttrib_(posAttribLocation),
-	colorAttrib_(colorAttribLocation),
 	vertices_(),
 	colors_(),
+	normals_(),
 	points_(),
 	edges_(),
-	faces_(),
-	buffers_(),
-	pointVao_(0),
-	edgeVao_(0),
-	faceVao_(0)
+	faces_()
 {
-	glGenBuffers(1, &buffers_[VBO]);
-	glGenBuffers(1, &buffers_[CBO]);
-	glGenBuffers(1, &buffers_[pointEBO]);
-	glGenBuffers(1, &buffers_[edgeEBO]);
-	glGenBuffers(1, &buffers_[faceEBO]);
 }
 
 //*************************************************************************
@@ -52,16 +39,27 @@ void Mesh::AddVertex(glm::vec4 position, glm::vec3 color)
 	// Push the position and color onto the vectors
 	vertices_.push_back(position);
 	colors_.push_back(color);
+}
 
-	// Upload vertex data to the VBO
-	int vertCount = GetVertexCount();
-	glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * vertCount, &(vertices_[0]), GL_STATIC_DRAW);
-	// glNamedBufferData(buffers_[VBO], vertCount * sizeof(glm::vec4), &(vertices_[0]), GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ARRAY_BUFFER, buffers_[CBO]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertCount, &(colors_[0]), GL_STATIC_DRAW);
-	// glNamedBufferData(buffers_[CBO], vertCount * sizeof(glm::vec3), &(colors_[0]), GL_STATIC_DRAW);
+//*************************************************************************
+//  Description:
+//		Adds a vertex with a normal to the mesh. A mesh only counts as having
+//		normals if every vertex was added with one
+// 
+//	Param position
+//		The position of the vertex
+// 
+//	Param color
+//		The color of the vertex
+// 
+//	Param normal
+//		The normal of the vertex
+//*************************************************************************
+void Mesh::AddVertex(glm::vec4 position, glm::vec3 color, glm::vec4 normal)
+{
+	vertices_.push_back(position);
+	colors_.push_back(color);
+	normals_.push_back(normal);
 }
 
 //*************************************************************************
@@ -73,12 +71,10 @@ void Mesh::AddVertex(glm::vec4 position, glm::vec3 color)
 void Mesh::AddPoint(unsigned int v)
 {
 	int vertCount = GetVertexCount();
-	if (v > vertCount)
+	if (v >= vertCount)
 		return;
 
 	points_.push_back(v);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[pointEBO]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * GetPointCount(), &(points_[0]), GL_STATIC_DRAW);
 }
 
 //*************************************************************************
@@ -94,13 +90,10 @@ void Mesh::AddPoint(unsigned int v)
 void Mesh::AddEdge(unsigned int v1, unsigned int v2)
 {
 	int vertCount = GetVertexCount();
-	if (v1 > vertCount || v2 > vertCount)
+	if (v1 >= vertCount || v2 >= vertCount)
 		return;
 
 	edges_.push_back(Edge(v1, v2));
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[edgeEBO]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Edge) * GetEdgeCount(), &(edges_[0]), GL_STATIC_DRAW);
-	// glNamedBufferData(buffers_[edgeEBO], GetEdgeCount() * sizeof(Edge), &(edges_[0]), GL_STATIC_DRAW);
 }
 
 //*************************************************************************
@@ -119,9 +112,106 @@ void Mesh::AddEdge(unsigned int v1, unsigned int v2)
 void Mesh::AddFace(unsigned int v1, unsigned int v2, unsigned int v3)
 {
 	faces_.push_back(Face(v1, v2, v3));
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[faceEBO]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Face) * GetFaceCount(), &(faces_[0]), GL_STATIC_DRAW);
-	// glNamedBufferData(buffers_[edgeEBO], GetFaceCount() * sizeof(Face), &(faces_[0]), GL_STATIC_DRAW);
+}
+
+//*************************************************************************
+//  Description:
+//		Reserves space for the mesh data, so building a mesh of a known size
+//		doesn't have to keep reallocating the vectors
+// 
+//	Param vertexCount:
+//		How many vertices (and their colors and normals) to reserve space for
+// 
+//	Param pointCount:
+//		How many points to reserve space for
+// 
+//	Param edgeCount:
+//		How many edges to reserve space for
+// 
+//	Param faceCount:
+//		How many faces to reserve space for
+//*************************************************************************
+void Mesh::Reserve(int vertexCount, int pointCount, int edgeCount, int faceCount)
+{
+	if (vertexCount > 0)
+	{
+		vertices_.reserve(vertexCount);
+		colors_.reserve(vertexCount);
+		normals_.reserve(vertexCount);
+	}
+	if (pointCount > 0)
+		points_.reserve(pointCount);
+	if (edgeCount > 0)
+		edges_.reserve(edgeCount);
+	if (faceCount > 0)
+		faces_.reserve(faceCount);
+}
+
+//*************************************************************************
+//  Description:
+//		Replaces the vertex data of the mesh with already built arrays. Any
+//		normals are dropped, since they would no longer match the vertices
+// 
+//	Param positions:
+//		The positions of the vertices, moved into the mesh
+// 
+//	Param colors:
+//		The colors of the vertices, moved into the mesh
+//*************************************************************************
+void Mesh::SetVertices(std::vector<glm::vec4>&& positions, std::vector<glm::vec3>&& colors)
+{
+	vertices_ = std::move(positions);
+	colors_ = std::move(colors);
+	normals_.clear();
+}
+
+//*************************************************************************
+//  Description:
+//		Replaces the normals of the mesh with an already built array. Needs
+//		one normal per vertex for the mesh to count as having normals
+// 
+//	Param normals:
+//		The normals of the vertices, moved into the mesh
+//*************************************************************************
+void Mesh::SetNormals(std::vector<glm::vec4>&& normals)
+{
+	normals_ = std::move(normals);
+}
+
+//*************************************************************************
+//  Description:
+//		Replaces the point indices of the mesh with an already built array
+// 
+//	Param points:
+//		The point indices, moved into the mesh
+//*************************************************************************
+void Mesh::SetPoints(std::vector<unsigned int>&& points)
+{
+	points_ = std::move(points);
+}
+
+//*************************************************************************
+//  Description:
+//		Replaces the edges of the mesh with an already built array
+// 
+//	Param edges:
+//		The edges, moved into the mesh
+//*************************************************************************
+void Mesh::SetEdges(std::vector<Edge>&& edges)
+{
+	edges_ = std::move(edges);
+}
+
+//*************************************************************************
+//  Description:
+//		Replaces the faces of the mesh with an already built array
+// 
+//	Param faces:
+//		The faces, moved into the mesh
+//*************************************************************************
+void Mesh::SetFaces(std::vector<Face>&& faces)
+{
+	faces_ = std::move(faces);
 }
 
 std::string Mesh::GetName()
@@ -199,6 +289,32 @@ glm::vec3* Mesh::GetColors()
 	return nullptr;
 }
 
+//*************************************************************************
+//  Description:
+//		Checks if every vertex in the mesh has a normal
+// 
+//	Return:
+//		Returns true if the mesh has normals, false otherwise
+//*************************************************************************
+bool Mesh::HasNormals()
+{
+	return !normals_.empty() && normals_.size() == vertices_.size();
+}
+
+//*************************************************************************
+//  Description:
+//		Gets the normal array of the mesh
+// 
+//	Return:
+//		Returns a pointer to the first normal in the array
+//*************************************************************************
+glm::vec4* Mesh::GetNormals()
+{
+	if (normals_.size() > 0)
+		return &(normals_[0]);
+	return nullptr;
+}
+
 //*************************************************************************
 //  Description:
 //		Gets the point array of the mesh
@@ -241,6 +357,30 @@ Mesh::Face* Mesh::GetFaces()
 	return nullptr;
 }
 
+//*************************************************************************
+//  Description:
+//		Gets a view of all the mesh data, which is only valid as long as the
+//		mesh isn't modified or deleted
+// 
+//	Return:
+//		Returns a view pointing at the mesh's arrays
+//*************************************************************************
+MeshView Mesh::GetView()
+{
+	MeshView view;
+	view.vertices = GetVertices();
+	view.colors = GetColors();
+	view.normals = HasNormals() ? GetNormals() : nullptr;
+	view.points = GetPoints();
+	view.edges = GetEdges();
+	view.faces = GetFaces();
+	view.vertexCount = GetVertexCount();
+	view.pointCount = GetPointCount();
+	view.edgeCount = GetEdgeCount();
+	view.faceCount = GetFaceCount();
+	return view;
+}
+
 //*************************************************************************
 //  Description:
 //		Gets the edge array of the mesh
@@ -281,165 +421,15 @@ Mesh::Face Mesh::GetFace(unsigned int i)
 
 //*************************************************************************
 //  Description:
-//		Gets the buffer value of the specified buffer
-// 
-//	Param buff:
-//		The buffer to get from the mesh
-//		
-//	Return:
-//		Returns the value of the buffer of the mesh
-//*************************************************************************
-GLuint Mesh::GetBuffer(Buffers buff)
-{
-	return buffers_[buff];
-}
-
-//*************************************************************************
-//  Description:
-//		Generates (if needed) and gets the VAO for points
-// 
-//	Return:
-//		Returns the vao of the mesh for rendering points
-//*************************************************************************
-GLuint Mesh::GetPointVAO()
-{
-	if (!pointVao_)
-	{
-		glGenVertexArrays(1, &pointVao_);
-
-		glBindVertexArray(pointVao_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
-		glVertexAttribPointer(posAttrib_, 4, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(posAttrib_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[CBO]);
-		glVertexAttribPointer(colorAttrib_, 3, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(colorAttrib_);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[pointEBO]);
-
-		glBindVertexArray(0);
-	}
-	return pointVao_;
-}
-
-//*************************************************************************
-//  Description:
-//		Generates (if needed) and gets the edge vao of the mesh
-// 
-//	Return:
-//		Returns the vao of the mesh for rendering edges
-//*************************************************************************
-GLuint Mesh::GetEdgeVAO()
-{
-	if (!edgeVao_)
-	{
-		glGenVertexArrays(1, &edgeVao_);
-
-		glBindVertexArray(edgeVao_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
-		glVertexAttribPointer(posAttrib_, 4, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(posAttrib_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[CBO]);
-		glVertexAttribPointer(colorAttrib_, 3, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(colorAttrib_);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[edgeEBO]);
-
-		glBindVertexArray(0);
-	}
-
-	return edgeVao_;
-}
-
-//*************************************************************************
-//  Description:
-//		Generates (if needed) and gets the face vao of the mesh
-// 
-//	Return:
-//		Returns the vao of the mesh for rendering faces
-//*************************************************************************
-GLuint Mesh::GetFaceVAO()
-{
-	// If there is no vao created yet, get one created for the mesh
-	if (!faceVao_)
-	{
-		// Generate the VAO and all the buffers
-		glGenVertexArrays(1, &faceVao_);
-
-		glBindVertexArray(faceVao_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
-		glVertexAttribPointer(posAttrib_, 4, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(posAttrib_);
-
-		glBindBuffer(GL_ARRAY_BUFFER, buffers_[CBO]);
-		glVertexAttribPointer(colorAttrib_, 3, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(colorAttrib_);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[faceEBO]);
-
-		glBindVertexArray(0);
-	}
-
-	return faceVao_;
-}
-
-//*************************************************************************
-//  Description:
-//		Gets the position attribute location
-// 
-//	Return:
-//		Returns the location of the position attribute
-//*************************************************************************
-GLint Mesh::GetPositionAttrib()
-{
-	return posAttrib_;
-}
-
-//*************************************************************************
-//  Description:
-//		Gets the color attribute location
-// 
-//	Return:
-//		Returns the location of the color attribute
-//*************************************************************************
-GLint Mesh::GetColorAttrib()
-{
-	return colorAttrib_;
-}
-
-//*************************************************************************
-//  Description:
-//		Destructor for a mesh, which deletes all the buffers, as well as
-//		any vaos that were generated
+//		Destructor for a mesh, which clears all of the mesh data
 //*************************************************************************
 Mesh::~Mesh()
 {
-	// Delete all the buffers
-	glDeleteBuffers(1, &buffers_[faceEBO]);
-	glDeleteBuffers(1, &buffers_[edgeEBO]);
-	glDeleteBuffers(1, &buffers_[pointEBO]);
-	glDeleteBuffers(1, &buffers_[CBO]);
-	glDeleteBuffers(1, &buffers_[VBO]);
-
-	// Delete any vertex arrays that were generated here
-	if (faceVao_)
-		glDeleteVertexArrays(1, &faceVao_);
-
-	if (edgeVao_)
-		glDeleteVertexArrays(1, &edgeVao_);
-
-	if (pointVao_)
-		glDeleteVertexArrays(1, &pointVao_);
-
 	// Clear all the data structures
 	faces_.clear();
 	edges_.clear();
 	points_.clear();
+	normals_.clear();
 	colors_.clear();
 	vertices_.clear();
 }
@@ -449,10 +439,10 @@ Mesh::~Mesh()
 //		Constructor for a Normal Mesh, which generates a normal mesh from
 //		a provided mesh
 //*************************************************************************
-NormalMesh::NormalMesh(Mesh* mesh) : Mesh("Norm" + mesh->GetName()), normalAttrib_(normalAttribLocation), normals_(), normalBuffer_(0), normalFaceVao_(0)
+NormalMesh::NormalMesh(Mesh* mesh) : Mesh("Norm" + mesh->GetName())
 {
-	glGenBuffers(1, &normalBuffer_);
 	int faceCount = mesh->GetFaceCount();
+	Reserve(faceCount * 3, 0, 0, faceCount);
 	for (int i = 0; i < faceCount; ++i)
 	{
 		// Add the new face
@@ -465,94 +455,21 @@ NormalMesh::NormalMesh(Mesh* mesh) : Mesh("Norm" + mesh->GetName()), normalAttri
 		std::pair<glm::vec4, glm::vec3> v2 = mesh->GetVertex(origMeshFace.v2);
 		std::pair<glm::vec4, glm::vec3> v3 = mesh->GetVertex(origMeshFace.v3);
 
-		AddVertex(v1.first, v1.second);
-		AddVertex(v2.first, v2.second);
-		AddVertex(v3.first, v3.second);
-
 		// Calculate normals
 		glm::vec4 firstVec = v2.first - v1.first;
 		glm::vec4 secondVec = v3.first - v1.first;
 		glm::vec4 normal = GfxMath::CrossProduct(firstVec, secondVec);
-		normals_.push_back(normal);
-		normals_.push_back(normal);
-		normals_.push_back(normal);
-	}
-}
 
-//*************************************************************************
-//  Description:
-//		Gets the normal array of the mesh
-// 
-//	Return:
-//		Returns a pointer to the first normal in the array
-//*************************************************************************
-glm::vec4* NormalMesh::GetNormals()
-{
-	return &(normals_[0]);
-}
-
-//*************************************************************************
-//  Description:
-//		Generates (if needed) and gets the normal face vao for rendering
-//		a mesh with normals
-// 
-//	Return:
-//		Returns the vao for rendering a mesh with faces and normals
-//*************************************************************************
-GLuint NormalMesh::GetNormalFaceVAO()
-{
-	if (!normalFaceVao_)
-	{
-		// Upload vertex, color, normal, and face data
-		glBindBuffer(GL_ARRAY_BUFFER, GetBuffer(VBO));
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * GetVertexCount(), GetVertices(), GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ARRAY_BUFFER, GetBuffer(CBO));
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * GetVertexCount(), GetColors(), GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ARRAY_BUFFER, normalBuffer_);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * normals_.size(), &(normals_[0]), GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GetBuffer(faceEBO));
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Face) * GetFaceCount(), GetFaces(), GL_STATIC_DRAW);
-
-		// Generate the vertex array and bind it
-		glGenVertexArrays(1, &normalFaceVao_);
-
-		glBindVertexArray(normalFaceVao_);
-
-		// Get position and color attrib from base
-		GLint posAttrib = GetPositionAttrib();
-		GLint colorAttrib = GetColorAttrib();
-
-		// Enable attributes
-		glBindBuffer(GL_ARRAY_BUFFER, GetBuffer(VBO));
-		glVertexAttribPointer(posAttrib, 4, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(posAttrib);
-
-		glBindBuffer(GL_ARRAY_BUFFER, GetBuffer(CBO));
-		glVertexAttribPointer(colorAttrib, 3, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(colorAttrib);
-
-		glBindBuffer(GL_ARRAY_BUFFER, normalBuffer_);
-		glVertexAttribPointer(normalAttrib_, 4, GL_FLOAT, false, 0, 0);
-		glEnableVertexAttribArray(normalAttrib_);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GetBuffer(faceEBO));
-		glBindVertexArray(0);
+		AddVertex(v1.first, v1.second, normal);
+		AddVertex(v2.first, v2.second, normal);
+		AddVertex(v3.first, v3.second, normal);
 	}
-	return normalFaceVao_;
 }
 
 //*************************************************************************
 //  Description:
-//		Destructor for the normal mesh, which only needs to handle the
-//		normal buffer, since base mesh can handle the rest
+//		Destructor for the normal mesh, the base mesh handles all the data
 //*************************************************************************
 NormalMesh::~NormalMesh()
 {
-	glDeleteBuffers(1, &normalBuffer_);
-
-	if (normalFaceVao_)
-		glDeleteVertexArrays(1, &normalFaceVao_);
 }
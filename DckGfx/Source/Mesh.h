@@ -3,10 +3,10 @@
 //	File:   Mesh.h
 //  Author: Hunter Smith
 //  Date:   05/22/2022
-//  Description: Wrapper class for managing OpenGL meshes (mainly the vao)
+//  Description: Cpu side mesh data (vertices, colors, normals, and indices).
+//		Makes no OpenGL calls, so meshes can be built off of the GL thread
 //*****************************************************************************
 
-#include "Shader.h"
 #include "GfxMath.h"
 #include <string>
 #include <vector>
@@ -21,25 +21,17 @@ enum RenderType {
 	Triangles
 };
 
+// Forward declare the view so meshes can hand one out
+struct MeshView;
+
 //*****************************************************************************
 //  Description:
-//		Class for meshes, which manages the OpenGL buffers, as well as all the
-//		vertex, point, edge, and face data needed for the mesh
+//		Class for meshes, which holds all the vertex, point, edge, and face
+//		data needed for the mesh. This is purely cpu data, DckMesh is what
+//		uploads it to OpenGL
 //*****************************************************************************
 class Mesh {
 public:
-	//*************************************************************************
-	//  Description:
-	//		Enum for what buffers are where for the array
-	//*************************************************************************
-	enum Buffers {
-		VBO,
-		CBO,
-		pointEBO,
-		edgeEBO,
-		faceEBO,
-		BuffCount
-	};
 
 	//*************************************************************************
 	//  Description:
@@ -48,6 +40,7 @@ public:
 	struct Edge {
 		unsigned int v1;
 		unsigned int v2;
+		Edge() : v1(0), v2(0) {}
 		Edge(unsigned int v1, unsigned int v2) : v1(v1), v2(v2) {}
 	};
 
@@ -59,16 +52,26 @@ public:
 		unsigned int v1;
 		unsigned int v2;
 		unsigned int v3;
+		Face() : v1(0), v2(0), v3(0) {}
 		Face(unsigned int v1, unsigned int v2, unsigned int v3) : v1(v1), v2(v2), v3(v3) {}
 	};
 
 	Mesh(std::string name = "Mesh");
 
 	void AddVertex(glm::vec4 position, glm::vec3 color);
+	void AddVertex(glm::vec4 position, glm::vec3 color, glm::vec4 normal);
 	void AddPoint(unsigned int v);
 	void AddEdge(unsigned int v1, unsigned int v2);
 	void AddFace(unsigned int v1, unsigned int v2, unsigned int v3);
 
+	void Reserve(int vertexCount, int pointCount = 0, int edgeCount = 0, int faceCount = 0);
+
+	void SetVertices(std::vector<glm::vec4>&& positions, std::vector<glm::vec3>&& colors);
+	void SetNormals(std::vector<glm::vec4>&& normals);
+	void SetPoints(std::vector<unsigned int>&& points);
+	void SetEdges(std::vector<Edge>&& edges);
+	void SetFaces(std::vector<Face>&& faces);
+
 	std::pair<glm::vec4, glm::vec3> GetVertex(unsigned int v);
 	Face GetFace(unsigned int i);
 
@@ -79,20 +82,16 @@ public:
 	int GetEdgeCount();
 	int GetFaceCount();
 
+	bool HasNormals();
+
 	glm::vec4* GetVertices();
 	glm::vec3* GetColors();
+	glm::vec4* GetNormals();
 	unsigned int* GetPoints();
 	Mesh::Edge* GetEdges();
 	Mesh::Face* GetFaces();
 
-	GLuint GetPointVAO();
-	GLuint GetEdgeVAO();
-	GLuint GetFaceVAO();
-
-	GLint GetPositionAttrib();
-	GLint GetColorAttrib();
-
-	GLuint GetBuffer(Buffers buff);
+	MeshView GetView();
 
 	virtual ~Mesh();
 
@@ -100,42 +99,58 @@ private:
 
 	std::string name_;
 
-	GLint posAttrib_;
-	GLint colorAttrib_;
-	
 	std::vector<glm::vec4> vertices_;
 	std::vector<glm::vec3> colors_;
+	std::vector<glm::vec4> normals_;
 
 	std::vector<unsigned int> points_;
 	std::vector<Edge> edges_;
 	std::vector<Face> faces_;
+};
 
-	GLuint buffers_[BuffCount];
-
-	GLuint pointVao_, edgeVao_, faceVao_;
+//*************************************************************************
+//  Description:
+//		Non-owning view of mesh data. This is what DckMesh uploads from, so
+//		both a Mesh and a memory mapped binary mesh file can be handed to
+//		OpenGL without copying the data first
+//*************************************************************************
+struct MeshView {
+	const glm::vec4* vertices;
+	const glm::vec3* colors;
+	const glm::vec4* normals;
+	const unsigned int* points;
+	const Mesh::Edge* edges;
+	const Mesh::Face* faces;
+
+	int vertexCount;
+	int pointCount;
+	int edgeCount;
+	int faceCount;
+
+	MeshView() :
+		vertices(nullptr),
+		colors(nullptr),
+		normals(nullptr),
+		points(nullptr),
+		edges(nullptr),
+		faces(nullptr),
+		vertexCount(0),
+		pointCount(0),
+		edgeCount(0),
+		faceCount(0)
+	{}
 };
 
 //*************************************************************************
 //  Description:
-//		Normal mesh class, which derives from the mesh class and handles
-//		normals for a mesh as well as everything the mesh class handles
+//		Normal mesh class, which derives from the mesh class and builds a
+//		flat shaded copy of a mesh with a normal for every vertex
 //*************************************************************************
 class NormalMesh : public Mesh {
 public:
 
 	NormalMesh(Mesh* mesh);
 
-	glm::vec4* GetNormals();
-
-	GLuint GetNormalFaceVAO();
-
 	~NormalMesh();
 
-private:
-
-	GLint normalAttrib_;
-	std::vector<glm::vec4> normals_;
-	GLuint normalBuffer_;
-	GLuint normalFaceVao_;
-
 };
\ No newline at end of file
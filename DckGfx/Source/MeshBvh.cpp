@@ -0,0 +1,318 @@
+//*****************************************************************************
+//	File:   MeshBvh.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Bounding volume hierarchy over the triangles of a mesh, for
+//		casting rays against the actual shape of the mesh. Built once with
+//		the surface area heuristic and never changed after
+//*****************************************************************************
+
+#include "MeshBvh.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cfloat>
+
+// How many buckets centers are sorted into when looking for the best split
+static const int sahBinCount = 12;
+
+// Most triangles a leaf is made with when it could still be split
+static const int maxLeafSize = 4;
+
+// Deepest the tree goes, so rays can walk it with a fixed size stack
+static const int maxDepth = 48;
+
+MeshBvh::MeshBvh() :
+	triangles_(),
+	nodes_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds the tree for a mesh right away, so it is ready to cast rays at
+//
+//	Param mesh:
+//		View of the mesh, which isn't needed once this returns
+//*****************************************************************************
+MeshBvh::MeshBvh(const MeshView& mesh) : MeshBvh()
+{
+	SetTriangles(mesh.vertices, mesh.vertexCount, mesh.faces, mesh.faceCount);
+	Build();
+}
+
+//*****************************************************************************
+//  Description:
+//		Copies the triangles of a mesh to build the tree from. The mesh data
+//		isn't needed after this, so it can come from a file that is about to
+//		be closed. The tree has to be built before rays are cast at it
+//
+//	Param vertices:
+//		The vertex positions of the mesh
+//
+//	Param vertexCount:
+//		How many vertices there are, faces using anything past this are skipped
+//
+//	Param faces:
+//		The faces of the mesh
+//
+//	Param faceCount:
+//		How many faces there are
+//*****************************************************************************
+void MeshBvh::SetTriangles(const glm::vec4* vertices, int vertexCount, const Mesh::Face* faces, int faceCount)
+{
+	Clear();
+	triangles_.reserve(faceCount);
+	unsigned int maxIndex = static_cast<unsigned int>(vertexCount);
+	for (int i = 0; i < faceCount; ++i)
+	{
+		const Mesh::Face& face = faces[i];
+		if (face.v1 >= maxIndex || face.v2 >= maxIndex || face.v3 >= maxIndex)
+			continue;
+
+		Triangle triangle;
+		triangle.corner = glm::vec3(vertices[face.v1]);
+		triangle.edge1 = glm::vec3(vertices[face.v2]) - triangle.corner;
+		triangle.edge2 = glm::vec3(vertices[face.v3]) - triangle.corner;
+		triangles_.push_back(triangle);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds the tree from the triangles. Each node is split where the
+//		surface area heuristic says a ray will have to check the fewest
+//		triangles, and the triangles are put in the order of the leaves
+//*****************************************************************************
+void MeshBvh::Build()
+{
+	DCK_PROFILE_ZONE("Build Mesh BVH");
+
+	nodes_.clear();
+	if (triangles_.empty())
+		return;
+
+	std::vector<BuildItem> items(triangles_.size());
+	for (size_t i = 0; i < triangles_.size(); ++i)
+	{
+		const Triangle& triangle = triangles_[i];
+		glm::vec3 second = triangle.corner + triangle.edge1;
+		glm::vec3 third = triangle.corner + triangle.edge2;
+		items[i].box = Aabb(glm::min(triangle.corner, glm::min(second, third)), glm::max(triangle.corner, glm::max(second, third)));
+		items[i].center = items[i].box.GetCenter();
+		items[i].triangle = static_cast<int>(i);
+	}
+
+	nodes_.reserve(2 * items.size() / maxLeafSize + 1);
+	nodes_.push_back(Node());
+	BuildNode(0, items.data(), 0, static_cast<int>(items.size()), 0);
+
+	std::vector<Triangle> ordered;
+	ordered.reserve(triangles_.size());
+	for (const BuildItem& item : items)
+		ordered.push_back(triangles_[item.triangle]);
+	triangles_.swap(ordered);
+}
+
+void MeshBvh::Clear()
+{
+	triangles_.clear();
+	nodes_.clear();
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds the closest triangle a ray hits, from either side. Nothing is
+//		hit until the tree has been built
+//
+//	Param origin:
+//		Where the ray starts, in the mesh's space
+//
+//	Param dir:
+//		Which way the ray goes, distances are in multiples of its length
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Return:
+//		Returns how far along the ray the closest hit was, or a negative
+//		number if nothing was hit
+//*****************************************************************************
+float MeshBvh::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist)
+{
+	if (nodes_.empty())
+		return -1.0f;
+
+	glm::vec3 invDir;
+	for (int axis = 0; axis < 3; ++axis)
+		invDir[axis] = dir[axis] != 0.0f ? 1.0f / dir[axis] : FLT_MAX;
+
+	float closest = maxDist;
+	bool hit = false;
+	int stack[maxDepth + 2];
+	int stackSize = 0;
+	if (nodes_[0].box.RayDistance(origin, invDir, closest) >= 0.0f)
+		stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = nodes_[stack[--stackSize]];
+		if (node.count > 0)
+		{
+			// Moller Trumbore, without culling back faces
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				const Triangle& triangle = triangles_[i];
+				glm::vec3 p = glm::cross(dir, triangle.edge2);
+				float det = glm::dot(triangle.edge1, p);
+				if (det == 0.0f)
+					continue;
+
+				float invDet = 1.0f / det;
+				glm::vec3 toOrigin = origin - triangle.corner;
+				float u = glm::dot(toOrigin, p) * invDet;
+				if (u < 0.0f || u > 1.0f)
+					continue;
+
+				glm::vec3 q = glm::cross(toOrigin, triangle.edge1);
+				float v = glm::dot(dir, q) * invDet;
+				if (v < 0.0f || u + v > 1.0f)
+					continue;
+
+				float dist = glm::dot(triangle.edge2, q) * invDet;
+				if (dist >= 0.0f && dist <= closest)
+				{
+					closest = dist;
+					hit = true;
+				}
+			}
+			continue;
+		}
+
+		// Pushed furthest first, so the closer child is looked at next
+		float dist0 = nodes_[node.first].box.RayDistance(origin, invDir, closest);
+		float dist1 = nodes_[node.first + 1].box.RayDistance(origin, invDir, closest);
+		int first = node.first;
+		int second = node.first + 1;
+		if (dist1 >= 0.0f && (dist0 < 0.0f || dist1 < dist0))
+		{
+			std::swap(first, second);
+			std::swap(dist0, dist1);
+		}
+		if (dist1 >= 0.0f)
+			stack[stackSize++] = second;
+		if (dist0 >= 0.0f)
+			stack[stackSize++] = first;
+	}
+
+	return hit ? closest : -1.0f;
+}
+
+int MeshBvh::GetTriangleCount()
+{
+	return static_cast<int>(triangles_.size());
+}
+
+MeshBvh::~MeshBvh()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds a node for a run of triangles. Centers are sorted into
+//		buckets along the longest axis and split where the surface area cost
+//		is lowest, unless keeping them all in a leaf costs less. If every
+//		center is in the same place the run is cut in half
+//*****************************************************************************
+void MeshBvh::BuildNode(int node, BuildItem* items, int first, int count, int depth)
+{
+	Aabb box;
+	Aabb centerBox;
+	for (int i = first; i < first + count; ++i)
+	{
+		box.Grow(items[i].box);
+		centerBox.Grow(Aabb(items[i].center, items[i].center));
+	}
+	nodes_[node].box = box;
+	nodes_[node].first = first;
+	nodes_[node].count = count;
+
+	if (count <= maxLeafSize || depth >= maxDepth)
+		return;
+
+	glm::vec3 centerSize = centerBox.max - centerBox.min;
+	int axis = centerSize.x > centerSize.y ? (centerSize.x > centerSize.z ? 0 : 2) : (centerSize.y > centerSize.z ? 1 : 2);
+
+	int middle = first + count / 2;
+	if (centerSize[axis] > 0.0f)
+	{
+		Aabb binBoxes[sahBinCount];
+		int binCounts[sahBinCount] = {};
+		float binScale = sahBinCount / centerSize[axis];
+		auto binOf = [&](const BuildItem& item) {
+			int bin = static_cast<int>((item.center[axis] - centerBox.min[axis]) * binScale);
+			return bin < sahBinCount ? bin : sahBinCount - 1;
+		};
+		for (int i = first; i < first + count; ++i)
+		{
+			int bin = binOf(items[i]);
+			++binCounts[bin];
+			binBoxes[bin].Grow(items[i].box);
+		}
+
+		float leftAreas[sahBinCount - 1];
+		int leftCounts[sahBinCount - 1];
+		Aabb left;
+		int leftCount = 0;
+		for (int i = 0; i < sahBinCount - 1; ++i)
+		{
+			left.Grow(binBoxes[i]);
+			leftCount += binCounts[i];
+			leftAreas[i] = left.SurfaceArea();
+			leftCounts[i] = leftCount;
+		}
+
+		int bestSplit = -1;
+		float bestCost = FLT_MAX;
+		Aabb right;
+		int rightCount = 0;
+		for (int i = sahBinCount - 1; i > 0; --i)
+		{
+			right.Grow(binBoxes[i]);
+			rightCount += binCounts[i];
+			if (leftCounts[i - 1] == 0 || rightCount == 0)
+				continue;
+
+			float cost = leftAreas[i - 1] * leftCounts[i - 1] + right.SurfaceArea() * rightCount;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		// A small run stays a leaf if testing all of its triangles is cheaper than splitting
+		if (count <= 2 * maxLeafSize && bestCost >= box.SurfaceArea() * count)
+			return;
+
+		if (bestSplit > 0)
+		{
+			BuildItem* split = std::partition(items + first, items + first + count,
+											  [&](const BuildItem& item) { return binOf(item) < bestSplit; });
+			middle = static_cast<int>(split - items);
+		}
+		else
+		{
+			std::nth_element(items + first, items + middle, items + first + count, [&](const BuildItem& a, const BuildItem& b) {
+				return a.center[axis] < b.center[axis];
+			});
+		}
+	}
+
+	int children = static_cast<int>(nodes_.size());
+	nodes_.push_back(Node());
+	nodes_.push_back(Node());
+	nodes_[node].first = children;
+	nodes_[node].count = 0;
+	BuildNode(children, items, first, middle - first, depth + 1);
+	BuildNode(children + 1, items, middle, first + count - middle, depth + 1);
+}
@@ -0,0 +1,71 @@
+#pragma once
+//*****************************************************************************
+//	File:   MeshBvh.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Bounding volume hierarchy over the triangles of a mesh, for
+//		casting rays against the actual shape of the mesh. Built once with
+//		the surface area heuristic and never changed after
+//*****************************************************************************
+
+#include "Bvh.h"
+#include "Mesh.h"
+#include <vector>
+
+class MeshBvh {
+public:
+
+	MeshBvh();
+	MeshBvh(const MeshView& mesh);
+
+	void SetTriangles(const glm::vec4* vertices, int vertexCount, const Mesh::Face* faces, int faceCount);
+	void Build();
+	void Clear();
+
+	float RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist);
+
+	int GetTriangleCount();
+
+	~MeshBvh();
+
+private:
+
+	//*************************************************************************
+	//  Description:
+	//		A triangle, kept as one corner and the two edges out of it since
+	//		that is what the ray test uses
+	//*************************************************************************
+	struct Triangle {
+		glm::vec3 corner;
+		glm::vec3 edge1;
+		glm::vec3 edge2;
+	};
+
+	//*************************************************************************
+	//  Description:
+	//		A node in the tree. Leaves have a run of triangles, other nodes
+	//		have their two children next to each other starting at first
+	//*************************************************************************
+	struct Node {
+		Aabb box;
+		int first;
+		int count;
+	};
+
+	//*************************************************************************
+	//  Description:
+	//		A triangle being built into the tree
+	//*************************************************************************
+	struct BuildItem {
+		Aabb box;
+		glm::vec3 center;
+		int triangle;
+	};
+
+	void BuildNode(int node, BuildItem* items, int first, int count, int depth);
+
+	// Triangles in tree order, so every leaf's triangles are next to each other
+	std::vector<Triangle> triangles_;
+	std::vector<Node> nodes_;
+
+};
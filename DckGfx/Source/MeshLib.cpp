@@ -7,11 +7,24 @@
 
 #include "MeshLib.h"
 #include "FileReader.h"
+#include "BinaryMesh.h"
+#include "ObjReader.h"
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <cfloat>
+#include <cstddef>
 
 static GLint posAttrib = 0;
 static GLint colorAttrib = 1;
 static GLint normalAttrib = 2;
 
+// Instance attribute locations, matrices take up a location per column
+static GLuint instanceModelAttrib = 3;
+static GLuint instanceNormalAttrib = 7;
+static GLuint instanceTintAttrib = 11;
+static GLuint instanceDiffuseAttrib = 12;
+static GLuint instanceSpecularAttrib = 13;
+
 static const glm::vec3 black(0.0f, 0.0f, 0.0f);
 
 // Vertices of the cube
@@ -81,38 +94,151 @@ static const glm::vec4 zDir = GfxMath::Point(0, 0, 1);
 
 static MeshLib meshLibrary;
 
+//*****************************************************************************
+//  Description:
+//		Sets up the per instance attributes on the currently bound vao. They
+//		read from the instance binding, which the render system binds its
+//		instance buffer to at draw time
+//*****************************************************************************
+static void SetInstanceAttribs()
+{
+	for (GLuint i = 0; i < 4; ++i)
+	{
+		glVertexAttribFormat(instanceModelAttrib + i, 4, GL_FLOAT, GL_FALSE, offsetof(RenderInstance, objToWorld) + sizeof(glm::vec4) * i);
+		glVertexAttribBinding(instanceModelAttrib + i, instanceBinding);
+		glEnableVertexAttribArray(instanceModelAttrib + i);
+
+		glVertexAttribFormat(instanceNormalAttrib + i, 4, GL_FLOAT, GL_FALSE, offsetof(RenderInstance, normalMat) + sizeof(glm::vec4) * i);
+		glVertexAttribBinding(instanceNormalAttrib + i, instanceBinding);
+		glEnableVertexAttribArray(instanceNormalAttrib + i);
+	}
+
+	glVertexAttribFormat(instanceTintAttrib, 3, GL_FLOAT, GL_FALSE, offsetof(RenderInstance, tint));
+	glVertexAttribBinding(instanceTintAttrib, instanceBinding);
+	glEnableVertexAttribArray(instanceTintAttrib);
+
+	glVertexAttribFormat(instanceDiffuseAttrib, 3, GL_FLOAT, GL_FALSE, offsetof(RenderInstance, diffuse));
+	glVertexAttribBinding(instanceDiffuseAttrib, instanceBinding);
+	glEnableVertexAttribArray(instanceDiffuseAttrib);
+
+	glVertexAttribFormat(instanceSpecularAttrib, 4, GL_FLOAT, GL_FALSE, offsetof(RenderInstance, specular));
+	glVertexAttribBinding(instanceSpecularAttrib, instanceBinding);
+	glEnableVertexAttribArray(instanceSpecularAttrib);
+
+	// Advance once per instance instead of once per vertex
+	glVertexBindingDivisor(instanceBinding, 1);
+}
+
 // Mesh Object that handles purely VAO stuff
 
-DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
+DckMesh::DckMesh() : isReady_(false),
+	hasNormals_(false),
 	buffers_(),
 	pointVao_(0),
 	edgeVao_(0),
 	faceVao_(0),
 	pointCount_(0),
 	edgeCount_(0),
-	faceCount_(0)
+	faceCount_(0),
+	boundsMin_(0),
+	boundsMax_(0),
+	boundingCenter_(0),
+	boundingRadius_(0),
+	pickTree_(nullptr)
+{
+}
+
+DckMesh::DckMesh(Mesh* mesh) : DckMesh(mesh->GetView())
+{
+}
+
+DckMesh::DckMesh(const MeshView& mesh, MeshBvh* pickTree) : DckMesh()
+{
+	Upload(mesh, pickTree);
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds the triangle tree a mesh is picked with. Slow for big meshes,
+//		so it belongs wherever the mesh is being loaded, not on the frame
+//
+//	Param mesh:
+//		View of the cpu side mesh data
+//
+//	Return:
+//		Returns the tree to hand to Upload, or nullptr if the mesh has no
+//		faces and is picked by its bounding box instead
+//*****************************************************************************
+MeshBvh* DckMesh::BuildPickTree(const MeshView& mesh)
+{
+	if (mesh.faceCount <= 0)
+		return nullptr;
+	return new MeshBvh(mesh);
+}
+
+//*****************************************************************************
+//  Description:
+//		Uploads mesh data to OpenGL, after which the mesh is ready to render.
+//		Must be called on the thread with the GL context, and only once
+// 
+//	Param mesh:
+//		View of the cpu side mesh data to upload
+//
+//	Param pickTree:
+//		Tree to pick the mesh with from BuildPickTree, which the mesh takes
+//		ownership of. nullptr picks the mesh by its bounding box
+//*****************************************************************************
+void DckMesh::Upload(const MeshView& mesh, MeshBvh* pickTree)
 {
+	if (isReady_)
+	{
+		delete pickTree;
+		return;
+	}
+	DCK_PROFILE_ZONE("Mesh Upload");
+	pickTree_ = pickTree;
+
+	// Find the bounding box of the vertices, and a sphere around the center of it that holds them all
+	if (mesh.vertexCount > 0)
+	{
+		boundsMin_ = glm::vec3(mesh.vertices[0]);
+		boundsMax_ = glm::vec3(mesh.vertices[0]);
+		for (int i = 1; i < mesh.vertexCount; ++i)
+		{
+			boundsMin_ = glm::min(boundsMin_, glm::vec3(mesh.vertices[i]));
+			boundsMax_ = glm::max(boundsMax_, glm::vec3(mesh.vertices[i]));
+		}
+
+		boundingCenter_ = 0.5f * (boundsMin_ + boundsMax_);
+		float radiusSq = 0.0f;
+		for (int i = 0; i < mesh.vertexCount; ++i)
+		{
+			glm::vec3 offset = glm::vec3(mesh.vertices[i]) - boundingCenter_;
+			radiusSq = glm::max(radiusSq, glm::dot(offset, offset));
+		}
+		boundingRadius_ = glm::sqrt(radiusSq);
+	}
+
 	// Upload Vertex and Color data
 	glGenBuffers(1, &buffers_[VBO]);
 	glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * mesh->GetVertexCount(), mesh->GetVertices(), GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * mesh.vertexCount, mesh.vertices, GL_STATIC_DRAW);
 
 	glGenBuffers(1, &buffers_[CBO]);
 	glBindBuffer(GL_ARRAY_BUFFER, buffers_[CBO]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh->GetVertexCount(), mesh->GetColors(), GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * mesh.vertexCount, mesh.colors, GL_STATIC_DRAW);
 
 	// Upload Face Data if there are faces
-	if (mesh->GetFaceCount() > 0)
+	if (mesh.faceCount > 0)
 	{
-		faceCount_ = mesh->GetFaceCount();
+		faceCount_ = mesh.faceCount;
 		glGenBuffers(1, &buffers_[FaceEBO]);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[FaceEBO]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Mesh::Face) * mesh->GetFaceCount(), mesh->GetFaces(), GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Mesh::Face) * mesh.faceCount, mesh.faces, GL_STATIC_DRAW);
 	}
 
 	// Now decide what vao data we need to generate
-	NormalMesh* normalMesh = dynamic_cast<NormalMesh*>(mesh);
-	if (normalMesh)
+	if (mesh.normals)
 	{
 		// Mesh does have normals
 		hasNormals_ = true;
@@ -120,13 +246,14 @@ DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
 		// Generate normal buffer and upload normals
 		glGenBuffers(1, &buffers_[NBO]);
 		glBindBuffer(GL_ARRAY_BUFFER, buffers_[NBO]);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * normalMesh->GetVertexCount(), normalMesh->GetNormals(), GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * mesh.vertexCount, mesh.normals, GL_STATIC_DRAW);
 
 		// Create vao and upload data
 		glGenVertexArrays(1, &faceVao_);
 
 		// Bind the vertex array
 		glBindVertexArray(faceVao_);
+		SetInstanceAttribs();
 
 		// Bind the VBO, pass it to position attribute, and enable the attrib
 		glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
@@ -150,18 +277,19 @@ DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
 	else
 	{
 		// If there are point elements, generate the buffer and create the vao
-		if (mesh->GetPointCount() > 0)
+		if (mesh.pointCount > 0)
 		{
 			// Make sure to save the point count for later
-			pointCount_ = mesh->GetPointCount();
+			pointCount_ = mesh.pointCount;
 
 			glGenBuffers(1, &buffers_[PointEBO]);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[PointEBO]);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * mesh->GetPointCount(), mesh->GetPoints(), GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * mesh.pointCount, mesh.points, GL_STATIC_DRAW);
 
 			// Create point vao
 			glGenVertexArrays(1, &pointVao_);
 			glBindVertexArray(pointVao_);
+			SetInstanceAttribs();
 
 			// Upload the Vertex Data to the respective Attribute
 			glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
@@ -179,18 +307,19 @@ DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
 		}
 
 		// If there are edge elements, generate the buffer and the vao
-		if (mesh->GetEdgeCount() > 0)
+		if (mesh.edgeCount > 0)
 		{
 			// Make sure to get the edge count for later
-			edgeCount_ = mesh->GetEdgeCount();
+			edgeCount_ = mesh.edgeCount;
 
 			glGenBuffers(1, &buffers_[EdgeEBO]);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[EdgeEBO]);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Mesh::Edge) * mesh->GetEdgeCount(), mesh->GetEdges(), GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Mesh::Edge) * mesh.edgeCount, mesh.edges, GL_STATIC_DRAW);
 
 			// Generate the edge vao and upload data
 			glGenVertexArrays(1, &edgeVao_);
 			glBindVertexArray(edgeVao_);
+			SetInstanceAttribs();
 
 			// Upload vertex data to respective attrib
 			glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
@@ -210,6 +339,7 @@ DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
 		// Create the face vao
 		glGenVertexArrays(1, &faceVao_);
 		glBindVertexArray(faceVao_);
+		SetInstanceAttribs();
 
 		// Upload Vertex data
 		glBindBuffer(GL_ARRAY_BUFFER, buffers_[VBO]);
@@ -225,6 +355,13 @@ DckMesh::DckMesh(Mesh* mesh) : hasNormals_(false),
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[FaceEBO]);
 		glBindVertexArray(0);
 	}
+
+	isReady_ = true;
+}
+
+bool DckMesh::IsReady()
+{
+	return isReady_;
 }
 
 GLuint DckMesh::GetPointVAO()
@@ -262,8 +399,62 @@ bool DckMesh::HasNormals()
 	return hasNormals_;
 }
 
+glm::vec3 DckMesh::GetBoundsMin()
+{
+	return boundsMin_;
+}
+
+glm::vec3 DckMesh::GetBoundsMax()
+{
+	return boundsMax_;
+}
+
+glm::vec3 DckMesh::GetBoundingCenter()
+{
+	return boundingCenter_;
+}
+
+float DckMesh::GetBoundingRadius()
+{
+	return boundingRadius_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds where a ray first hits the mesh's triangles. Meshes without a
+//		pick tree are hit wherever the ray hits their bounding box
+//
+//	Param origin:
+//		Where the ray starts, in object space
+//
+//	Param dir:
+//		Which way the ray goes, distances are in multiples of its length
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Return:
+//		Returns how far along the ray the hit was, or a negative number if
+//		the ray misses or the mesh isn't ready
+//*****************************************************************************
+float DckMesh::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist)
+{
+	if (!isReady_)
+		return -1.0f;
+
+	if (pickTree_)
+		return pickTree_->RayCast(origin, dir, maxDist);
+
+	glm::vec3 invDir;
+	for (int axis = 0; axis < 3; ++axis)
+		invDir[axis] = dir[axis] != 0.0f ? 1.0f / dir[axis] : FLT_MAX;
+	return Aabb(boundsMin_, boundsMax_).RayDistance(origin, invDir, maxDist);
+}
+
 DckMesh::~DckMesh()
 {
+	delete pickTree_;
+
 	if (pointVao_)
 		glDeleteVertexArrays(1, &pointVao_);
 	if (edgeVao_)
@@ -280,14 +471,35 @@ DckMesh::~DckMesh()
 
 
 // Functions for interacting with the library
-void MeshLibraryInit()
+void MeshLibraryInit(JobSystem* jobSystem)
 {
+	meshLibrary.SetJobSystem(jobSystem);
 	meshLibrary.Initialize();
 }
 
-void MeshLibraryLoad(std::string meshName, Mesh* meshToLoad)
+void MeshLibraryLoad(std::string meshName, Mesh* meshToLoad, bool pickable)
+{
+	meshLibrary.LoadMesh(meshName, meshToLoad, pickable);
+}
+
+void MeshLibraryLoadBinary(std::string meshName, const char* filepath, bool pickable)
+{
+	meshLibrary.LoadBinaryMesh(meshName, filepath, pickable);
+}
+
+void MeshLibraryLoadObj(std::string meshName, const char* filepath, bool multithreaded, bool pickable)
+{
+	meshLibrary.LoadObjMesh(meshName, filepath, multithreaded, pickable);
+}
+
+DckMesh* MeshLibraryLoadAsync(std::string meshName, const char* filepath, bool buildNormals, bool pickable)
+{
+	return meshLibrary.LoadMeshAsync(meshName, filepath, buildNormals, pickable);
+}
+
+void MeshLibraryDeferUploads(bool defer)
 {
-	meshLibrary.LoadMesh(meshName, meshToLoad);
+	meshLibrary.SetDeferUploads(defer);
 }
 
 DckMesh* MeshLibraryGet(std::string meshName)
@@ -304,7 +516,8 @@ void MeshLibraryShutdown()
 // Mesh Data Library, which is managing the VAO data
 void MeshLib::Initialize()
 {
-	// Load any base meshes we want here. Going to make this read from a file at some point
+	// Load any base meshes we want here. Going to make this read from a file at some point.
+	// The Mesh objects here are cpu only staging data, DckMesh does all the uploading
 	// 
 	// Create the orientation mesh
 	Mesh* orientationMesh_ = new Mesh();
@@ -325,7 +538,7 @@ void MeshLib::Initialize()
 	orientationMesh_->AddEdge(2, 5);
 
 	// Load the mesh to the lib and delete the old mesh (don't need it)
-	LoadMesh("CamOMesh", orientationMesh_);
+	LoadMesh("CamOMesh", orientationMesh_, false);
 	delete orientationMesh_;
 
 	// Create and add a cube mesh to the library
@@ -346,10 +559,10 @@ void MeshLib::Initialize()
 	// Create normal inv mesh
 	Mesh* invNormCube = new NormalMesh(invCube);
 
-	// Add the meshes to the data library
-	LoadMesh(cube->GetName(), cube);
-	LoadMesh(normCube->GetName(), normCube);
-	LoadMesh(invNormCube->GetName(), invNormCube);
+	// Add the meshes to the data library, they are small enough to always pick by their triangles
+	LoadMesh(cube->GetName(), cube, true);
+	LoadMesh(normCube->GetName(), normCube, true);
+	LoadMesh(invNormCube->GetName(), invNormCube, true);
 
 	WriteMeshFile(cube);
 
@@ -384,12 +597,143 @@ void MeshLib::Shutdown()
 	meshes_.clear();
 }
 
-void MeshLib::LoadMesh(std::string meshName, Mesh* meshToLoad)
+void MeshLib::LoadMesh(std::string meshName, Mesh* meshToLoad, bool pickable)
+{
+	if (!meshToLoad)
+		return;
+
+	// The caller keeps its mesh, so the queued upload gets a copy of it
+	if (deferUploads_)
+		LoadMeshDeferred(meshName, new Mesh(*meshToLoad), pickable);
+	else
+		LoadMesh(meshName, meshToLoad->GetView(), pickable);
+}
+
+//*****************************************************************************
+//  Description:
+//		Uploads a mesh and adds it to the library
+//
+//	Param pickable:
+//		Whether to build a tree of the triangles to pick the mesh with. It
+//		costs a copy of every triangle, so big meshes that are never
+//		clicked on should leave it off and get picked by their bounds
+//*****************************************************************************
+void MeshLib::LoadMesh(std::string meshName, const MeshView& meshToLoad, bool pickable)
 {
 	auto search = meshes_.find(meshName);
 	if (search == meshes_.end())
 	{
-		DckMesh* newMesh = new DckMesh(meshToLoad);
+		DckMesh* newMesh = new DckMesh(meshToLoad, pickable ? DckMesh::BuildPickTree(meshToLoad) : nullptr);
 		AddObject(meshName, newMesh);
 	}
 }
+
+void MeshLib::LoadBinaryMesh(std::string meshName, const char* filepath, bool pickable)
+{
+	DCK_PROFILE_ZONE("Load Binary Mesh");
+	auto search = meshes_.find(meshName);
+	if (search != meshes_.end())
+		return;
+
+	// Mapping and uploading both happen on the loader's side when uploads are deferred
+	if (deferUploads_)
+	{
+		LoadMeshAsync(meshName, filepath, false, pickable);
+		return;
+	}
+
+	// Upload straight out of the mapped file, the mapping is closed once the buffers have the data
+	BinaryMesh binaryMesh;
+	if (binaryMesh.Open(filepath))
+		LoadMesh(meshName, binaryMesh.GetView(), pickable);
+}
+
+void MeshLib::LoadObjMesh(std::string meshName, const char* filepath, bool multithreaded, bool pickable)
+{
+	DCK_PROFILE_ZONE("Load Obj Mesh");
+	auto search = meshes_.find(meshName);
+	if (search != meshes_.end())
+		return;
+
+	// The imported mesh is only staging data, so it is deleted once it has been uploaded
+	Mesh* objMesh = ReadObjFile(filepath, multithreaded ? jobSystem_ : nullptr);
+	if (objMesh && deferUploads_)
+		LoadMeshDeferred(meshName, objMesh, pickable);
+	else if (objMesh)
+	{
+		LoadMesh(meshName, objMesh, pickable);
+		delete objMesh;
+	}
+}
+
+DckMesh* MeshLib::LoadMeshAsync(std::string meshName, const char* filepath, bool buildNormals, bool pickable)
+{
+	auto search = meshes_.find(meshName);
+	if (search != meshes_.end())
+		return search->second;
+
+	// Hand out the mesh right away, it won't be ready to render until the asset loader uploads it
+	DckMesh* pendingMesh = new DckMesh();
+	AddObject(meshName, pendingMesh);
+	AssetLoaderQueueMesh(pendingMesh, filepath, buildNormals, pickable);
+	return pendingMesh;
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets whether loads upload their mesh right away or queue the upload on
+//		the asset loader. Uploads have to be queued once the GL context belongs
+//		to the render thread
+//
+//	Param defer:
+//		Whether to queue uploads
+//*****************************************************************************
+void MeshLib::SetDeferUploads(bool defer)
+{
+	deferUploads_ = defer;
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets the job system that multithreaded file reads split their work
+//		across
+//
+//	Param jobSystem:
+//		The job system to use, nullptr to read on the calling thread
+//*****************************************************************************
+void MeshLib::SetJobSystem(JobSystem* jobSystem)
+{
+	jobSystem_ = jobSystem;
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a mesh that isn't ready yet and queues the upload of its data on
+//		the asset loader, which uploads it on the thread with the GL context
+//
+//	Param meshName:
+//		Name to add the mesh under
+//
+//	Param meshToLoad:
+//		The cpu side mesh data, the asset loader takes ownership of it
+//
+//	Param pickable:
+//		Whether to build a tree of the triangles to pick the mesh with
+//
+//	Return:
+//		Returns the mesh that will be uploaded to
+//*****************************************************************************
+DckMesh* MeshLib::LoadMeshDeferred(std::string meshName, Mesh* meshToLoad, bool pickable)
+{
+	auto search = meshes_.find(meshName);
+	if (search != meshes_.end())
+	{
+		delete meshToLoad;
+		return search->second;
+	}
+
+	DckMesh* pendingMesh = new DckMesh();
+	AddObject(meshName, pendingMesh);
+	AssetLoaderQueueUpload(pendingMesh, meshToLoad, pickable ? DckMesh::BuildPickTree(meshToLoad->GetView()) : nullptr);
+	return pendingMesh;
+}
\ No newline at end of file
@@ -8,7 +8,29 @@
 
 #include "Library.h"
 #include "Mesh.h"
+#include "MeshBvh.h"
 #include "glad/glad.h"
+#include <atomic>
+
+// Vertex buffer binding the per instance data is read from, after the position, color, and normal bindings
+static const GLuint instanceBinding = 3;
+
+//*****************************************************************************
+//  Description:
+//		Per instance data for instanced draws. Every DckMesh vao has instance
+//		attributes laid out to read this struct from the instance binding
+//*****************************************************************************
+class JobSystem;
+
+struct RenderInstance {
+	glm::mat4 objToWorld;
+	glm::mat4 normalMat;
+	glm::vec3 tint;
+	glm::vec3 diffuse;
+
+	// Specular coefficient in rgb and the specular exponent in w
+	glm::vec4 specular;
+};
 
 class DckMesh {
 public:
@@ -23,7 +45,14 @@ public:
 		BufferCount
 	};
 
+	DckMesh();
 	DckMesh(Mesh* mesh);
+	DckMesh(const MeshView& mesh, MeshBvh* pickTree = nullptr);
+
+	static MeshBvh* BuildPickTree(const MeshView& mesh);
+
+	void Upload(const MeshView& mesh, MeshBvh* pickTree = nullptr);
+	bool IsReady();
 
 	GLuint GetPointVAO();
 	GLuint GetEdgeVAO();
@@ -35,10 +64,20 @@ public:
 
 	bool HasNormals();
 
+	glm::vec3 GetBoundsMin();
+	glm::vec3 GetBoundsMax();
+	glm::vec3 GetBoundingCenter();
+	float GetBoundingRadius();
+
+	float RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist);
+
 	~DckMesh();
 
 private:
 
+	// False until the mesh data has been uploaded, async loads hand out the mesh before then.
+	// Atomic since the render thread can do the upload while the mesh is being used
+	std::atomic<bool> isReady_;
 	bool hasNormals_;
 
 	GLuint buffers_[BufferCount];
@@ -51,10 +90,24 @@ private:
 	int edgeCount_;
 	int faceCount_;
 
+	// Object space bounding box and sphere of the vertices, for culling
+	glm::vec3 boundsMin_;
+	glm::vec3 boundsMax_;
+	glm::vec3 boundingCenter_;
+	float boundingRadius_;
+
+	// Tree of the triangles for picking, only meshes loaded as pickable have one. It is built
+	// where the mesh is loaded and handed over with the upload
+	MeshBvh* pickTree_;
+
 };
 
-void MeshLibraryInit();
-void MeshLibraryLoad(std::string meshName, Mesh* meshToLoad);
+void MeshLibraryInit(JobSystem* jobSystem = nullptr);
+void MeshLibraryLoad(std::string meshName, Mesh* meshToLoad, bool pickable = false);
+void MeshLibraryLoadBinary(std::string meshName, const char* filepath, bool pickable = false);
+void MeshLibraryLoadObj(std::string meshName, const char* filepath, bool multithreaded = false, bool pickable = false);
+DckMesh* MeshLibraryLoadAsync(std::string meshName, const char* filepath, bool buildNormals = false, bool pickable = false);
+void MeshLibraryDeferUploads(bool defer);
 DckMesh* MeshLibraryGet(std::string meshName);
 void MeshLibraryShutdown();
 
@@ -66,10 +119,25 @@ public:
 	DckMesh* GetObject(std::string objName) override;
 	void Shutdown() override;
 
-	void LoadMesh(std::string meshName, Mesh* meshToLoad);
+	void LoadMesh(std::string meshName, Mesh* meshToLoad, bool pickable);
+	void LoadMesh(std::string meshName, const MeshView& meshToLoad, bool pickable);
+	void LoadBinaryMesh(std::string meshName, const char* filepath, bool pickable);
+	void LoadObjMesh(std::string meshName, const char* filepath, bool multithreaded, bool pickable);
+	DckMesh* LoadMeshAsync(std::string meshName, const char* filepath, bool buildNormals, bool pickable);
+
+	void SetDeferUploads(bool defer);
+	void SetJobSystem(JobSystem* jobSystem);
 
 private:
 
+	DckMesh* LoadMeshDeferred(std::string meshName, Mesh* meshToLoad, bool pickable);
+
 	std::map<std::string, DckMesh*> meshes_;
 
+	// When the GL context belongs to the render thread, loads queue their upload instead of doing it
+	bool deferUploads_ = false;
+
+	// Job system multithreaded file reads are split across, nullptr reads on the calling thread
+	JobSystem* jobSystem_ = nullptr;
+
 };
\ No newline at end of file
@@ -0,0 +1,569 @@
+//*****************************************************************************
+//	File:   ObjReader.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Wavefront OBJ importer. The file is read a block at a time so
+//		only one block of text is ever in memory, and each block can be split
+//		into line aligned chunks that get parsed as jobs. Chunks
+//		are merged in file order, which is where indices get resolved and
+//		vertices get welded
+//*****************************************************************************
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include "ObjReader.h"
+#include "JobSystem.h"
+
+// How much of the file is read in at a time
+static const size_t objBlockSize = 1 << 22;
+
+// How many bytes each job parses when a block is split up. Kept small, since the jobs
+// share threads with the frame and whichever thread picks one up is stuck with it
+static const size_t objParallelChunkSize = 1 << 18;
+
+// OBJ files don't have to have colors, so anything without one is black
+static const glm::vec3 objDefaultColor(0, 0, 0);
+
+//*****************************************************************************
+//  Description:
+//		A single corner of a point, line, or face. Negative OBJ indices are
+//		relative to how many positions/normals came before them, which a
+//		chunk can't know until it is merged, so those are flagged as relative
+//		to the start of the chunk
+//*****************************************************************************
+struct ObjCorner {
+	enum Flags {
+		PositionRelative = 1 << 0,
+		NormalRelative = 1 << 1,
+		HasNormal = 1 << 2
+	};
+
+	int position;
+	int normal;
+	unsigned int flags;
+};
+
+//*****************************************************************************
+//  Description:
+//		A point, line, or face element and how many corners it has
+//*****************************************************************************
+struct ObjElement {
+	enum Type {
+		Point,
+		Line,
+		Face
+	};
+
+	Type type;
+	unsigned int cornerCount;
+};
+
+//*****************************************************************************
+//  Description:
+//		Everything parsed out of one chunk of the file, in file order
+//*****************************************************************************
+struct ObjChunk {
+	std::vector<glm::vec4> positions;
+	std::vector<glm::vec3> colors;
+	std::vector<glm::vec4> normals;
+	std::vector<ObjCorner> corners;
+	std::vector<ObjElement> elements;
+	bool failed;
+
+	void Clear()
+	{
+		// Clearing keeps the capacity, so chunks get reused between blocks without reallocating
+		positions.clear();
+		colors.clear();
+		normals.clear();
+		corners.clear();
+		elements.clear();
+		failed = false;
+	}
+};
+
+//*****************************************************************************
+//  Description:
+//		The mesh being built as chunks are merged in, along with the raw OBJ
+//		data that indices refer to
+//*****************************************************************************
+struct ObjBuilder {
+	std::vector<glm::vec4> positions;
+	std::vector<glm::vec3> positionColors;
+	std::vector<glm::vec4> normals;
+
+	// Maps a position/normal pair to the mesh vertex made for it
+	std::unordered_map<uint64_t, unsigned int> welded;
+
+	std::vector<glm::vec4> vertices;
+	std::vector<glm::vec3> colors;
+	std::vector<glm::vec4> vertexNormals;
+	std::vector<unsigned int> points;
+	std::vector<Mesh::Edge> edges;
+	std::vector<Mesh::Face> faces;
+	bool anyNormals;
+};
+
+//*****************************************************************************
+//	Description:
+//		Skips spaces and tabs, but not line endings
+//*****************************************************************************
+static void SkipSpaces(const char*& curr, const char* end)
+{
+	while (curr < end && (*curr == ' ' || *curr == '\t' || *curr == '\r'))
+		++curr;
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses the next number on the line
+//
+//	Return:
+//		Returns true if a number was parsed
+//*****************************************************************************
+template <typename T>
+static bool ParseObjValue(const char*& curr, const char* end, T& value)
+{
+	SkipSpaces(curr, end);
+	if (curr < end && *curr == '+')
+		++curr;
+
+	std::from_chars_result result = std::from_chars(curr, end, value);
+	if (result.ec != std::errc())
+		return false;
+
+	curr = result.ptr;
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses a v, v/vt, v//vn, or v/vt/vn corner. Texture coordinates are
+//		skipped since meshes don't have them
+//
+//	Param curr:
+//		The current position in the line, moved past the corner
+//
+//	Param end:
+//		The end of the line
+//
+//	Param chunk:
+//		The chunk the corner is in, used to resolve negative indices
+//
+//	Param corner:
+//		Where to put the parsed corner
+//
+//	Return:
+//		Returns true if a corner was parsed
+//*****************************************************************************
+static bool ParseObjCorner(const char*& curr, const char* end, const ObjChunk& chunk, ObjCorner& corner)
+{
+	int position = 0;
+	if (!ParseObjValue(curr, end, position) || position == 0)
+		return false;
+
+	corner.flags = 0;
+	corner.normal = 0;
+	if (position < 0)
+	{
+		corner.position = static_cast<int>(chunk.positions.size()) + position;
+		corner.flags |= ObjCorner::PositionRelative;
+	}
+	else
+		corner.position = position - 1;
+
+	if (curr >= end || *curr != '/')
+		return true;
+	++curr;
+
+	// Skip over the texture coordinate if there is one
+	if (curr < end && *curr != '/')
+	{
+		int texCoord = 0;
+		if (!ParseObjValue(curr, end, texCoord))
+			return false;
+	}
+
+	if (curr >= end || *curr != '/')
+		return true;
+	++curr;
+
+	int normal = 0;
+	if (!ParseObjValue(curr, end, normal) || normal == 0)
+		return false;
+
+	corner.flags |= ObjCorner::HasNormal;
+	if (normal < 0)
+	{
+		corner.normal = static_cast<int>(chunk.normals.size()) + normal;
+		corner.flags |= ObjCorner::NormalRelative;
+	}
+	else
+		corner.normal = normal - 1;
+
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses every line of a chunk of the file into the chunk's arrays.
+//		Lines this importer doesn't use (vt, o, g, usemtl, comments, ...)
+//		are skipped
+//
+//	Param curr:
+//		The start of the chunk, which must be the start of a line
+//
+//	Param end:
+//		The end of the chunk, which must be the end of a line
+//
+//	Param chunk:
+//		The chunk to parse into
+//*****************************************************************************
+static void ParseObjChunk(const char* curr, const char* end, ObjChunk* chunk)
+{
+	chunk->Clear();
+
+	while (curr < end)
+	{
+		const char* lineEnd = static_cast<const char*>(memchr(curr, '\n', end - curr));
+		if (!lineEnd)
+			lineEnd = end;
+
+		const char* line = curr;
+		curr = lineEnd < end ? lineEnd + 1 : end;
+
+		SkipSpaces(line, lineEnd);
+		if (line >= lineEnd)
+			continue;
+
+		// Figure out what kind of line this is from the keyword at the start
+		const char* keyword = line;
+		while (line < lineEnd && *line != ' ' && *line != '\t')
+			++line;
+		size_t keywordLength = line - keyword;
+
+		if (keywordLength == 1 && keyword[0] == 'v')
+		{
+			glm::vec4 position(0, 0, 0, 1);
+			if (!ParseObjValue(line, lineEnd, position.x) || !ParseObjValue(line, lineEnd, position.y) ||
+				!ParseObjValue(line, lineEnd, position.z))
+			{
+				chunk->failed = true;
+				return;
+			}
+
+			// Some exporters put a vertex color after the position
+			glm::vec3 color = objDefaultColor;
+			glm::vec3 readColor;
+			if (ParseObjValue(line, lineEnd, readColor.r) && ParseObjValue(line, lineEnd, readColor.g) &&
+				ParseObjValue(line, lineEnd, readColor.b))
+				color = readColor;
+
+			chunk->positions.push_back(position);
+			chunk->colors.push_back(color);
+		}
+		else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 'n')
+		{
+			glm::vec4 normal(0, 0, 0, 0);
+			if (!ParseObjValue(line, lineEnd, normal.x) || !ParseObjValue(line, lineEnd, normal.y) ||
+				!ParseObjValue(line, lineEnd, normal.z))
+			{
+				chunk->failed = true;
+				return;
+			}
+			chunk->normals.push_back(normal);
+		}
+		else if (keywordLength == 1 && (keyword[0] == 'f' || keyword[0] == 'l' || keyword[0] == 'p'))
+		{
+			ObjElement element;
+			element.type = keyword[0] == 'f' ? ObjElement::Face : (keyword[0] == 'l' ? ObjElement::Line : ObjElement::Point);
+			element.cornerCount = 0;
+
+			SkipSpaces(line, lineEnd);
+			while (line < lineEnd && *line != '#')
+			{
+				ObjCorner corner;
+				if (!ParseObjCorner(line, lineEnd, *chunk, corner))
+				{
+					chunk->failed = true;
+					return;
+				}
+				chunk->corners.push_back(corner);
+				++element.cornerCount;
+				SkipSpaces(line, lineEnd);
+			}
+			chunk->elements.push_back(element);
+		}
+	}
+}
+
+//*****************************************************************************
+//	Description:
+//		Gets the mesh vertex for a corner, making a new one the first time a
+//		position/normal pair is seen
+//
+//	Param builder:
+//		The mesh being built
+//
+//	Param corner:
+//		The corner to get the vertex of
+//
+//	Param positionBase:
+//		How many positions came before the corner's chunk
+//
+//	Param normalBase:
+//		How many normals came before the corner's chunk
+//
+//	Param vertex:
+//		Where to put the index of the vertex
+//
+//	Return:
+//		Returns false if the corner refers to data that doesn't exist
+//*****************************************************************************
+static bool WeldObjCorner(ObjBuilder* builder, const ObjCorner& corner, int positionBase, int normalBase, unsigned int& vertex)
+{
+	int position = corner.position + ((corner.flags & ObjCorner::PositionRelative) ? positionBase : 0);
+	if (position < 0 || position >= static_cast<int>(builder->positions.size()))
+		return false;
+
+	// Normal index is stored off by one, so zero can mean there isn't one
+	uint64_t normalKey = 0;
+	int normal = 0;
+	if (corner.flags & ObjCorner::HasNormal)
+	{
+		normal = corner.normal + ((corner.flags & ObjCorner::NormalRelative) ? normalBase : 0);
+		if (normal < 0 || normal >= static_cast<int>(builder->normals.size()))
+			return false;
+		normalKey = static_cast<uint64_t>(normal) + 1;
+	}
+
+	uint64_t key = (static_cast<uint64_t>(position) << 32) | normalKey;
+	auto search = builder->welded.find(key);
+	if (search != builder->welded.end())
+	{
+		vertex = search->second;
+		return true;
+	}
+
+	vertex = static_cast<unsigned int>(builder->vertices.size());
+	builder->vertices.push_back(builder->positions[position]);
+	builder->colors.push_back(builder->positionColors[position]);
+	if (normalKey)
+	{
+		builder->vertexNormals.push_back(builder->normals[normal]);
+		builder->anyNormals = true;
+	}
+	else
+		builder->vertexNormals.push_back(glm::vec4(0, 0, 0, 0));
+
+	builder->welded.insert(std::pair<uint64_t, unsigned int>(key, vertex));
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Merges a parsed chunk into the mesh being built. Faces are triangulated
+//		as a fan around their first corner, and lines become one edge per
+//		segment
+//
+//	Param builder:
+//		The mesh being built
+//
+//	Param chunk:
+//		The chunk to merge, must be merged in file order
+//
+//	Return:
+//		Returns false if the chunk refers to data that doesn't exist
+//*****************************************************************************
+static bool MergeObjChunk(ObjBuilder* builder, const ObjChunk& chunk)
+{
+	int positionBase = static_cast<int>(builder->positions.size());
+	int normalBase = static_cast<int>(builder->normals.size());
+
+	builder->positions.insert(builder->positions.end(), chunk.positions.begin(), chunk.positions.end());
+	builder->positionColors.insert(builder->positionColors.end(), chunk.colors.begin(), chunk.colors.end());
+	builder->normals.insert(builder->normals.end(), chunk.normals.begin(), chunk.normals.end());
+
+	std::vector<unsigned int> elementVertices;
+	size_t cornerIndex = 0;
+	for (const ObjElement& element : chunk.elements)
+	{
+		elementVertices.resize(element.cornerCount);
+		for (unsigned int i = 0; i < element.cornerCount; ++i)
+		{
+			if (!WeldObjCorner(builder, chunk.corners[cornerIndex + i], positionBase, normalBase, elementVertices[i]))
+				return false;
+		}
+		cornerIndex += element.cornerCount;
+
+		if (element.type == ObjElement::Face)
+		{
+			for (unsigned int i = 1; i + 1 < element.cornerCount; ++i)
+				builder->faces.push_back(Mesh::Face(elementVertices[0], elementVertices[i], elementVertices[i + 1]));
+		}
+		else if (element.type == ObjElement::Line)
+		{
+			for (unsigned int i = 0; i + 1 < element.cornerCount; ++i)
+				builder->edges.push_back(Mesh::Edge(elementVertices[i], elementVertices[i + 1]));
+		}
+		else
+			builder->points.insert(builder->points.end(), elementVertices.begin(), elementVertices.end());
+	}
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Parses a block of whole lines, splitting it into jobs if it is big
+//		enough, then merges the results in order
+//
+//	Param begin:
+//		The start of the block
+//
+//	Param end:
+//		The end of the block
+//
+//	Param chunks:
+//		The chunks to parse into, grown if more are needed
+//
+//	Param jobSystem:
+//		Job system to parse the chunks on, nullptr to parse on this thread
+//
+//	Param builder:
+//		The mesh being built
+//
+//	Return:
+//		Returns true if the block was parsed and merged
+//*****************************************************************************
+static bool ParseObjBlock(const char* begin, const char* end, std::vector<ObjChunk>* chunks, JobSystem* jobSystem, ObjBuilder* builder)
+{
+	size_t size = end - begin;
+	size_t chunkCount = std::max<size_t>(1, size / objParallelChunkSize);
+	if (!jobSystem || jobSystem->GetThreadCount() == 1)
+		chunkCount = 1;
+	if (chunks->size() < chunkCount)
+		chunks->resize(chunkCount);
+
+	// Split the block up on line endings
+	std::vector<const char*> chunkStarts(chunkCount + 1);
+	chunkStarts[0] = begin;
+	chunkStarts[chunkCount] = end;
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		const char* split = std::max(chunkStarts[i - 1], begin + size * i / chunkCount);
+		const char* lineEnd = static_cast<const char*>(memchr(split, '\n', end - split));
+		chunkStarts[i] = lineEnd ? lineEnd + 1 : end;
+	}
+
+	// Every chunk after the first is its own job, the first chunk is parsed here while they run
+	JobCounter counter(0);
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		const char* chunkBegin = chunkStarts[i];
+		const char* chunkEnd = chunkStarts[i + 1];
+		ObjChunk* chunk = &(*chunks)[i];
+		jobSystem->Run([chunkBegin, chunkEnd, chunk]() { ParseObjChunk(chunkBegin, chunkEnd, chunk); }, &counter);
+	}
+	ParseObjChunk(chunkStarts[0], chunkStarts[1], &(*chunks)[0]);
+	if (jobSystem)
+		jobSystem->Wait(&counter);
+
+	for (size_t i = 0; i < chunkCount; ++i)
+	{
+		if ((*chunks)[i].failed || !MergeObjChunk(builder, (*chunks)[i]))
+			return false;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//	Description:
+//		Reads a Wavefront OBJ file into a mesh. Only one block of the file's
+//		text is held in memory at a time. Vertices that share a position and
+//		normal are welded, and the mesh only gets normals if the file had them
+//
+//	Param filepath:
+//		The filepath of the OBJ file to read
+//
+//	Param jobSystem:
+//		Job system to split each block of the file across, nullptr to parse
+//		everything on the calling thread
+//
+//	Return:
+//		Returns the mesh that was read, or nullptr if the file couldn't be read
+//*****************************************************************************
+Mesh* ReadObjFile(const char* filepath, JobSystem* jobSystem)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "Failed to read from file: " << filepath << std::endl;
+		return nullptr;
+	}
+
+	std::vector<ObjChunk> chunks;
+	ObjBuilder builder;
+	builder.anyNormals = false;
+
+	// Partial line at the end of a block is carried over to the start of the next one
+	std::vector<char> block(objBlockSize);
+	size_t carried = 0;
+	bool worked = true;
+	while (worked)
+	{
+		// A line bigger than the whole block needs a bigger block
+		if (carried == block.size())
+			block.resize(block.size() * 2);
+
+		file.read(block.data() + carried, block.size() - carried);
+		size_t filled = carried + static_cast<size_t>(file.gcount());
+		bool lastBlock = !file;
+
+		// Only parse up to the last full line, unless this is the end of the file
+		size_t parseSize = filled;
+		if (!lastBlock)
+		{
+			parseSize = filled;
+			while (parseSize > 0 && block[parseSize - 1] != '\n')
+				--parseSize;
+		}
+
+		if (parseSize > 0)
+			worked = ParseObjBlock(block.data(), block.data() + parseSize, &chunks, jobSystem, &builder);
+
+		if (lastBlock)
+			break;
+
+		carried = filled - parseSize;
+		memmove(block.data(), block.data() + parseSize, carried);
+	}
+
+	if (!worked)
+	{
+		std::cout << "Failed to parse OBJ file: " << filepath << std::endl;
+		return nullptr;
+	}
+
+	// Name the mesh after the file
+	std::string name(filepath);
+	size_t slash = name.find_last_of("/\\");
+	if (slash != std::string::npos)
+		name = name.substr(slash + 1);
+	size_t dot = name.find_last_of('.');
+	if (dot != std::string::npos)
+		name = name.substr(0, dot);
+
+	Mesh* readMesh = new Mesh(name);
+	readMesh->SetVertices(std::move(builder.vertices), std::move(builder.colors));
+	if (builder.anyNormals)
+		readMesh->SetNormals(std::move(builder.vertexNormals));
+	readMesh->SetPoints(std::move(builder.points));
+	readMesh->SetEdges(std::move(builder.edges));
+	readMesh->SetFaces(std::move(builder.faces));
+	return readMesh;
+}
@@ -0,0 +1,15 @@
+#pragma once
+//*****************************************************************************
+//	File:   ObjReader.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Wavefront OBJ importer. Streams the file in fixed size blocks
+//		and builds a Mesh out of it, welding duplicate position/normal pairs
+//		and triangulating any polygons with more than three corners
+//*****************************************************************************
+
+#include "Mesh.h"
+
+class JobSystem;
+
+Mesh* ReadObjFile(const char* filepath, JobSystem* jobSystem = nullptr);
@@ -7,73 +7,193 @@
 //*****************************************************************************
 
 #include "ObjectManagerSystem.h"
-#include <queue>
+#include "Engine.h"
+#include "Profiler.h"
 
-ObjectManagerSystem::ObjectManagerSystem() : System(ObjectManagerSys)
-{
+// How much dynamic bounds are grown by, as a fraction of their size, so small moves don't change the tree
+static const float dynamicMargin = 0.1f;
 
+ObjectManagerSystem::ObjectManagerSystem() : System(Type),
+	objects_(),
+	names_(),
+	staticTree_(0.0f),
+	dynamicTree_(dynamicMargin),
+	staticDirty_(false),
+	bounds_(),
+	staticObjects_(),
+	dynamicObjects_(),
+	nodeObjects_(),
+	queryProxies_(),
+	jobSystem_(nullptr),
+	renderSys_(nullptr)
+{
+	// Objects are culled against the camera after it moves
+	RunsAfter(CameraSys);
 }
 
 void ObjectManagerSystem::Initialize()
 {
-
+	jobSystem_ = GetParent()->GetJobSystem();
+	renderSys_ = GetParent()->Get<RenderSystem>();
 }
 
 void ObjectManagerSystem::Update(float dt)
 {
-	// Keep track of all objects removed from the list
-	std::queue<std::vector<RenderObject*>::iterator> itrQueue;
-	
-	// Go through the list and delete any objects marked for deletion
-	unsigned int size = objects_.size();
-	for (int i = 0; i < size; ++i)
+	// Rebuild the matrices of every transform that changed first, then carry them down to any children,
+	// both split across threads
+	SceneGraph* graph = SceneGraphGet();
+	TransformStoreGet()->Update(jobSystem_);
+	graph->Update(jobSystem_);
+
+	// Move the bounds of everything that moved
+	{
+		DCK_PROFILE_ZONE("Update Bounds");
+		int updatedCount = graph->GetUpdatedCount();
+		for (int i = 0; i < updatedCount; ++i)
+		{
+			SceneNode node = graph->GetUpdatedNode(i);
+			if (node.index >= nodeObjects_.size())
+				continue;
+
+			RenderObject** object = objects_.Get(nodeObjects_[node.index]);
+			if (object && (*object)->GetNode() == node)
+				UpdateBounds(static_cast<int>(object - objects_.Data()));
+		}
+	}
+
+	// Objects marked for deletion are removed as they're found, which moves the last object into their
+	// place to be looked at next. Anything that got a new mesh, finished loading or became static or
+	// dynamic has its bounds redone
+	int i = 0;
+	while (i < static_cast<int>(objects_.Size()))
 	{
 		RenderObject* currObj = objects_[i];
-		if (currObj)
+		if (currObj->IsDestroyed())
 		{
-			currObj->Draw();
-			if (currObj->IsDestroyed())
-			{
-				itrQueue.push(objects_.begin() + i);
-				delete currObj;
-				objects_[i] = nullptr;
-			}
+			RemoveAt(i);
+			continue;
 		}
+
+		const ObjectBounds& bounds = bounds_[objects_.GetHandle(i).index];
+		DckMesh* mesh = currObj->GetMesh();
+		if (bounds.mesh != mesh || bounds.inStatic != currObj->IsStatic() || (bounds.proxy < 0 && mesh && mesh->IsReady()))
+			UpdateBounds(i);
+		++i;
 	}
 
-	// Now remove all spaces that had objects in them
-	while (!itrQueue.empty())
+	// Drawing stays on this thread since the render queues are not thread safe. With a camera to cull
+	// against, only what the trees find is drawn
+	const Frustum* frustum = renderSys_ ? renderSys_->GetFrustum() : nullptr;
+	if (frustum)
+		DrawVisible(*frustum);
+	else
 	{
-		auto currItr = itrQueue.front();
-		itrQueue.pop();
-		objects_.erase(currItr);
+		for (RenderObject* object : objects_)
+			object->Draw();
 	}
 }
 
 void ObjectManagerSystem::Shutdown()
 {
 	for (RenderObject* object : objects_)
-	{
-		if (object)
-			delete object;
-	}
-	objects_.clear();
+		delete object;
+	objects_.Clear();
+	names_.clear();
+
+	staticTree_.Clear();
+	dynamicTree_.Clear();
+	staticDirty_ = false;
+	bounds_.clear();
+	staticObjects_.clear();
+	dynamicObjects_.clear();
+	nodeObjects_.clear();
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds an object to the manager, which owns it from then on
+//
+//	Param obj:
+//		The object to add
+//
+//	Return:
+//		Returns the handle to the object, or an invalid handle if it was null
+//*****************************************************************************
+ObjectHandle ObjectManagerSystem::AddObject(RenderObject* obj)
+{
+	if (!obj)
+		return ObjectHandle();
+
+	ObjectHandle handle = objects_.Add(obj);
+	names_.emplace(obj->GetName(), handle);
+
+	// Bounds are made on the next update, once the scene graph has the object's world matrix
+	if (handle.index >= bounds_.size())
+		bounds_.resize(handle.index + 1);
+	bounds_[handle.index] = ObjectBounds();
+
+	SceneNode node = obj->GetNode();
+	if (node.index >= nodeObjects_.size())
+		nodeObjects_.resize(node.index + 1);
+	nodeObjects_[node.index] = handle;
+	return handle;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets an object by its handle
+//
+//	Return:
+//		Returns the object, or nullptr if it was removed
+//*****************************************************************************
+RenderObject* ObjectManagerSystem::GetObject(ObjectHandle handle)
+{
+	RenderObject** object = objects_.Get(handle);
+	return object ? *object : nullptr;
 }
 
-void ObjectManagerSystem::AddObject(RenderObject* obj)
+//*****************************************************************************
+//  Description:
+//		Gets an object by its name
+//
+//	Return:
+//		Returns an object with the name, or nullptr if there isn't one
+//*****************************************************************************
+RenderObject* ObjectManagerSystem::GetObject(const std::string& name)
 {
-	if (obj)
-		objects_.push_back(obj);
+	return GetObject(GetHandle(name));
 }
 
-RenderObject* ObjectManagerSystem::GetObject(std::string name)
+ObjectHandle ObjectManagerSystem::GetHandle(const std::string& name)
 {
-	for (RenderObject* object : objects_)
-	{
-		if (object->GetName() == name)
-			return object;
-	}
-	return nullptr;
+	auto result = names_.find(name);
+	if (result != names_.end())
+		return result->second;
+	return ObjectHandle();
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the handle of an object by where it is in GetAllObjects
+//*****************************************************************************
+ObjectHandle ObjectManagerSystem::GetHandle(int index)
+{
+	return objects_.GetHandle(index);
+}
+
+//*****************************************************************************
+//  Description:
+//		Removes and deletes an object right away, instead of waiting for the
+//		next update like Destroy does
+//
+//	Param handle:
+//		Handle to the object, nothing happens if it was already removed
+//*****************************************************************************
+void ObjectManagerSystem::RemoveObject(ObjectHandle handle)
+{
+	RenderObject** object = objects_.Get(handle);
+	if (object)
+		RemoveAt(static_cast<int>(object - objects_.Data()));
 }
 
 void ObjectManagerSystem::ClearManager()
@@ -83,13 +203,282 @@ void ObjectManagerSystem::ClearManager()
 
 RenderObject** ObjectManagerSystem::GetAllObjects()
 {
-	if (objects_.size() > 0)
-		return &(objects_[0]);
+	return objects_.Data();
 }
 
 int ObjectManagerSystem::GetCount()
 {
-	return objects_.size();
+	return static_cast<int>(objects_.Size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds every object that could be seen in a frustum, as of the last
+//		update
+//
+//	Param frustum:
+//		The frustum to check against
+//
+//	Param results:
+//		Handles to the objects are added to this
+//*****************************************************************************
+void ObjectManagerSystem::QueryFrustum(const Frustum& frustum, std::vector<ObjectHandle>& results)
+{
+	UpdateTrees();
+
+	queryProxies_.clear();
+	staticTree_.QueryFrustum(frustum, queryProxies_);
+	GatherResults(queryProxies_, staticObjects_, results);
+
+	queryProxies_.clear();
+	dynamicTree_.QueryFrustum(frustum, queryProxies_);
+	GatherResults(queryProxies_, dynamicObjects_, results);
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds every object whose bounds touch a sphere, as of the last update
+//
+//	Param center:
+//		The center of the sphere in world space
+//
+//	Param radius:
+//		The radius of the sphere
+//
+//	Param results:
+//		Handles to the objects are added to this
+//*****************************************************************************
+void ObjectManagerSystem::QuerySphere(const glm::vec3& center, float radius, std::vector<ObjectHandle>& results)
+{
+	UpdateTrees();
+
+	queryProxies_.clear();
+	staticTree_.QuerySphere(center, radius, queryProxies_);
+	GatherResults(queryProxies_, staticObjects_, results);
+
+	queryProxies_.clear();
+	dynamicTree_.QuerySphere(center, radius, queryProxies_);
+	GatherResults(queryProxies_, dynamicObjects_, results);
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds every object whose bounds overlap a box, as of the last update
+//
+//	Param box:
+//		The box in world space
+//
+//	Param results:
+//		Handles to the objects are added to this
+//*****************************************************************************
+void ObjectManagerSystem::QueryBox(const Aabb& box, std::vector<ObjectHandle>& results)
+{
+	UpdateTrees();
+
+	queryProxies_.clear();
+	staticTree_.QueryBox(box, queryProxies_);
+	GatherResults(queryProxies_, staticObjects_, results);
+
+	queryProxies_.clear();
+	dynamicTree_.QueryBox(box, queryProxies_);
+	GatherResults(queryProxies_, dynamicObjects_, results);
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds the closest object a ray hits, as of the last update. The trees
+//		find the objects whose bounds the ray passes through, closest first,
+//		and only those have their meshes checked
+//
+//	Param origin:
+//		Where the ray starts in world space
+//
+//	Param dir:
+//		Which way the ray goes, distances are in multiples of its length
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Param hitDist:
+//		Set to how far along the ray the hit was, or a negative number if
+//		nothing was hit, if not null
+//
+//	Return:
+//		Returns the handle to the object, or an invalid handle if nothing
+//		was hit
+//*****************************************************************************
+ObjectHandle ObjectManagerSystem::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, float* hitDist)
+{
+	DCK_PROFILE_ZONE("Ray Cast Objects");
+	UpdateTrees();
+
+	auto hitStatic = [&](int proxy, float dist) {
+		return (*objects_.Get(staticObjects_[proxy]))->RayCast(origin, dir, dist);
+	};
+	auto hitDynamic = [&](int proxy, float dist) {
+		return (*objects_.Get(dynamicObjects_[proxy]))->RayCast(origin, dir, dist);
+	};
+
+	ObjectHandle hit;
+	float closest = -1.0f;
+	int staticProxy;
+	float staticDist = staticTree_.RayCast(origin, dir, maxDist, hitStatic, &staticProxy);
+	if (staticDist >= 0.0f)
+	{
+		hit = staticObjects_[staticProxy];
+		closest = staticDist;
+		maxDist = staticDist;
+	}
+
+	int dynamicProxy;
+	float dynamicDist = dynamicTree_.RayCast(origin, dir, maxDist, hitDynamic, &dynamicProxy);
+	if (dynamicDist >= 0.0f)
+	{
+		hit = dynamicObjects_[dynamicProxy];
+		closest = dynamicDist;
+	}
+
+	if (hitDist)
+		*hitDist = closest;
+	return hit;
+}
+
+//*****************************************************************************
+//  Description:
+//		Deletes the object at a place in the packed objects and takes it out
+//		of the name index. The last object moves into its place
+//*****************************************************************************
+void ObjectManagerSystem::RemoveAt(int index)
+{
+	RenderObject* object = objects_[index];
+	ObjectHandle handle = objects_.GetHandle(index);
+
+	auto range = names_.equal_range(object->GetName());
+	for (auto itr = range.first; itr != range.second; ++itr)
+	{
+		if (itr->second == handle)
+		{
+			names_.erase(itr);
+			break;
+		}
+	}
+
+	RemoveBounds(bounds_[handle.index]);
+
+	delete object;
+	objects_.RemoveAt(index);
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes the bounds of the object at a place in the packed objects match
+//		its mesh and world matrix, moving it between the trees if it changed
+//		between static and dynamic
+//*****************************************************************************
+void ObjectManagerSystem::UpdateBounds(int index)
+{
+	RenderObject* object = objects_[index];
+	ObjectHandle handle = objects_.GetHandle(index);
+	ObjectBounds& bounds = bounds_[handle.index];
+
+	Aabb box;
+	bool hasBounds = object->GetWorldBounds(&box);
+	bool isStatic = object->IsStatic();
+	if (bounds.proxy >= 0 && (!hasBounds || bounds.inStatic != isStatic))
+		RemoveBounds(bounds);
+
+	bounds.mesh = object->GetMesh();
+	bounds.inStatic = isStatic;
+	if (!hasBounds)
+		return;
+
+	Bvh& tree = isStatic ? staticTree_ : dynamicTree_;
+	std::vector<ObjectHandle>& proxyObjects = isStatic ? staticObjects_ : dynamicObjects_;
+	if (bounds.proxy < 0)
+	{
+		bounds.proxy = tree.Insert(box);
+		if (bounds.proxy >= static_cast<int>(proxyObjects.size()))
+			proxyObjects.resize(bounds.proxy + 1);
+		proxyObjects[bounds.proxy] = handle;
+		staticDirty_ |= isStatic;
+	}
+	else if (tree.Move(bounds.proxy, box) && isStatic)
+		staticDirty_ = true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes an object's bounds out of whichever tree they are in
+//*****************************************************************************
+void ObjectManagerSystem::RemoveBounds(ObjectBounds& bounds)
+{
+	if (bounds.proxy < 0)
+		return;
+
+	if (bounds.inStatic)
+	{
+		staticTree_.Remove(bounds.proxy);
+		staticObjects_[bounds.proxy] = ObjectHandle();
+	}
+	else
+	{
+		dynamicTree_.Remove(bounds.proxy);
+		dynamicObjects_[bounds.proxy] = ObjectHandle();
+	}
+	bounds.proxy = -1;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the trees ready for queries. The static tree is rebuilt if
+//		anything was added to it or moved in it, and the dynamic one only
+//		once enough has moved that it has gotten loose
+//*****************************************************************************
+void ObjectManagerSystem::UpdateTrees()
+{
+	if (staticDirty_)
+	{
+		staticTree_.Build();
+		staticDirty_ = false;
+	}
+	dynamicTree_.Optimize();
+}
+
+//*****************************************************************************
+//  Description:
+//		Draws the objects the trees find in the frustum. Nothing else is
+//		looked at, and what is found doesn't need culling again
+//*****************************************************************************
+void ObjectManagerSystem::DrawVisible(const Frustum& frustum)
+{
+	DCK_PROFILE_ZONE("Cull Objects");
+	UpdateTrees();
+
+	int drawnCount = 0;
+	queryProxies_.clear();
+	staticTree_.QueryFrustum(frustum, queryProxies_);
+	for (int proxy : queryProxies_)
+		(*objects_.Get(staticObjects_[proxy]))->Draw(false);
+	drawnCount += static_cast<int>(queryProxies_.size());
+
+	queryProxies_.clear();
+	dynamicTree_.QueryFrustum(frustum, queryProxies_);
+	for (int proxy : queryProxies_)
+		(*objects_.Get(dynamicObjects_[proxy]))->Draw(false);
+	drawnCount += static_cast<int>(queryProxies_.size());
+
+	renderSys_->AddCulledCount(staticTree_.GetCount() + dynamicTree_.GetCount() - drawnCount);
+}
+
+//*****************************************************************************
+//  Description:
+//		Turns the proxies a tree query found into object handles
+//*****************************************************************************
+void ObjectManagerSystem::GatherResults(const std::vector<int>& proxies, const std::vector<ObjectHandle>& proxyObjects,
+										std::vector<ObjectHandle>& results)
+{
+	for (int proxy : proxies)
+		results.push_back(proxyObjects[proxy]);
 }
 
 ObjectManagerSystem::~ObjectManagerSystem()
@@ -9,28 +9,98 @@
 
 #include "System.h"
 #include "RenderObject.h"
+#include "SlotMap.h"
+#include "Bvh.h"
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+class JobSystem;
+class RenderSystem;
+
+// Handle to an object in the manager, which goes invalid once the object is removed
+typedef SlotHandle ObjectHandle;
+
 class ObjectManagerSystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::ObjectManagerSys;
+
 	ObjectManagerSystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
 	void Shutdown() override;
 
-	void AddObject(RenderObject* obj);
-	RenderObject* GetObject(std::string name);
+	ObjectHandle AddObject(RenderObject* obj);
+	RenderObject* GetObject(ObjectHandle handle);
+	RenderObject* GetObject(const std::string& name);
+	ObjectHandle GetHandle(const std::string& name);
+	ObjectHandle GetHandle(int index);
+	void RemoveObject(ObjectHandle handle);
 	void ClearManager();
 
 	RenderObject** GetAllObjects();
 	int GetCount();
 
+	void QueryFrustum(const Frustum& frustum, std::vector<ObjectHandle>& results);
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<ObjectHandle>& results);
+	void QueryBox(const Aabb& box, std::vector<ObjectHandle>& results);
+	ObjectHandle RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, float* hitDist = nullptr);
+
 	~ObjectManagerSystem();
 
 private:
 
-	std::vector<RenderObject*> objects_;
+	//*************************************************************************
+	//  Description:
+	//		Where an object's bounds are in the culling trees, and what they
+	//		were made from so changes can be noticed
+	//*************************************************************************
+	struct ObjectBounds {
+		int proxy;
+		bool inStatic;
+		DckMesh* mesh;
+
+		ObjectBounds() :
+			proxy(-1),
+			inStatic(false),
+			mesh(nullptr)
+		{}
+	};
+
+	void RemoveAt(int index);
+	void UpdateBounds(int index);
+	void RemoveBounds(ObjectBounds& bounds);
+	void UpdateTrees();
+	void DrawVisible(const Frustum& frustum);
+	void GatherResults(const std::vector<int>& proxies, const std::vector<ObjectHandle>& proxyObjects, std::vector<ObjectHandle>& results);
+
+	// The objects, packed together for updating and drawing, and a hashed index of their names.
+	// Names don't have to be unique, so a name can have more than one object
+	SlotMap<RenderObject*> objects_;
+	std::unordered_multimap<std::string, ObjectHandle> names_;
+
+	// Bounds of every object with a mesh, for culling and spatial queries. Static objects go in a tree
+	// that is rebuilt whenever it changes, everything else in one that is refit as things move
+	Bvh staticTree_;
+	Bvh dynamicTree_;
+	bool staticDirty_;
+
+	// Each object's place in the trees by its slot, the object in each tree proxy, and the object
+	// each scene node belongs to by the node's slot
+	std::vector<ObjectBounds> bounds_;
+	std::vector<ObjectHandle> staticObjects_;
+	std::vector<ObjectHandle> dynamicObjects_;
+	std::vector<ObjectHandle> nodeObjects_;
+
+	// Scratch for tree queries
+	std::vector<int> queryProxies_;
+
+	// Used to update transforms across threads, found in Initialize
+	JobSystem* jobSystem_;
+
+	// Gives the frustum to cull against, found in Initialize
+	RenderSystem* renderSys_;
 
 };
\ No newline at end of file
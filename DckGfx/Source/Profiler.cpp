@@ -0,0 +1,344 @@
+//*****************************************************************************
+//	File:   Profiler.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: CPU frame profiler. Scoped zones are timed into a ring buffer
+//		per thread, which the main thread collects once a frame to show in
+//		ImGui or save as a Chrome trace. Only built with DCK_PROFILE defined,
+//		otherwise the zone macros are empty and nothing here is compiled
+//*****************************************************************************
+
+#include "Profiler.h"
+
+#ifdef DCK_PROFILE
+
+#include <fstream>
+#include <iostream>
+
+// How many frames of zones are kept around to look at or save
+static const int historyFrameCount = 120;
+
+static Profiler profiler;
+
+// The buffer belonging to the current thread, made the first time it records a zone
+static thread_local Profiler::ThreadBuffer* threadBuffer = nullptr;
+
+Profiler::Profiler() :
+	threads_(),
+	threadMutex_(),
+	frames_(),
+	discarded_(),
+	nextFrame_(0),
+	frameCount_(0),
+	startTicks_(0),
+	frameStart_(0),
+	ticksPerMs_(1.0),
+	paused_(false)
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts the profiler clock. Should be done before anything is profiled
+//		so every zone comes after the start of the trace
+//*****************************************************************************
+void Profiler::Initialize()
+{
+	startTicks_ = SDL_GetPerformanceCounter();
+	frameStart_ = startTicks_;
+	ticksPerMs_ = SDL_GetPerformanceFrequency() / 1000.0;
+	frames_.resize(historyFrameCount);
+	nextFrame_ = 0;
+	frameCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Frees every thread's buffer. Every other thread that profiled must have
+//		stopped by now
+//*****************************************************************************
+void Profiler::Shutdown()
+{
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	for (ThreadBuffer* buffer : threads_)
+		delete buffer;
+	threads_.clear();
+	threadBuffer = nullptr;
+
+	frames_.clear();
+	frameCount_ = 0;
+}
+
+//*****************************************************************************
+//  Description:
+//		Ends the current frame, collecting every zone the threads finished
+//		since the last one. Called by the main thread at the start of a frame
+//*****************************************************************************
+void Profiler::NewFrame()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (frames_.empty())
+		return;
+
+	// Always empty the buffers so they don't fill up. While paused the zones are thrown away
+	// instead of overwriting the oldest kept frame
+	std::vector<ProfileEvent>& events = paused_ ? discarded_ : frames_[nextFrame_].events;
+	events.clear();
+	{
+		std::lock_guard<std::mutex> lock(threadMutex_);
+		for (ThreadBuffer* buffer : threads_)
+			Collect(buffer, events);
+	}
+
+	if (!paused_)
+	{
+		frames_[nextFrame_].start = frameStart_;
+		frames_[nextFrame_].end = now;
+		nextFrame_ = (nextFrame_ + 1) % historyFrameCount;
+		if (frameCount_ < historyFrameCount)
+			++frameCount_;
+	}
+	frameStart_ = now;
+}
+
+//*****************************************************************************
+//  Description:
+//		Saves the kept frames as a Chrome trace, which can be opened in
+//		chrome://tracing or Perfetto
+//
+//	Param filepath:
+//		Where to save the trace
+//
+//	Return:
+//		Returns true if the trace was saved
+//*****************************************************************************
+bool Profiler::SaveTrace(const char* filepath)
+{
+	std::ofstream traceFile(filepath, std::ios::trunc);
+	if (!traceFile.is_open())
+	{
+		std::cout << "Failed to save trace: " << filepath << std::endl;
+		return false;
+	}
+
+	traceFile << "{\"traceEvents\":[\n";
+
+	// Name the threads first so the viewer shows them by name
+	bool first = true;
+	for (int i = 0; i < GetThreadCount(); ++i)
+	{
+		traceFile << (first ? "" : ",\n");
+		traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+				  << ",\"args\":{\"name\":\"" << GetThreadName(i) << "\"}}";
+		first = false;
+	}
+
+	// Complete events in microseconds from when the profiler started
+	traceFile.precision(3);
+	traceFile << std::fixed;
+	for (int i = frameCount_ - 1; i >= 0; --i)
+	{
+		const Frame* frame = GetFrame(i);
+		for (const ProfileEvent& event : frame->events)
+		{
+			traceFile << (first ? "" : ",\n");
+			traceFile << "{\"name\":\"" << event.name << "\",\"cat\":\"DckGfx\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+					  << ",\"ts\":" << ToMs(event.start - startTicks_) * 1000.0
+					  << ",\"dur\":" << ToMs(event.end - event.start) * 1000.0 << "}";
+			first = false;
+		}
+	}
+
+	traceFile << "\n]}\n";
+	return traceFile.good();
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the current thread's buffer, making it the first time
+//*****************************************************************************
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if (threadBuffer)
+		return threadBuffer;
+
+	ThreadBuffer* buffer = new ThreadBuffer();
+	buffer->head = 0;
+	buffer->tail = 0;
+	buffer->dropped = 0;
+	buffer->depth = 0;
+	buffer->name = "Thread";
+
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	buffer->index = static_cast<int>(threads_.size());
+	threads_.push_back(buffer);
+	threadBuffer = buffer;
+	return buffer;
+}
+
+//*****************************************************************************
+//  Description:
+//		Names the current thread in the profiler
+//
+//	Param name:
+//		Name of the thread, has to be a string that lives forever
+//*****************************************************************************
+void Profiler::SetThreadName(const char* name)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	buffer->name = name;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets a kept frame
+//
+//	Param framesAgo:
+//		How far back the frame is, 0 being the last one finished
+//
+//	Return:
+//		Returns the frame, or nullptr if it isn't kept
+//*****************************************************************************
+const Profiler::Frame* Profiler::GetFrame(int framesAgo)
+{
+	if (framesAgo < 0 || framesAgo >= frameCount_)
+		return nullptr;
+	int index = (nextFrame_ - 1 - framesAgo + historyFrameCount) % historyFrameCount;
+	return &frames_[index];
+}
+
+int Profiler::GetThreadCount()
+{
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	return static_cast<int>(threads_.size());
+}
+
+const char* Profiler::GetThreadName(int thread)
+{
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	if (thread < 0 || thread >= static_cast<int>(threads_.size()))
+		return "";
+	return threads_[thread]->name;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many zones were thrown away because a thread's buffer was
+//		full, which means it recorded more than a buffer holds in one frame
+//*****************************************************************************
+uint32_t Profiler::GetDroppedCount()
+{
+	std::lock_guard<std::mutex> lock(threadMutex_);
+	uint32_t dropped = 0;
+	for (ThreadBuffer* buffer : threads_)
+		dropped += buffer->dropped;
+	return dropped;
+}
+
+double Profiler::ToMs(Uint64 ticks)
+{
+	return ticks / ticksPerMs_;
+}
+
+void Profiler::SetPaused(bool paused)
+{
+	paused_ = paused;
+}
+
+bool Profiler::IsPaused()
+{
+	return paused_;
+}
+
+Profiler::~Profiler()
+{
+	Shutdown();
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes every finished zone out of a thread's buffer
+//
+//	Param buffer:
+//		The buffer to empty
+//
+//	Param events:
+//		Where the zones get added to
+//*****************************************************************************
+void Profiler::Collect(ThreadBuffer* buffer, std::vector<ProfileEvent>& events)
+{
+	uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+	uint32_t head = buffer->head.load(std::memory_order_acquire);
+	for (uint32_t i = tail; i != head; ++i)
+		events.push_back(buffer->events[i & (ThreadBuffer::capacity - 1)]);
+	buffer->tail.store(head, std::memory_order_release);
+}
+
+
+// Scoped zone
+ProfileZone::ProfileZone(const char* name) :
+	buffer_(profiler.GetThreadBuffer()),
+	name_(name),
+	start_(0)
+{
+	++buffer_->depth;
+	start_ = SDL_GetPerformanceCounter();
+}
+
+//*****************************************************************************
+//  Description:
+//		Ends the zone and pushes it to the thread's buffer. If the main thread
+//		hasn't collected enough of the buffer yet, the zone is dropped rather
+//		than waiting
+//*****************************************************************************
+ProfileZone::~ProfileZone()
+{
+	Uint64 end = SDL_GetPerformanceCounter();
+	--buffer_->depth;
+
+	uint32_t head = buffer_->head.load(std::memory_order_relaxed);
+	uint32_t tail = buffer_->tail.load(std::memory_order_acquire);
+	if (head - tail >= Profiler::ThreadBuffer::capacity)
+	{
+		buffer_->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer_->events[head & (Profiler::ThreadBuffer::capacity - 1)] = ProfileEvent{ name_, start_, end, buffer_->depth, buffer_->index };
+	buffer_->head.store(head + 1, std::memory_order_release);
+}
+
+
+// Functions for interacting with the profiler
+void ProfilerInit()
+{
+	profiler.Initialize();
+}
+
+void ProfilerNewFrame()
+{
+	profiler.NewFrame();
+}
+
+void ProfilerSetThreadName(const char* name)
+{
+	profiler.SetThreadName(name);
+}
+
+bool ProfilerSaveTrace(const char* filepath)
+{
+	return profiler.SaveTrace(filepath);
+}
+
+Profiler* ProfilerGet()
+{
+	return &profiler;
+}
+
+void ProfilerShutdown()
+{
+	profiler.Shutdown();
+}
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+//*****************************************************************************
+//	File:   Profiler.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: CPU frame profiler. Scoped zones are timed into a ring buffer
+//		per thread, which the main thread collects once a frame to show in
+//		ImGui or save as a Chrome trace. Only built with DCK_PROFILE defined,
+//		otherwise the zone macros are empty and nothing here is compiled
+//*****************************************************************************
+
+#ifdef DCK_PROFILE
+
+#include "SDL2/SDL.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Macros used to profile, so they can compile down to nothing
+#define DCK_PROFILE_CONCAT_(a, b) a##b
+#define DCK_PROFILE_CONCAT(a, b) DCK_PROFILE_CONCAT_(a, b)
+#define DCK_PROFILE_ZONE(name) ProfileZone DCK_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define DCK_PROFILE_THREAD(name) ProfilerSetThreadName(name)
+#define DCK_PROFILE_FRAME() ProfilerNewFrame()
+
+//*****************************************************************************
+//  Description:
+//		One finished zone. The name has to be a string that lives forever,
+//		since only the pointer is kept
+//*****************************************************************************
+struct ProfileEvent {
+	const char* name;
+	Uint64 start;
+	Uint64 end;
+	int depth;
+	int thread;
+};
+
+class Profiler {
+public:
+
+	// Ring buffer of finished zones for one thread. Only the owning thread pushes
+	// and only the main thread pops, so the two indices are all the syncing needed
+	struct ThreadBuffer {
+		static const uint32_t capacity = 1 << 13;
+
+		ProfileEvent events[capacity];
+		std::atomic<uint32_t> head;
+		std::atomic<uint32_t> tail;
+		std::atomic<uint32_t> dropped;
+
+		// Only touched by the owning thread
+		int depth;
+
+		const char* name;
+		int index;
+	};
+
+	// Zones collected at the end of a frame, and when the frame started and ended
+	struct Frame {
+		Uint64 start;
+		Uint64 end;
+		std::vector<ProfileEvent> events;
+	};
+
+	Profiler();
+
+	void Initialize();
+	void Shutdown();
+
+	void NewFrame();
+	bool SaveTrace(const char* filepath);
+
+	ThreadBuffer* GetThreadBuffer();
+	void SetThreadName(const char* name);
+
+	const Frame* GetFrame(int framesAgo);
+	int GetThreadCount();
+	const char* GetThreadName(int thread);
+	uint32_t GetDroppedCount();
+
+	double ToMs(Uint64 ticks);
+
+	void SetPaused(bool paused);
+	bool IsPaused();
+
+	~Profiler();
+
+private:
+
+	void Collect(ThreadBuffer* buffer, std::vector<ProfileEvent>& events);
+
+	// Every thread that has recorded a zone, only locked when a thread first records
+	std::vector<ThreadBuffer*> threads_;
+	std::mutex threadMutex_;
+
+	// The last few frames, oldest first once the ring wraps
+	std::vector<Frame> frames_;
+	std::vector<ProfileEvent> discarded_;
+	int nextFrame_;
+	int frameCount_;
+
+	Uint64 startTicks_;
+	Uint64 frameStart_;
+	double ticksPerMs_;
+	bool paused_;
+
+};
+
+//*****************************************************************************
+//  Description:
+//		Times everything from where it is made until the end of its scope.
+//		Zones in zones are nested under each other
+//*****************************************************************************
+class ProfileZone {
+public:
+
+	ProfileZone(const char* name);
+	~ProfileZone();
+
+private:
+
+	Profiler::ThreadBuffer* buffer_;
+	const char* name_;
+	Uint64 start_;
+
+};
+
+void ProfilerInit();
+void ProfilerNewFrame();
+void ProfilerSetThreadName(const char* name);
+bool ProfilerSaveTrace(const char* filepath);
+Profiler* ProfilerGet();
+void ProfilerShutdown();
+
+#else
+
+#define DCK_PROFILE_ZONE(name)
+#define DCK_PROFILE_THREAD(name)
+#define DCK_PROFILE_FRAME()
+
+#endif
@@ -8,21 +8,19 @@
 
 #include "RenderObject.h"
 #include "DckGfxEngine.h"
+#include "Bvh.h"
 
 RenderObject::RenderObject(std::string name) :
 	name_(name),
 	mesh_(nullptr),
 	rendType_(RenderType::Triangles),
-	pos_(0),
-	scale_(1),
-	rotVec_(GfxMath::Vector(0, 1, 0)),
-	rotAngle_(0.0f),
+	transform_(TransformStoreGet()->Add()),
+	node_(SceneGraphGet()->Add(transform_)),
 	tint_(0),
 	diffuse_(0),
 	specular_(0),
 	specularExp_(0.0f),
-	isDirty_(true),
-	modelMat_(1),
+	isStatic_(false),
 	isDestroyed_(false)
 {
 }
@@ -30,7 +28,6 @@ RenderObject::RenderObject(std::string name) :
 void RenderObject::SetMesh(DckMesh* mesh)
 {
 	mesh_ = mesh;
-	isDirty_ = true;
 }
 
 void RenderObject::SetRenderMode(RenderType render)
@@ -40,56 +37,97 @@ void RenderObject::SetRenderMode(RenderType render)
 
 void RenderObject::SetPosition(glm::vec4 pos)
 {
-	pos_ = pos;
-	isDirty_ = true;
+	TransformStoreGet()->SetPosition(transform_, pos);
 }
 
 void RenderObject::SetScale(glm::vec3 scale)
 {
-	scale_ = scale;
-	isDirty_ = true;
+	TransformStoreGet()->SetScale(transform_, scale);
 }
 
 void RenderObject::SetRotation(glm::vec4 vec, float angle)
 {
-	rotVec_ = vec;
-	rotAngle_ = angle;
-	isDirty_ = true;
+	TransformStoreGet()->SetRotation(transform_, vec, angle);
+}
+
+void RenderObject::SetOrientation(const GfxMath::Quat& orientation)
+{
+	TransformStoreGet()->SetOrientation(transform_, orientation);
+}
+
+//*****************************************************************************
+//  Description:
+//		Rotates the object further from where it is now, which is cheaper
+//		than getting the rotation, changing it and setting it again
+//
+//	Param rotation:
+//		The rotation to add to the object's current one
+//*****************************************************************************
+void RenderObject::Rotate(const GfxMath::Quat& rotation)
+{
+	TransformStoreGet()->Rotate(transform_, rotation);
 }
 
 void RenderObject::SetTint(glm::vec3 tint)
 {
 	tint_ = tint;
-	isDirty_ = true;
 }
 
 void RenderObject::SetDiffuse(glm::vec3 coeff)
 {
 	diffuse_ = coeff;
-	isDirty_ = true;
 }
 
 void RenderObject::SetSpecular(glm::vec3 coeff, float exp)
 {
 	specular_ = coeff;
 	specularExp_ = exp;
-	isDirty_ = true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Attaches the object to another one, so it moves along with it. The
+//		object's position, scale and rotation are then relative to the parent
+//
+//	Param parent:
+//		The object to attach to, or nullptr to detach
+//
+//	Return:
+//		Returns false if the parent is already attached under this object
+//*****************************************************************************
+bool RenderObject::SetParent(RenderObject* parent)
+{
+	return SceneGraphGet()->SetParent(node_, parent ? parent->node_ : SceneNode());
+}
+
+//*****************************************************************************
+//  Description:
+//		Marks the object as one that won't move. It can still be moved, but
+//		the culling tree it is in gets rebuilt every time it does
+//*****************************************************************************
+void RenderObject::SetStatic(bool isStatic)
+{
+	isStatic_ = isStatic;
 }
 
 glm::vec4 RenderObject::GetPosition()
 {
-	return pos_;
+	return TransformStoreGet()->GetPosition(transform_);
 }
 
 glm::vec3 RenderObject::GetScale()
 {
-	return scale_;
+	return TransformStoreGet()->GetScale(transform_);
 }
 
 void RenderObject::GetRotation(glm::vec4* vec, float* angle)
 {
-	*vec = rotVec_;
-	*angle = rotAngle_;
+	TransformStoreGet()->GetRotation(transform_, vec, angle);
+}
+
+GfxMath::Quat RenderObject::GetOrientation()
+{
+	return TransformStoreGet()->GetOrientation(transform_);
 }
 
 glm::vec3 RenderObject::GetTint()
@@ -108,20 +146,100 @@ void RenderObject::GetSpecular(glm::vec3* coeff, float* exp)
 	*exp = specularExp_;
 }
 
+//*****************************************************************************
+//  Description:
+//		Gets the object to world matrix, including every parent, as of the
+//		last scene graph update
+//*****************************************************************************
+const glm::mat4& RenderObject::GetWorldMatrix()
+{
+	return SceneGraphGet()->GetWorldMatrix(node_);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the box around the object's mesh in world space, as of the last
+//		scene graph update
+//
+//	Param bounds:
+//		Set to the box
+//
+//	Return:
+//		Returns false if there is no mesh, or it is still loading
+//*****************************************************************************
+bool RenderObject::GetWorldBounds(Aabb* bounds)
+{
+	if (!mesh_ || !mesh_->IsReady())
+		return false;
+
+	*bounds = Aabb::Transform(Aabb(mesh_->GetBoundsMin(), mesh_->GetBoundsMax()), GetWorldMatrix());
+	return true;
+}
+
+//*****************************************************************************
+//  Description:
+//		Finds where a ray first hits the object's mesh. The ray is moved into
+//		object space instead of moving the mesh, which keeps distances along
+//		it the same in both spaces
+//
+//	Param origin:
+//		Where the ray starts in world space
+//
+//	Param dir:
+//		Which way the ray goes, distances are in multiples of its length
+//
+//	Param maxDist:
+//		How far along the ray to look
+//
+//	Return:
+//		Returns how far along the ray the hit was, or a negative number if
+//		the ray misses or there is no mesh to hit
+//*****************************************************************************
+float RenderObject::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist)
+{
+	if (!mesh_)
+		return -1.0f;
+
+	glm::mat4 worldToObj = GfxMath::AffineInverse(GetWorldMatrix());
+	glm::vec3 localOrigin(worldToObj * glm::vec4(origin, 1.0f));
+	glm::vec3 localDir(worldToObj * glm::vec4(dir, 0.0f));
+	return mesh_->RayCast(localOrigin, localDir, maxDist);
+}
+
+DckMesh* RenderObject::GetMesh()
+{
+	return mesh_;
+}
+
+SceneNode RenderObject::GetNode()
+{
+	return node_;
+}
+
+bool RenderObject::IsStatic()
+{
+	return isStatic_;
+}
+
 std::string RenderObject::GetName()
 {
 	return name_;
 }
 
-void RenderObject::Draw()
+//*****************************************************************************
+//  Description:
+//		Queues the object to be drawn with the matrices from the last time
+//		the scene graph updated
+//
+//	Param cull:
+//		Whether the renderer should check if the camera can see it. Can be
+//		skipped if it was already found with a culling query
+//*****************************************************************************
+void RenderObject::Draw(bool cull)
 {
-	if (isDirty_)
-	{
-		modelMat_ = GfxMath::Translate(pos_) * GfxMath::Rotate3D(rotVec_, rotAngle_) * GfxMath::Scale(scale_.x, scale_.y, scale_.z);
-		isDirty_ = false;
-	}
-
-	DckERender(mesh_, rendType_, modelMat_, tint_, diffuse_, specular_, specularExp_);
+	SceneGraph* graph = SceneGraphGet();
+	DckERender(mesh_, rendType_, graph->GetWorldMatrix(node_), graph->GetNormalMatrix(node_),
+			   tint_, diffuse_, specular_, specularExp_, cull);
 }
 
 void RenderObject::Destroy()
@@ -136,4 +254,6 @@ bool RenderObject::IsDestroyed()
 
 RenderObject::~RenderObject()
 {
+	SceneGraphGet()->Remove(node_);
+	TransformStoreGet()->Remove(transform_);
 }
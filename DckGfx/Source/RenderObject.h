@@ -8,8 +8,11 @@
 //*****************************************************************************
 
 #include "MeshLib.h"
+#include "SceneGraph.h"
 #include <string>
 
+struct Aabb;
+
 class RenderObject {
 public:
 
@@ -20,20 +23,31 @@ public:
 	void SetPosition(glm::vec4 pos);
 	void SetScale(glm::vec3 scale);
 	void SetRotation(glm::vec4 vec, float angle);
+	void SetOrientation(const GfxMath::Quat& orientation);
+	void Rotate(const GfxMath::Quat& rotation);
 	void SetTint(glm::vec3 tint);
 	void SetDiffuse(glm::vec3 coeff);
 	void SetSpecular(glm::vec3 coeff, float exp);
+	bool SetParent(RenderObject* parent);
+	void SetStatic(bool isStatic);
 
 	glm::vec4 GetPosition();
 	glm::vec3 GetScale();
 	void GetRotation(glm::vec4* vec, float* angle);
+	GfxMath::Quat GetOrientation();
 	glm::vec3 GetTint();
 	glm::vec3 GetDiffuse();
 	void GetSpecular(glm::vec3* coeff, float* exp);
+	const glm::mat4& GetWorldMatrix();
+	bool GetWorldBounds(Aabb* bounds);
+	float RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDist);
+	DckMesh* GetMesh();
+	SceneNode GetNode();
+	bool IsStatic();
 
 	std::string GetName();
 
-	void Draw();
+	void Draw(bool cull = true);
 
 	void Destroy();
 	bool IsDestroyed();
@@ -51,13 +65,10 @@ private:
 	// How the mesh will be rendered
 	RenderType rendType_;
 
-	// The position and scale data of the object
-	glm::vec4 pos_;
-	glm::vec3 scale_;
-
-	// The rotation data of the object (vector rotated around and angle)
-	glm::vec4 rotVec_;
-	float rotAngle_;
+	// The position, scale and rotation of the object, which live in the transform store, and
+	// where the object is in the scene graph. The transform is relative to the parent, if any
+	TransformHandle transform_;
+	SceneNode node_;
 
 	// The tint the object will have
 	glm::vec3 tint_;
@@ -67,9 +78,8 @@ private:
 	glm::vec3 specular_;
 	float specularExp_;
 
-	// The modeling matrix for the object
-	bool isDirty_;
-	glm::mat4 modelMat_;
+	// Objects that won't move go in a separate culling tree that is built once instead of refit
+	bool isStatic_;
 
 	// Flag for destroying object
 	bool isDestroyed_;
@@ -12,174 +12,647 @@
 #include "GraphicsSystem.h"
 #include "CameraSystem.h"
 #include "Engine.h"
+#include "FramePacket.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
 
-RenderSystem::RenderSystem() : System(SysType::RenderSys),
-	renderQueue_(),
-	debugQueue_(),
+// Starting size of the scratch arena, grows to fit a frame if it ever runs out
+static const size_t frameArenaSize = 1 << 20;
+
+RenderSystem::RenderSystem() : System(Type),
+	frameArena_(frameArenaSize),
+	instances_(&frameArena_),
+	instanceBuffer_(0),
+	instanceBufferSize_(0),
+	sortEntries_(&frameArena_),
+	sortScratch_(&frameArena_),
+	sortedQueue_(&frameArena_),
+	boundShader_(nullptr),
+	boundVao_(0),
+	gpuTimer_(),
+	stats_(),
+	lastStats_(),
+	statsMutex_(),
+	frustum_(),
+	frustumValid_(false),
+	culling_(true),
 	pointSize_(5.0f),
-	lineWidth_(1.0f)
+	lineWidth_(1.0f),
+	camSys_(nullptr)
+{
+	// Draws everything the other systems queued up this frame
+	RunsAfter(GraphicsSys);
+	RunsAfter(CameraSys);
+	RunsAfter(ObjectManagerSys);
+	RunsAfter(LightingSys);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the OpenGL primitive and index count to draw a render type with
+//*****************************************************************************
+static GLenum DrawMode(RenderType type)
 {
+	switch (type)
+	{
+		case RenderType::Points:
+			return GL_POINTS;
+		case RenderType::Lines:
+			return GL_LINES;
+		default:
+			return GL_TRIANGLES;
+	}
+}
+
+static GLsizei IndexCount(RenderType type, int elementCount)
+{
+	switch (type)
+	{
+		case RenderType::Points:
+			return elementCount;
+		case RenderType::Lines:
+			return 2 * elementCount;
+		default:
+			return 3 * elementCount;
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Builds the sort key for a piece of render data. From the top bits
+//		down the key is pass (2 bits), shader program (10 bits), vao (20
+//		bits), render type (2 bits), then depth (30 bits), so sorting groups
+//		draws by the state they need and then draws front to back
+//
+//	Param pass:
+//		The pass the data is drawn in
+//
+//	Param program:
+//		The shader program the data is drawn with
+//
+//	Param data:
+//		The render data to build the key for
+//
+//	Param viewMat:
+//		The world to camera matrix, used for the depth
+//
+//	Return:
+//		Returns the sort key
+//*****************************************************************************
+static uint64_t MakeSortKey(RenderSystem::RenderPass pass, GLuint program, const RenderSystem::RenderData& data, const glm::mat4& viewMat)
+{
+	// Distance in front of the camera, anything behind it counts as right at it
+	glm::vec4 camPos = viewMat * data.objToWorld[3];
+	float depth = std::max(-camPos.z, 0.0f);
+
+	// Positive floats sort the same as their bits do, the sign bit is always zero so drop the lowest bit to fit
+	uint32_t depthBits;
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+	depthBits >>= 1;
+
+	return (static_cast<uint64_t>(pass & 0x3) << 62) |
+		(static_cast<uint64_t>(program & 0x3FF) << 52) |
+		(static_cast<uint64_t>(data.vao & 0xFFFFF) << 32) |
+		(static_cast<uint64_t>(data.type & 0x3) << 30) |
+		static_cast<uint64_t>(depthBits & 0x3FFFFFFF);
 }
 
 void RenderSystem::Initialize()
 {
-	// Nothing to really initialize here
+	camSys_ = GetParent()->Get<CameraSystem>();
+
 	glLineWidth(lineWidth_);
 	glPointSize(pointSize_);
+
+	// Buffer for per instance data, grows as needed
+	instanceBufferSize_ = sizeof(RenderInstance) * 64;
+	glGenBuffers(1, &instanceBuffer_);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+	glBufferData(GL_ARRAY_BUFFER, instanceBufferSize_, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	gpuTimer_.Initialize(PassCount);
 }
 
 void RenderSystem::Update(float dt)
 {
-	// Get necessary systems here (probably graphics and camera)
-	GraphicsSystem* graphicSys = dynamic_cast<GraphicsSystem*>(GetParent()->GetSystem(SysType::GraphicsSys));
-	if (!graphicSys)
+	// Record the camera the frame gets drawn from
+	FramePacket* packet = GetParent()->GetFramePacket();
+	Camera* activeCam = camSys_ ? camSys_->GetActiveCamera() : nullptr;
+	if (activeCam)
 	{
-		while (!renderQueue_.empty())
-			renderQueue_.pop();
-		while (!debugQueue_.empty())
-			debugQueue_.pop();
-		return;
+		packet->viewMat = activeCam->GetViewMatrix();
+		packet->perspMat = activeCam->GetPerspMatrix();
+		packet->eyePoint = activeCam->GetEyePoint();
 	}
 
-	CameraSystem* camSys = dynamic_cast<CameraSystem*>(GetParent()->GetSystem(SysType::CameraSys));
-	if (!camSys)
+	// The camera can move before the next frame
+	frustumValid_ = false;
+}
+
+void RenderSystem::Submit(FramePacket& packet)
+{
+	// Start counting for this frame. Anything else could have changed the bindings since last frame
+	stats_ = RenderStats();
+	stats_.culledCount = packet.culledCount;
+	boundShader_ = nullptr;
+	boundVao_ = 0;
+
+	// Pick up whatever pass times have come back from the GPU
+	gpuTimer_.NewFrame();
+
+	// Can't draw anything without a shader
+	Shader* shader = packet.shader;
+	if (!shader)
 	{
-		while (!renderQueue_.empty())
-			renderQueue_.pop();
-		while (!debugQueue_.empty())
-			debugQueue_.pop();
+		ResetFrame(packet);
 		return;
 	}
+	Shader* instancedShader = shader->GetInstancedVariant();
+	const glm::mat4& perspMat = packet.perspMat;
+	const glm::mat4& viewMat = packet.viewMat;
 
-	// Get the active shader
-	Shader* shader = graphicSys->GetActiveShader();
-	shader->Use();
+	// Upload Perspective Matrix and view matrix here, to the instanced shader too if there is one
+	if (instancedShader)
+	{
+		UseShader(instancedShader);
+		glUniformMatrix4fv(instancedShader->GetUniformLocation("perspMat"), 1, GL_FALSE, &perspMat[0][0]);
+		glUniformMatrix4fv(instancedShader->GetUniformLocation("worldToCam"), 1, GL_FALSE, &viewMat[0][0]);
+	}
+	UseShader(shader);
+	glUniformMatrix4fv(shader->GetUniformLocation("perspMat"), 1, GL_FALSE, &perspMat[0][0]);
+	glUniformMatrix4fv(shader->GetUniformLocation("worldToCam"), 1, GL_FALSE, &viewMat[0][0]);
 
-	// Get the Lighting System and see if we need to upload diffuse and specular data
-	LightingSystem* lightSys = dynamic_cast<LightingSystem*>(GetParent()->GetSystem(LightingSys));
+	// Go through the render queue and render everything
+	BeginPassTimer(MainPass);
+	DrawQueue(packet.renderQueue, MainPass, shader, viewMat, packet.useLighting);
+	EndPassTimer();
 
-	// Get the active camera and respective matrices needed
-	glm::mat4 perspMat(0);
-	glm::mat4 viewMat(0);
-	Camera* activeCam = camSys->GetActiveCamera();
-	if (activeCam)
+	// Now to render debug stuff that can always be seen
+	BeginPassTimer(DebugPass);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	DrawQueue(packet.debugQueue, DebugPass, shader, viewMat, false);
+	EndPassTimer();
+
+	// Leave the active shader in use and nothing bound for whoever draws next
+	UseShader(shader);
+	BindVao(0);
+
+	ResetFrame(packet);
+}
+
+//*****************************************************************************
+//  Description:
+//		Frees the scratch space that was allocated for drawing, and publishes
+//		the stats for the frame. The scratch arrays forget their memory before
+//		the arena takes it back
+//
+//		Sorting swaps the packet's queues with scratch memory, so they are left
+//		pointing into the scratch arena until the engine resets the packet.
+//		Nothing reads them in between
+//
+//	Param packet:
+//		The frame that was drawn, which is reset separately by the engine
+//*****************************************************************************
+void RenderSystem::ResetFrame(FramePacket& packet)
+{
+	stats_.arenaBytes = frameArena_.GetUsed() + packet.arena.GetUsed();
+	stats_.heapAllocs = frameArena_.GetHeapAllocCount() + packet.arena.GetHeapAllocCount();
+	for (int pass = 0; pass < PassCount; ++pass)
+		stats_.gpuPassMs[pass] = gpuTimer_.GetMs(pass);
 	{
-		viewMat = activeCam->GetViewMatrix();
-		perspMat = activeCam->GetPerspMatrix();
+		std::lock_guard<std::mutex> lock(statsMutex_);
+		lastStats_ = stats_;
 	}
 
-	// Get uniform locations here
-	GLint uObjToWorld = shader->GetUniformLocation("objToWorld");
-	GLint uWorldToCam = shader->GetUniformLocation("worldToCam");
-	GLint uPerspMat = shader->GetUniformLocation("perspMat");
-	GLint uNormMat = shader->GetUniformLocation("normMat");
-	GLint uIgNorm = shader->GetUniformLocation("ignoreNorm");
-	GLint uTint = shader->GetUniformLocation("tint");
+	instances_.Reset();
+	sortEntries_.Reset();
+	sortScratch_.Reset();
+	sortedQueue_.Reset();
+	frameArena_.Reset();
+}
 
-	// Upload Perspective Matrix and view matrix here
-	glUniformMatrix4fv(uPerspMat, 1, GL_FALSE, &perspMat[0][0]);
-	glUniformMatrix4fv(uWorldToCam, 1, GL_FALSE, &viewMat[0][0]);
+//*****************************************************************************
+//  Description:
+//		Draws everything in a queue and empties it. The queue is sorted by
+//		state first, so draws of the same mesh and render type are next to
+//		each other. If the shader has an instanced variant each of those
+//		groups is drawn with a single instanced draw call, otherwise
+//		everything is drawn one at a time with uniforms
+//
+//	Param queue:
+//		The queue to draw
+//
+//	Param pass:
+//		The pass the queue is drawn in
+//
+//	Param shader:
+//		The active shader
+//
+//	Param viewMat:
+//		The world to camera matrix, used for sorting front to back
+//
+//	Param useLighting:
+//		Whether the material needs to be uploaded for lighting
+//*****************************************************************************
+void RenderSystem::DrawQueue(ArenaArray<RenderData>& queue, RenderPass pass, Shader* shader, const glm::mat4& viewMat, bool useLighting)
+{
+	DCK_PROFILE_ZONE(pass == MainPass ? "Main Pass" : "Debug Pass");
+	if (queue.Empty())
+		return;
 
-	// Go through the render queue and render everything
-	while (!renderQueue_.empty())
+	// Count how many vao changes drawing in submission order would have taken
+	GLuint prevVao = 0;
+	for (RenderData& currentData : queue)
 	{
-		// Get the current render data from the queue
-		RenderData currentData = renderQueue_.front();
-		renderQueue_.pop();
+		if (currentData.vao != prevVao)
+			++stats_.unsortedVaoBinds;
+		prevVao = currentData.vao;
+	}
+	stats_.objectCount += static_cast<int>(queue.Size());
+
+	Shader* instancedShader = shader->GetInstancedVariant();
+	SortQueue(queue, pass, instancedShader ? instancedShader->GetProgram() : shader->GetProgram(), viewMat);
 
-		// Upload the necessary uniforms
-		glUniformMatrix4fv(uObjToWorld, 1, GL_FALSE, &currentData.objToWorld[0][0]);
-		glUniformMatrix4fv(uNormMat, 1, GL_FALSE, &currentData.normalMat[0][0]);
-		glUniform3fv(uTint, 1, &currentData.tint[0]);
-		glUniform1i(uIgNorm, currentData.noNorm);
+	if (!instancedShader)
+	{
+		// Get uniform locations here
+		GLint uObjToWorld = shader->GetUniformLocation("objToWorld");
+		GLint uNormMat = shader->GetUniformLocation("normMat");
+		GLint uIgNorm = shader->GetUniformLocation("ignoreNorm");
+		GLint uTint = shader->GetUniformLocation("tint");
+		GLint uDiffCoeff = shader->GetUniformLocation("diffuseCoeff");
+		GLint uSpecCoeff = shader->GetUniformLocation("specularCoeff");
+		GLint uSpecExp = shader->GetUniformLocation("specularExp");
 
-		// If lighting is being used, upload stuff here
-		if (lightSys && lightSys->IsActive())
+		UseShader(shader);
+		int noNorm = -1;
+		for (RenderData& currentData : queue)
 		{
-			GLint uDiffCoeff = shader->GetUniformLocation("diffuseCoeff");
-			GLint uSpecCoeff = shader->GetUniformLocation("specularCoeff");
-			GLint uSpecExp = shader->GetUniformLocation("specularExp");
+			// Upload the necessary uniforms
+			glUniformMatrix4fv(uObjToWorld, 1, GL_FALSE, &currentData.objToWorld[0][0]);
+			glUniformMatrix4fv(uNormMat, 1, GL_FALSE, &currentData.normalMat[0][0]);
+			glUniform3fv(uTint, 1, &currentData.tint[0]);
+			if (currentData.noNorm != noNorm)
+			{
+				glUniform1i(uIgNorm, currentData.noNorm);
+				noNorm = currentData.noNorm;
+			}
+			else
+				++stats_.skippedUniforms;
+
+			// If lighting is being used, upload stuff here
+			if (useLighting)
+			{
+				glUniform3fv(uDiffCoeff, 1, &currentData.diffuse[0]);
+				glUniform3fv(uSpecCoeff, 1, &currentData.specular[0]);
+				glUniform1f(uSpecExp, currentData.specExp);
+			}
 
-			glUniform3fv(uDiffCoeff, 1, &currentData.diffuse[0]);
-			glUniform3fv(uSpecCoeff, 1, &currentData.specular[0]);
-			glUniform1f(uSpecExp, currentData.specExp);
+			// Render the object using the specified typing. The instance attributes still need a buffer
+			// bound even though this shader doesn't read them
+			if (currentData.vao != boundVao_)
+			{
+				BindVao(currentData.vao);
+				glBindVertexBuffer(instanceBinding, instanceBuffer_, 0, sizeof(RenderInstance));
+			}
+			else
+				++stats_.skippedBinds;
+			glDrawElements(DrawMode(currentData.type), IndexCount(currentData.type, currentData.elementCount), GL_UNSIGNED_INT, 0);
+			++stats_.drawCalls;
+			if (currentData.type == RenderType::Triangles)
+				stats_.triangleCount += currentData.elementCount;
 		}
+		queue.Clear();
+		return;
+	}
+
+	// Pack the per instance data in sorted order and upload all of it at once
+	instances_.Clear();
+	for (RenderData& currentData : queue)
+	{
+		RenderInstance instance;
+		instance.objToWorld = currentData.objToWorld;
+		instance.normalMat = currentData.normalMat;
+		instance.tint = currentData.tint;
+		instance.diffuse = currentData.diffuse;
+		instance.specular = glm::vec4(currentData.specular, currentData.specExp);
+		instances_.Push(instance);
+	}
+	UploadInstances();
+
+	UseShader(instancedShader);
+	GLint uIgNorm = instancedShader->GetUniformLocation("ignoreNorm");
 
-		// Render the object using the specified typing
-		glBindVertexArray(currentData.vao);
-		switch (currentData.type)
+	// Draw each group of the same vao and type with one call, reading its slice of the instance buffer
+	int noNorm = -1;
+	size_t first = 0;
+	while (first < queue.Size())
+	{
+		size_t last = first + 1;
+		while (last < queue.Size() && queue[last].vao == queue[first].vao && queue[last].type == queue[first].type)
+			++last;
+
+		RenderData& groupData = queue[first];
+		if (groupData.noNorm != noNorm)
 		{
-			case RenderType::Points:
-				glDrawElements(GL_POINTS, currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			case RenderType::Lines:
-				glDrawElements(GL_LINES, 2 * currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			case RenderType::Triangles:
-				glDrawElements(GL_TRIANGLES, 3 * currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			default:
-				break;
+			glUniform1i(uIgNorm, groupData.noNorm);
+			noNorm = groupData.noNorm;
 		}
-		glBindVertexArray(0);
+		else
+			++stats_.skippedUniforms;
+
+		// Only the type changed, the vao is already bound
+		if (groupData.vao == boundVao_)
+			++stats_.skippedBinds;
+		BindVao(groupData.vao);
+		glBindVertexBuffer(instanceBinding, instanceBuffer_, first * sizeof(RenderInstance), sizeof(RenderInstance));
+		glDrawElementsInstanced(DrawMode(groupData.type), IndexCount(groupData.type, groupData.elementCount), GL_UNSIGNED_INT, 0,
+			static_cast<GLsizei>(last - first));
+		++stats_.drawCalls;
+		if (groupData.type == RenderType::Triangles)
+			stats_.triangleCount += groupData.elementCount * static_cast<int>(last - first);
+
+		first = last;
 	}
 
-	// Now to render debug stuff that can always be seen
-	glClear(GL_DEPTH_BUFFER_BIT);
-	while (!debugQueue_.empty())
+	queue.Clear();
+}
+
+//*****************************************************************************
+//  Description:
+//		Sorts a queue by sort key with an LSD radix sort, a byte at a time.
+//		Passes where every key has the same byte are skipped, which is most
+//		of the top bytes since the pass and shader rarely change
+//
+//	Param queue:
+//		The queue to sort
+//
+//	Param pass:
+//		The pass the queue is drawn in
+//
+//	Param program:
+//		The shader program the queue is drawn with
+//
+//	Param viewMat:
+//		The world to camera matrix, used for the depth part of the keys
+//*****************************************************************************
+void RenderSystem::SortQueue(ArenaArray<RenderData>& queue, RenderPass pass, GLuint program, const glm::mat4& viewMat)
+{
+	DCK_PROFILE_ZONE("Sort Queue");
+	size_t count = queue.Size();
+	sortEntries_.Resize(count);
+	sortScratch_.Resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		queue[i].sortKey = MakeSortKey(pass, program, queue[i], viewMat);
+		sortEntries_[i].key = queue[i].sortKey;
+		sortEntries_[i].index = static_cast<uint32_t>(i);
+	}
+
+	for (int shift = 0; shift < 64; shift += 8)
 	{
-		// Get current render data
-		RenderData currentData = debugQueue_.front();
-		debugQueue_.pop();
+		size_t histogram[256] = {};
+		for (SortEntry& entry : sortEntries_)
+			++histogram[(entry.key >> shift) & 0xFF];
 
-		// Upload necessary uniforms
-		glUniformMatrix4fv(uObjToWorld, 1, GL_FALSE, &currentData.objToWorld[0][0]);
-		glUniformMatrix4fv(uNormMat, 1, GL_FALSE, &currentData.normalMat[0][0]);
-		glUniform3fv(uTint, 1, &currentData.tint[0]);
-		glUniform1i(uIgNorm, currentData.noNorm);
+		// Every key has the same byte here, so this pass wouldn't move anything
+		if (histogram[(sortEntries_[0].key >> shift) & 0xFF] == count)
+			continue;
 
-		// Render object using specified typing
-		glBindVertexArray(currentData.vao);
-		switch (currentData.type)
+		// Turn the counts into where each bucket starts
+		size_t offset = 0;
+		for (size_t& bucket : histogram)
 		{
-			case RenderType::Points:
-				glDrawElements(GL_POINTS, currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			case RenderType::Lines:
-				glDrawElements(GL_LINES, 2 * currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			case RenderType::Triangles:
-				glDrawElements(GL_TRIANGLES, 3 * currentData.elementCount, GL_UNSIGNED_INT, 0);
-				break;
-			default:
-				break;
+			size_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
 		}
-		glBindVertexArray(0);
+
+		for (SortEntry& entry : sortEntries_)
+			sortScratch_[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+		sortEntries_.Swap(sortScratch_);
 	}
+
+	// Move the render data into sorted order
+	sortedQueue_.Clear();
+	sortedQueue_.Reserve(count);
+	for (SortEntry& entry : sortEntries_)
+		sortedQueue_.Push(queue[entry.index]);
+	queue.Swap(sortedQueue_);
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes a shader active, unless it already is
+//*****************************************************************************
+void RenderSystem::UseShader(Shader* shader)
+{
+	if (shader == boundShader_)
+	{
+		++stats_.skippedBinds;
+		return;
+	}
+
+	shader->Use();
+	boundShader_ = shader;
+	++stats_.shaderBinds;
+}
+
+//*****************************************************************************
+//  Description:
+//		Binds a vao, unless it already is
+//*****************************************************************************
+void RenderSystem::BindVao(GLuint vao)
+{
+	if (vao == boundVao_)
+		return;
+
+	glBindVertexArray(vao);
+	boundVao_ = vao;
+	if (vao)
+		++stats_.vaoBinds;
+}
+
+//*****************************************************************************
+//  Description:
+//		Streams the packed instance data into the instance buffer, orphaning
+//		the old storage so draws still using it don't stall the upload
+//*****************************************************************************
+void RenderSystem::UploadInstances()
+{
+	GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(RenderInstance) * instances_.Size());
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+	if (size > instanceBufferSize_)
+		instanceBufferSize_ = std::max(size, 2 * instanceBufferSize_);
+	glBufferData(GL_ARRAY_BUFFER, instanceBufferSize_, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances_.Data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+RenderSystem::RenderStats RenderSystem::GetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	return lastStats_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Starts timing a pass on the GPU. Passes can't overlap, so the last one
+//		has to be ended first. Must be called on the thread with the GL context
+//
+//	Param pass:
+//		The pass being drawn
+//*****************************************************************************
+void RenderSystem::BeginPassTimer(RenderPass pass)
+{
+	gpuTimer_.Begin(pass);
+}
+
+//*****************************************************************************
+//  Description:
+//		Stops timing the pass that was started
+//*****************************************************************************
+void RenderSystem::EndPassTimer()
+{
+	gpuTimer_.End();
+}
+
+void RenderSystem::SetCulling(bool culling)
+{
+	culling_ = culling;
+}
+
+bool RenderSystem::GetCulling()
+{
+	return culling_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the frustum of the active camera to cull against this frame. It
+//		is extracted the first time it is needed each frame
+//
+//	Return:
+//		Returns the frustum, or nullptr if culling is off or there is no
+//		camera
+//*****************************************************************************
+const Frustum* RenderSystem::GetFrustum()
+{
+	if (!culling_)
+		return nullptr;
+
+	if (!frustumValid_)
+	{
+		Camera* activeCam = camSys_ ? camSys_->GetActiveCamera() : nullptr;
+		if (!activeCam)
+			return nullptr;
+
+		frustum_.Extract(activeCam->GetPerspMatrix() * activeCam->GetViewMatrix());
+		frustumValid_ = true;
+	}
+	return &frustum_;
+}
+
+//*****************************************************************************
+//  Description:
+//		Counts objects that were culled before they got to Render, so they
+//		still show up in the stats
+//*****************************************************************************
+void RenderSystem::AddCulledCount(int count)
+{
+	GetParent()->GetFramePacket()->culledCount += count;
+}
+
+//*****************************************************************************
+//  Description:
+//		Checks if a mesh could be seen by the active camera. The bounding
+//		sphere is checked first since it is cheaper, then the bounding box
+//		moved into world space, which is a tighter fit for most meshes
+//
+//	Param mesh:
+//		The mesh being drawn
+//
+//	Param objToWorld:
+//		The object to world matrix the mesh is drawn with
+//
+//	Return:
+//		Returns false if the mesh is completely outside the view frustum
+//*****************************************************************************
+bool RenderSystem::IsVisible(DckMesh* mesh, const glm::mat4& objToWorld)
+{
+	const Frustum* frustum = GetFrustum();
+	if (!frustum)
+		return true;
+
+	// Sphere in world space, scaled by the biggest axis scale so it still holds the mesh
+	glm::vec3 axisX(objToWorld[0]);
+	glm::vec3 axisY(objToWorld[1]);
+	glm::vec3 axisZ(objToWorld[2]);
+	float maxScale = glm::sqrt(glm::max(glm::dot(axisX, axisX), glm::max(glm::dot(axisY, axisY), glm::dot(axisZ, axisZ))));
+	glm::vec3 sphereCenter(objToWorld * glm::vec4(mesh->GetBoundingCenter(), 1.0f));
+	if (!frustum->SphereVisible(sphereCenter, mesh->GetBoundingRadius() * maxScale))
+		return false;
+
+	// Box in world space, which is the box around the transformed object space box
+	glm::vec3 boxCenter = 0.5f * (mesh->GetBoundsMin() + mesh->GetBoundsMax());
+	glm::vec3 boxExtents = 0.5f * (mesh->GetBoundsMax() - mesh->GetBoundsMin());
+	glm::vec3 worldCenter(objToWorld * glm::vec4(boxCenter, 1.0f));
+	glm::vec3 worldExtents = glm::abs(axisX) * boxExtents.x + glm::abs(axisY) * boxExtents.y + glm::abs(axisZ) * boxExtents.z;
+	return frustum->BoxVisible(worldCenter, worldExtents);
 }
 
 void RenderSystem::Shutdown()
 {
+	if (instanceBuffer_)
+		glDeleteBuffers(1, &instanceBuffer_);
+	instanceBuffer_ = 0;
+	instanceBufferSize_ = 0;
 
+	gpuTimer_.Shutdown();
 }
 
 void RenderSystem::Render(DckMesh* mesh, RenderType type, glm::mat4 objToWorld,
 						  glm::vec3 tint, glm::vec3 diffuse, glm::vec3 specular, float sExp)
 {
-	glm::mat4 normMat = GfxMath::NormalMatrix(objToWorld);
+	// Meshes that are still loading just don't get drawn yet
+	if (!mesh || !mesh->IsReady())
+		return;
+
+	Render(mesh, type, objToWorld, GfxMath::NormalMatrix(objToWorld), tint, diffuse, specular, sExp);
+}
+
+void RenderSystem::Render(DckMesh* mesh, RenderType type, const glm::mat4& objToWorld, const glm::mat4& normMat,
+						  glm::vec3 tint, glm::vec3 diffuse, glm::vec3 specular, float sExp, bool cull)
+{
+	// Meshes that are still loading just don't get drawn yet
+	if (!mesh || !mesh->IsReady())
+		return;
+
+	// Don't bother queueing anything the camera can't see. Culls are counted in the frame being
+	// recorded, so ones from systems that update after this one still count toward this frame
+	FramePacket* packet = GetParent()->GetFramePacket();
+	if (cull && culling_ && !IsVisible(mesh, objToWorld))
+	{
+		++packet->culledCount;
+		return;
+	}
+
 	switch (type)
 	{
 		case RenderType::Points:
-			renderQueue_.push(RenderData(mesh->GetPointVAO(), mesh->GetPointCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+			packet->renderQueue.Push(RenderData(mesh->GetPointVAO(), mesh->GetPointCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 			break;
 		case RenderType::Lines:
-			renderQueue_.push(RenderData(mesh->GetEdgeVAO(), mesh->GetEdgeCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+			packet->renderQueue.Push(RenderData(mesh->GetEdgeVAO(), mesh->GetEdgeCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 			break;
 		case RenderType::Triangles:
 			if (mesh->HasNormals())
-				renderQueue_.push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 0, objToWorld, normMat, tint, diffuse, specular, sExp));
+				packet->renderQueue.Push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 0, objToWorld, normMat, tint, diffuse, specular, sExp));
 			else
-				renderQueue_.push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+				packet->renderQueue.Push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 			break;
 	}
 }
@@ -187,20 +660,25 @@ void RenderSystem::Render(DckMesh* mesh, RenderType type, glm::mat4 objToWorld,
 void RenderSystem::RenderDebug(DckMesh* mesh, RenderType type, glm::mat4 objToWorld,
 							   glm::vec3 tint, glm::vec3 diffuse, glm::vec3 specular, float sExp)
 {
+	// Meshes that are still loading just don't get drawn yet
+	if (!mesh || !mesh->IsReady())
+		return;
+
+	FramePacket* packet = GetParent()->GetFramePacket();
 	glm::mat4 normMat = GfxMath::NormalMatrix(objToWorld);
 	switch (type)
 	{
 	case RenderType::Points:
-		debugQueue_.push(RenderData(mesh->GetPointVAO(), mesh->GetPointCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+		packet->debugQueue.Push(RenderData(mesh->GetPointVAO(), mesh->GetPointCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 		break;
 	case RenderType::Lines:
-		debugQueue_.push(RenderData(mesh->GetEdgeVAO(), mesh->GetEdgeCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+		packet->debugQueue.Push(RenderData(mesh->GetEdgeVAO(), mesh->GetEdgeCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 		break;
 	case RenderType::Triangles:
 		if (mesh->HasNormals())
-			debugQueue_.push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 0, objToWorld, normMat, tint, diffuse, specular, sExp));
+			packet->debugQueue.Push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 0, objToWorld, normMat, tint, diffuse, specular, sExp));
 		else
-			debugQueue_.push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
+			packet->debugQueue.Push(RenderData(mesh->GetFaceVAO(), mesh->GetFaceCount(), type, 1, objToWorld, normMat, tint, diffuse, specular, sExp));
 		break;
 	}
 }
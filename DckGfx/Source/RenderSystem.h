@@ -9,12 +9,48 @@
 
 #include "System.h"
 #include "MeshLib.h"
-#include <queue>
+#include "Shader.h"
+#include "LinearArena.h"
+#include "Frustum.h"
+#include "GpuTimer.h"
+
+#include <cstdint>
+#include <mutex>
+
+class CameraSystem;
 
 class RenderSystem : public System {
 public:
 
+	// Passes are drawn in order, and the pass goes in the top bits of the sort key. ImGui
+	// draws itself last, it is only a pass here so it can be timed with the others
+	enum RenderPass {
+		MainPass,
+		DebugPass,
+		ImGuiPass,
+		PassCount
+	};
+
+	// Counters for the last frame drawn, to see how much state changing sorting saves
+	struct RenderStats {
+		int objectCount;
+		int culledCount;
+		int drawCalls;
+		int triangleCount;
+		int vaoBinds;
+		int unsortedVaoBinds;
+		int shaderBinds;
+		int skippedBinds;
+		int skippedUniforms;
+		size_t arenaBytes;
+		int heapAllocs;
+
+		// GPU time of each pass, from a few frames back since it is read without waiting on the GPU
+		float gpuPassMs[PassCount];
+	};
+
 	struct RenderData {
+		uint64_t sortKey;
 		GLuint vao;
 		int elementCount;
 		RenderType type;
@@ -29,6 +65,7 @@ public:
 		RenderData(GLuint vao, int elementCount, RenderType type,
 				   int noNorm, glm::mat4 oTW, glm::mat4 nM, glm::vec3 tint,
 				   glm::vec3 diff = glm::vec3(0), glm::vec3 spec = glm::vec3(0), float sExp = 0.0f) :
+			sortKey(0),
 			vao(vao),
 			elementCount(elementCount),
 			type(type),
@@ -42,26 +79,90 @@ public:
 		{}
 	};
 
+	static constexpr SysType Type = SysType::RenderSys;
+
 	RenderSystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
+	void Submit(FramePacket& packet) override;
 	void Shutdown() override;
 
 	void Render(DckMesh* mesh, RenderType type, glm::mat4 objToWorld,
 				glm::vec3 tint = glm::vec3(0), glm::vec3 diffuse = glm::vec3(0), glm::vec3 specular = glm::vec3(0), float sExp = 0.0f);
 
+	// For objects that already have their normal matrix, so it isn't made again every frame
+	void Render(DckMesh* mesh, RenderType type, const glm::mat4& objToWorld, const glm::mat4& normMat,
+				glm::vec3 tint, glm::vec3 diffuse, glm::vec3 specular, float sExp, bool cull = true);
+
 	void RenderDebug(DckMesh* mesh, RenderType type, glm::mat4 objToWorld,
 					 glm::vec3 tint = glm::vec3(0), glm::vec3 diffuse = glm::vec3(0), glm::vec3 specular = glm::vec3(0), float sExp = 0.0f);
 
+	RenderStats GetStats();
+
+	void BeginPassTimer(RenderPass pass);
+	void EndPassTimer();
+
+	void SetCulling(bool culling);
+	bool GetCulling();
+	const Frustum* GetFrustum();
+	void AddCulledCount(int count);
+
 	~RenderSystem();
 
 private:
 
-	std::queue<RenderData> renderQueue_;
-	std::queue<RenderData> debugQueue_;
+	// Sort key paired with where its render data is in the queue
+	struct SortEntry {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	void DrawQueue(ArenaArray<RenderData>& queue, RenderPass pass, Shader* shader, const glm::mat4& viewMat, bool useLighting);
+	void SortQueue(ArenaArray<RenderData>& queue, RenderPass pass, GLuint program, const glm::mat4& viewMat);
+	void UploadInstances();
+	void ResetFrame(FramePacket& packet);
+
+	void UseShader(Shader* shader);
+	void BindVao(GLuint vao);
+
+	bool IsVisible(DckMesh* mesh, const glm::mat4& objToWorld);
+
+	// Scratch space for drawing a frame comes out of here, and is freed all at once after drawing.
+	// The render commands themselves are in the frame packet
+	LinearArena frameArena_;
+
+	// Per instance data for the queue being drawn, and the buffer it is streamed into
+	ArenaArray<RenderInstance> instances_;
+	GLuint instanceBuffer_;
+	GLsizeiptr instanceBufferSize_;
+
+	// Scratch space for sorting
+	ArenaArray<SortEntry> sortEntries_;
+	ArenaArray<SortEntry> sortScratch_;
+	ArenaArray<RenderData> sortedQueue_;
+
+	// What is currently bound, so binding the same thing again can be skipped
+	Shader* boundShader_;
+	GLuint boundVao_;
+
+	// GPU time of each pass
+	GpuTimer gpuTimer_;
+
+	// Stats being counted while submitting, and the last finished ones which can be read from any thread
+	RenderStats stats_;
+	RenderStats lastStats_;
+	std::mutex statsMutex_;
+
+	// Frustum of the active camera, extracted the first time something is culled each frame
+	Frustum frustum_;
+	bool frustumValid_;
+	bool culling_;
 
 	float pointSize_;
 	float lineWidth_;
 
+	// Systems this one uses, looked up once in Initialize
+	CameraSystem* camSys_;
+
 };
\ No newline at end of file
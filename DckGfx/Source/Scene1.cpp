@@ -10,9 +10,8 @@
 #include "GfxMath.h"
 #include "RenderObject.h"
 
-// Rotation stuff
-static float rotation = 0.0f;
-glm::vec4 diagAxis = GfxMath::Vector(1, 1, 1);
+// Axis the cubes spin around
+static const glm::vec4 diagAxis = GfxMath::Vector(1, 1, 1);
 
 // Color
 static glm::vec3 gray(0.2f, 0.2f, 0.2f);
@@ -50,7 +49,6 @@ void Scene1Load()
 
 void Scene1Init()
 {
-	rotation = 0.0f;
 }
 
 void Scene1Update(float dt)
@@ -68,24 +66,13 @@ void Scene1Update(float dt)
 		DckESetNextScene(SceneID::Scene2);
 
 
-	// Get the current rotation data of the cubes and update their rotations accordingly
-	float rotation;
-	glm::vec4 rotVec;
+	// Spin the cubes a bit more around their diagonal
+	GfxMath::Quat spin = GfxMath::QuatFromAxisAngle(diagAxis, 45.0f * dt);
 	if (lazyCube)
-	{
-		lazyCube->GetRotation(&rotVec, &rotation);
-		rotation += 45.0f * dt;
-		if (rotation > 360.0f)
-			rotation = 0.0f;
-		lazyCube->SetRotation(rotVec, rotation);
-	}
+		lazyCube->Rotate(spin);
 
 	RenderObject* phongCube = DckEObjectManagerGet("PhongCube");
-	phongCube->GetRotation(&rotVec, &rotation);
-	rotation += 45.0f * dt;
-	if (rotation > 360.0f)
-		rotation = 0.0f;
-	phongCube->SetRotation(rotVec, rotation);
+	phongCube->Rotate(spin);
 }
 
 void Scene1Shutdown()
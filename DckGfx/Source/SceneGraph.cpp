@@ -0,0 +1,596 @@
+//*****************************************************************************
+//	File:   SceneGraph.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Parent and child links between transforms. Nodes are kept
+//		in depth first order, so every subtree is one run of the arrays and
+//		world matrices are made in a single pass from parents to children
+//*****************************************************************************
+
+#include "SceneGraph.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+
+// Fewest root subtrees a job updates
+static const int rootBatchSize = 64;
+
+// Marks the end of a child list
+static const uint32_t noNode = 0xFFFFFFFF;
+
+static SceneGraph sceneGraph(TransformStoreGet());
+
+//*****************************************************************************
+//  Description:
+//		Puts an array into a new order. The new order is built in the scratch
+//		and swapped in, so the two trade buffers and neither has to grow again
+//
+//	Param values:
+//		The array to reorder
+//
+//	Param order:
+//		Where each value in the new order was in the old one
+//
+//	Param scratch:
+//		Array of the same type to build the new order in
+//*****************************************************************************
+template <typename T>
+static void ApplyOrder(std::vector<T>& values, const std::vector<uint32_t>& order, std::vector<T>& scratch)
+{
+	scratch.clear();
+	for (uint32_t index : order)
+		scratch.push_back(values[index]);
+	values.swap(scratch);
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes the flagged values out of an array in place, keeping the rest
+//		in the order they were in
+//*****************************************************************************
+template <typename T>
+static void RemoveFlagged(std::vector<T>& values, const std::vector<uint8_t>& flags)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		if (!flags[i])
+			values[kept++] = values[i];
+	}
+	values.resize(kept);
+}
+
+SceneGraph::SceneGraph(TransformStore* transforms) :
+	transforms_(transforms),
+	indices_(),
+	handles_(),
+	nodeTransforms_(),
+	parentHandles_(),
+	parents_(),
+	subtreeSizes_(),
+	roots_(),
+	localMats_(),
+	localNormalMats_(),
+	worldMats_(),
+	worldNormalMats_(),
+	dirty_(),
+	childDirty_(),
+	removed_(),
+	orderDirty_(false),
+	parentsChanged_(false),
+	transformNodes_(),
+	firstChild_(),
+	nextSibling_(),
+	order_(),
+	handleScratch_(),
+	matScratch_(),
+	flagScratch_(),
+	updatedNodes_(),
+	updatedScratch_(),
+	updatedMutex_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a node for a transform. The transform becomes the node's local
+//		transform, relative to its parent
+//
+//	Param transform:
+//		The transform the node gets its local matrix from
+//
+//	Param parent:
+//		The node to put it under, or an invalid handle for a new root
+//
+//	Return:
+//		Returns the handle to the new node
+//*****************************************************************************
+SceneNode SceneGraph::Add(TransformHandle transform, SceneNode parent)
+{
+	// New roots go on the end, which keeps the order depth first
+	uint32_t index = static_cast<uint32_t>(handles_.size());
+	SceneNode node = indices_.Add(index);
+	handles_.push_back(node);
+	nodeTransforms_.push_back(transform);
+	parentHandles_.push_back(SceneNode());
+	parents_.push_back(-1);
+	subtreeSizes_.push_back(1);
+	roots_.push_back(index);
+	localMats_.push_back(transforms_->GetModelMatrix(transform));
+	localNormalMats_.push_back(transforms_->GetNormalMatrix(transform));
+	worldMats_.push_back(localMats_.back());
+	worldNormalMats_.push_back(localNormalMats_.back());
+	dirty_.push_back(1);
+	childDirty_.push_back(0);
+	removed_.push_back(0);
+
+	if (transform.index >= transformNodes_.size())
+		transformNodes_.resize(transform.index + 1);
+	transformNodes_[transform.index] = node;
+
+	if (indices_.Contains(parent))
+		SetParent(node, parent);
+	return node;
+}
+
+//*****************************************************************************
+//  Description:
+//		Removes a node. Its children go under its parent, and it is taken
+//		out of the arrays on the next update
+//
+//	Param node:
+//		Handle to the node, nothing happens if it was already removed
+//*****************************************************************************
+void SceneGraph::Remove(SceneNode node)
+{
+	if (!indices_.Contains(node))
+		return;
+
+	uint32_t index = IndexOf(node);
+	if (removed_[index])
+		return;
+
+	removed_[index] = 1;
+	orderDirty_ = true;
+}
+
+void SceneGraph::Clear()
+{
+	indices_.Clear();
+	handles_.clear();
+	nodeTransforms_.clear();
+	parentHandles_.clear();
+	parents_.clear();
+	subtreeSizes_.clear();
+	roots_.clear();
+	localMats_.clear();
+	localNormalMats_.clear();
+	worldMats_.clear();
+	worldNormalMats_.clear();
+	dirty_.clear();
+	childDirty_.clear();
+	removed_.clear();
+	transformNodes_.clear();
+	orderDirty_ = false;
+	parentsChanged_ = false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Moves a node and everything under it to a new parent. The node keeps
+//		its local transform, so its world transform changes with the move
+//
+//	Param node:
+//		The node to move
+//
+//	Param parent:
+//		The node to put it under, or an invalid handle to make it a root
+//
+//	Return:
+//		Returns false if the parent is the node itself or under it
+//*****************************************************************************
+bool SceneGraph::SetParent(SceneNode node, SceneNode parent)
+{
+	uint32_t index = IndexOf(node);
+	for (SceneNode above = parent; indices_.Contains(above); above = parentHandles_[IndexOf(above)])
+	{
+		if (above == node)
+		{
+			std::cout << "Scene node can't be put under itself or one of its children" << std::endl;
+			return false;
+		}
+	}
+
+	parentHandles_[index] = parent;
+	dirty_[index] = 1;
+	orderDirty_ = true;
+	parentsChanged_ = true;
+	return true;
+}
+
+SceneNode SceneGraph::GetParent(SceneNode node)
+{
+	return parentHandles_[IndexOf(node)];
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the object to world matrix of a node, as of the last update
+//*****************************************************************************
+const glm::mat4& SceneGraph::GetWorldMatrix(SceneNode node)
+{
+	return worldMats_[IndexOf(node)];
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the matrix for bringing a node's normals into world space, as of
+//		the last update
+//*****************************************************************************
+const glm::mat4& SceneGraph::GetNormalMatrix(SceneNode node)
+{
+	return worldNormalMats_[IndexOf(node)];
+}
+
+//*****************************************************************************
+//  Description:
+//		Remakes the world matrices of everything that moved. Has to be called
+//		right after the transform store updates, since that is where it finds
+//		out which local matrices changed. Each root's subtree is its own run
+//		of the arrays, so the roots are split across threads
+//
+//	Param jobSystem:
+//		Used to split the work across threads, or nullptr to do it all here
+//*****************************************************************************
+void SceneGraph::Update(JobSystem* jobSystem)
+{
+	DCK_PROFILE_ZONE("Update Scene Graph");
+
+	if (orderDirty_ && parentsChanged_)
+		Reorder();
+	else if (orderDirty_)
+		Compact();
+
+	// Pick up every local matrix the transform store just remade
+	int changedCount = transforms_->GetUpdatedCount();
+	for (int i = 0; i < changedCount; ++i)
+	{
+		TransformHandle transform = transforms_->GetUpdatedHandle(i);
+		if (transform.index >= transformNodes_.size())
+			continue;
+
+		SceneNode node = transformNodes_[transform.index];
+		if (!indices_.Contains(node))
+			continue;
+
+		uint32_t index = IndexOf(node);
+		if (nodeTransforms_[index] != transform)
+			continue;
+
+		localMats_[index] = transforms_->GetModelMatrix(transform);
+		localNormalMats_[index] = transforms_->GetNormalMatrix(transform);
+		MarkDirty(index);
+	}
+
+	// Each job lists what it remade on its own, and adds them all at once at the end. The roots'
+	// subtrees are back to back, so a job's list fits in the scratch from its first root on without
+	// running into anyone else's. Both only grow when the graph does
+	updatedNodes_.clear();
+	updatedNodes_.reserve(handles_.size());
+	updatedScratch_.resize(handles_.size());
+	auto updateSubtrees = [this](int begin, int end) {
+		if (begin >= end)
+			return;
+
+		SceneNode* updated = updatedScratch_.data() + roots_[begin];
+		uint32_t updatedCount = 0;
+		for (int i = begin; i < end; ++i)
+			updatedCount += UpdateSubtree(roots_[i], updated + updatedCount);
+		if (updatedCount == 0)
+			return;
+
+		std::lock_guard<std::mutex> lock(updatedMutex_);
+		updatedNodes_.insert(updatedNodes_.end(), updated, updated + updatedCount);
+	};
+	if (jobSystem)
+		jobSystem->ParallelFor(static_cast<int>(roots_.size()), rootBatchSize, updateSubtrees);
+	else
+		updateSubtrees(0, static_cast<int>(roots_.size()));
+}
+
+int SceneGraph::GetCount()
+{
+	return static_cast<int>(handles_.size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many nodes had their world matrices remade in the last
+//		update
+//*****************************************************************************
+int SceneGraph::GetUpdatedCount()
+{
+	return static_cast<int>(updatedNodes_.size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets one of the nodes that had its world matrix remade in the last
+//		update, in no particular order
+//
+//	Param index:
+//		Which one, from 0 to GetUpdatedCount
+//*****************************************************************************
+SceneNode SceneGraph::GetUpdatedNode(int index)
+{
+	return updatedNodes_[index];
+}
+
+uint32_t SceneGraph::IndexOf(SceneNode node)
+{
+	return *indices_.Get(node);
+}
+
+//*****************************************************************************
+//  Description:
+//		Marks a node to be remade along with its subtree, and lets every node
+//		above it know there is something to remake under them
+//*****************************************************************************
+void SceneGraph::MarkDirty(uint32_t index)
+{
+	dirty_[index] = 1;
+	for (int32_t parent = parents_[index]; parent >= 0 && !childDirty_[parent]; parent = parents_[parent])
+		childDirty_[parent] = 1;
+}
+
+//*****************************************************************************
+//  Description:
+//		Points nodes under removed parents at the closest parent still there.
+//		A node getting a new parent this way moves, so it has to be remade
+//*****************************************************************************
+void SceneGraph::SkipRemovedParents()
+{
+	uint32_t count = static_cast<uint32_t>(handles_.size());
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (removed_[i])
+			continue;
+
+		SceneNode parent = parentHandles_[i];
+		bool skipped = false;
+		while (indices_.Contains(parent) && removed_[IndexOf(parent)])
+		{
+			parent = parentHandles_[IndexOf(parent)];
+			skipped = true;
+		}
+		if (skipped)
+		{
+			parentHandles_[i] = parent;
+			dirty_[i] = 1;
+		}
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Lets go of the handles of removed nodes, and of their transforms
+//*****************************************************************************
+void SceneGraph::ReleaseRemoved()
+{
+	uint32_t count = static_cast<uint32_t>(handles_.size());
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (!removed_[i])
+			continue;
+
+		TransformHandle transform = nodeTransforms_[i];
+		if (transform.index < transformNodes_.size() && transformNodes_[transform.index] == handles_[i])
+			transformNodes_[transform.index] = SceneNode();
+		indices_.Remove(handles_[i]);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Takes removed nodes out of the arrays when nothing was reparented.
+//		Children of a removed node go under its parent right where it was,
+//		so just closing the gaps keeps the order depth first, all in place
+//*****************************************************************************
+void SceneGraph::Compact()
+{
+	SkipRemovedParents();
+	ReleaseRemoved();
+
+	RemoveFlagged(handles_, removed_);
+	RemoveFlagged(nodeTransforms_, removed_);
+	RemoveFlagged(parentHandles_, removed_);
+	RemoveFlagged(localMats_, removed_);
+	RemoveFlagged(localNormalMats_, removed_);
+	RemoveFlagged(worldMats_, removed_);
+	RemoveFlagged(worldNormalMats_, removed_);
+	RemoveFlagged(dirty_, removed_);
+	FinishOrder();
+}
+
+//*****************************************************************************
+//  Description:
+//		Rebuilds the depth first order after nodes were moved, taking out any
+//		that were removed. Children of removed nodes go under the closest
+//		parent still there, and siblings keep the order they had
+//*****************************************************************************
+void SceneGraph::Reorder()
+{
+	uint32_t count = static_cast<uint32_t>(handles_.size());
+	SkipRemovedParents();
+
+	// Child lists in the current order. Going backwards and adding to the front keeps siblings in order
+	firstChild_.assign(count, noNode);
+	nextSibling_.assign(count, noNode);
+	roots_.clear();
+	for (uint32_t i = count; i > 0; --i)
+	{
+		uint32_t index = i - 1;
+		if (removed_[index])
+			continue;
+
+		if (indices_.Contains(parentHandles_[index]))
+		{
+			uint32_t parent = IndexOf(parentHandles_[index]);
+			nextSibling_[index] = firstChild_[parent];
+			firstChild_[parent] = index;
+		}
+		else
+		{
+			parentHandles_[index] = SceneNode();
+			roots_.push_back(index);
+		}
+	}
+	std::reverse(roots_.begin(), roots_.end());
+
+	// Walk every root's subtree depth first to get the new order
+	order_.clear();
+	for (uint32_t root : roots_)
+	{
+		uint32_t index = root;
+		for (;;)
+		{
+			order_.push_back(index);
+			if (firstChild_[index] != noNode)
+			{
+				index = firstChild_[index];
+				continue;
+			}
+
+			while (index != root && nextSibling_[index] == noNode)
+				index = IndexOf(parentHandles_[index]);
+			if (index == root)
+				break;
+			index = nextSibling_[index];
+		}
+	}
+
+	// Let go of the removed nodes, then move everything else into place
+	ReleaseRemoved();
+	ApplyOrder(handles_, order_, handleScratch_);
+	ApplyOrder(nodeTransforms_, order_, handleScratch_);
+	ApplyOrder(parentHandles_, order_, handleScratch_);
+	ApplyOrder(localMats_, order_, matScratch_);
+	ApplyOrder(localNormalMats_, order_, matScratch_);
+	ApplyOrder(worldMats_, order_, matScratch_);
+	ApplyOrder(worldNormalMats_, order_, matScratch_);
+	ApplyOrder(dirty_, order_, flagScratch_);
+	FinishOrder();
+}
+
+//*****************************************************************************
+//  Description:
+//		Redoes everything that comes from the order once the arrays are in
+//		it: where each handle is, parent indices, roots, subtree sizes and
+//		which nodes have something dirty under them
+//*****************************************************************************
+void SceneGraph::FinishOrder()
+{
+	// Parents come before their children, so each parent's new index is known by the time it's needed
+	uint32_t count = static_cast<uint32_t>(handles_.size());
+	parents_.resize(count);
+	roots_.clear();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		*indices_.Get(handles_[i]) = i;
+		if (indices_.Contains(parentHandles_[i]))
+			parents_[i] = static_cast<int32_t>(IndexOf(parentHandles_[i]));
+		else
+		{
+			parentHandles_[i] = SceneNode();
+			parents_[i] = -1;
+			roots_.push_back(i);
+		}
+	}
+
+	// Sizes and flags come up from the bottom
+	subtreeSizes_.assign(count, 1);
+	childDirty_.assign(count, 0);
+	for (uint32_t i = count; i > 0; --i)
+	{
+		uint32_t index = i - 1;
+		int32_t parent = parents_[index];
+		if (parent < 0)
+			continue;
+
+		subtreeSizes_[parent] += subtreeSizes_[index];
+		if (dirty_[index] || childDirty_[index])
+			childDirty_[parent] = 1;
+	}
+
+	removed_.assign(count, 0);
+	orderDirty_ = false;
+	parentsChanged_ = false;
+}
+
+//*****************************************************************************
+//  Description:
+//		Remakes the world matrices in a root's subtree. Clean subtrees are
+//		stepped over in one go, and under a dirty node everything is remade
+//		in a straight run since its whole subtree comes right after it
+//
+//	Param updated:
+//		Every node that had its world matrix remade is written here, which
+//		needs room for the whole subtree
+//
+//	Return:
+//		Returns how many nodes were written to updated
+//*****************************************************************************
+uint32_t SceneGraph::UpdateSubtree(uint32_t root, SceneNode* updated)
+{
+	uint32_t end = root + subtreeSizes_[root];
+	uint32_t index = root;
+	uint32_t updatedCount = 0;
+	while (index < end)
+	{
+		if (dirty_[index])
+		{
+			uint32_t subtreeEnd = index + subtreeSizes_[index];
+			for (uint32_t i = index; i < subtreeEnd; ++i)
+			{
+				int32_t parent = parents_[i];
+				if (parent < 0)
+				{
+					worldMats_[i] = localMats_[i];
+					worldNormalMats_[i] = localNormalMats_[i];
+				}
+				else
+				{
+					worldMats_[i] = worldMats_[parent] * localMats_[i];
+					worldNormalMats_[i] = worldNormalMats_[parent] * localNormalMats_[i];
+				}
+				dirty_[i] = 0;
+				childDirty_[i] = 0;
+			}
+			std::copy(handles_.begin() + index, handles_.begin() + subtreeEnd, updated + updatedCount);
+			updatedCount += subtreeEnd - index;
+			index = subtreeEnd;
+		}
+		else if (childDirty_[index])
+		{
+			childDirty_[index] = 0;
+			++index;
+		}
+		else
+			index += subtreeSizes_[index];
+	}
+	return updatedCount;
+}
+
+SceneGraph::~SceneGraph()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the scene graph every render object has a node in
+//*****************************************************************************
+SceneGraph* SceneGraphGet()
+{
+	return &sceneGraph;
+}
@@ -0,0 +1,107 @@
+#pragma once
+//*****************************************************************************
+//	File:   SceneGraph.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Parent and child links between transforms. Nodes are kept
+//		in depth first order, so every subtree is one run of the arrays and
+//		world matrices are made in a single pass from parents to children
+//*****************************************************************************
+
+#include "TransformStore.h"
+#include <mutex>
+
+class JobSystem;
+
+// Handle to a node in the scene graph, which goes invalid once the node is removed
+typedef SlotHandle SceneNode;
+
+class SceneGraph {
+public:
+
+	SceneGraph(TransformStore* transforms);
+
+	SceneNode Add(TransformHandle transform, SceneNode parent = SceneNode());
+	void Remove(SceneNode node);
+	void Clear();
+
+	bool SetParent(SceneNode node, SceneNode parent);
+	SceneNode GetParent(SceneNode node);
+
+	const glm::mat4& GetWorldMatrix(SceneNode node);
+	const glm::mat4& GetNormalMatrix(SceneNode node);
+
+	void Update(JobSystem* jobSystem = nullptr);
+
+	int GetCount();
+	int GetUpdatedCount();
+	SceneNode GetUpdatedNode(int index);
+
+	~SceneGraph();
+
+private:
+
+	// Not copyable, handles given out point into this graph
+	SceneGraph(const SceneGraph&);
+	SceneGraph& operator=(const SceneGraph&);
+
+	uint32_t IndexOf(SceneNode node);
+	void MarkDirty(uint32_t index);
+	void SkipRemovedParents();
+	void ReleaseRemoved();
+	void Compact();
+	void Reorder();
+	void FinishOrder();
+	uint32_t UpdateSubtree(uint32_t root, SceneNode* updated);
+
+	// Where the local matrices come from
+	TransformStore* transforms_;
+
+	// Where each node is in the arrays
+	SlotMap<uint32_t> indices_;
+
+	// The nodes in depth first order. A node's parent always comes before it, and its subtree is
+	// the run of subtreeSizes_ nodes starting at it
+	std::vector<SceneNode> handles_;
+	std::vector<TransformHandle> nodeTransforms_;
+	std::vector<SceneNode> parentHandles_;
+	std::vector<int32_t> parents_;
+	std::vector<uint32_t> subtreeSizes_;
+	std::vector<uint32_t> roots_;
+
+	// Matrices from the transform store, and the world matrices made from them
+	std::vector<glm::mat4> localMats_;
+	std::vector<glm::mat4> localNormalMats_;
+	std::vector<glm::mat4> worldMats_;
+	std::vector<glm::mat4> worldNormalMats_;
+
+	// Nodes that need their whole subtree remade, and nodes with one of those somewhere under them
+	std::vector<uint8_t> dirty_;
+	std::vector<uint8_t> childDirty_;
+
+	// Removing and reparenting only write down what changed, the arrays are fixed up once on the next
+	// update. Removing alone only has to close the gaps, reparenting rebuilds the whole order
+	std::vector<uint8_t> removed_;
+	bool orderDirty_;
+	bool parentsChanged_;
+
+	// The node each transform belongs to, by the transform's slot
+	std::vector<SceneNode> transformNodes_;
+
+	// Child lists, the new order, and room to build each array in it, kept around for reordering
+	std::vector<uint32_t> firstChild_;
+	std::vector<uint32_t> nextSibling_;
+	std::vector<uint32_t> order_;
+	std::vector<SlotHandle> handleScratch_;
+	std::vector<glm::mat4> matScratch_;
+	std::vector<uint8_t> flagScratch_;
+
+	// Every node whose world matrix was remade in the last update, gathered from each thread. Each
+	// thread lists its own first, in the part of the scratch that lines up with its roots' subtrees
+	std::vector<SceneNode> updatedNodes_;
+	std::vector<SceneNode> updatedScratch_;
+	std::mutex updatedMutex_;
+
+};
+
+SceneGraph* SceneGraphGet();
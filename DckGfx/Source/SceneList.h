@@ -11,5 +11,6 @@ enum SceneID {
 	SceneRestart = -1,
 	Scene1,
 	Scene2,
+	BenchScene,
 	SceneCount
 };
\ No newline at end of file
@@ -12,19 +12,34 @@
 #include "Engine.h"
 #include "Scene1.h"
 #include "Scene2.h"
+#include "BenchScene.h"
 
-SceneSystem::SceneSystem() : System(SysType::SceneSys),
+SceneSystem::SceneSystem() : System(Type),
 	scenes_(),
 	prevScene_(SceneID::SceneInvalid),
 	currScene_(SceneID::SceneInvalid),
-	nextScene_(SceneID::SceneInvalid)
+	nextScene_(SceneID::SceneInvalid),
+	lightSys_(nullptr),
+	objManSys_(nullptr)
 {
+	// Scene logic runs at the end of the frame, so switching scenes happens between frames. Input
+	// and ImGui aren't there headless, so it also needs to wait on the systems it changes directly
+	RunsAfter(InputSys);
+	RunsAfter(CameraSys);
+	RunsAfter(ObjectManagerSys);
+	RunsAfter(LightingSys);
+	RunsAfter(RenderSys);
+	RunsAfter(ImGUISys);
 }
 
 void SceneSystem::Initialize()
 {
+	lightSys_ = GetParent()->Get<LightingSystem>();
+	objManSys_ = GetParent()->Get<ObjectManagerSystem>();
+
 	scenes_[SceneID::Scene1] = Scene(Scene1Load, Scene1Init, Scene1Update, Scene1Shutdown, Scene1Unload);
 	scenes_[SceneID::Scene2] = Scene(Scene2Load, Scene2Init, Scene2Update, Scene2Shutdown, Scene2Unload);
+	scenes_[SceneID::BenchScene] = Scene(BenchSceneLoad, BenchSceneInit, BenchSceneUpdate, BenchSceneShutdown, BenchSceneUnload);
 
 	nextScene_ = SceneID::Scene1;
 }
@@ -45,15 +60,13 @@ void SceneSystem::Update(float dt)
 		// Otherwise, unload the current one and load the new one
 		else
 		{
-			// Get lighting system and clear the lights
-			LightingSystem* lightSys = dynamic_cast<LightingSystem*>(GetParent()->GetSystem(LightingSys));
-			if (lightSys)
-				lightSys->ClearLights();
-
-			// Get the object manager system and clear the objects
-			ObjectManagerSystem* objManSys = dynamic_cast<ObjectManagerSystem*>(GetParent()->GetSystem(ObjectManagerSys));
-			if (objManSys)
-				objManSys->ClearManager();
+			// Clear the lights
+			if (lightSys_)
+				lightSys_->ClearLights();
+
+			// Clear the objects
+			if (objManSys_)
+				objManSys_->ClearManager();
 
 			// If valid, unload current scene
 			if (SceneIsValid(currScene_))
@@ -10,6 +10,9 @@
 #include "System.h"
 #include "SceneList.h"
 
+class LightingSystem;
+class ObjectManagerSystem;
+
 typedef void (*LoadFunc)();
 typedef void (*InitFunc)();
 typedef void (*UpdateFunc)(float);
@@ -40,6 +43,8 @@ public:
 		{}
 	};
 
+	static constexpr SysType Type = SysType::SceneSys;
+
 	SceneSystem();
 
 	void Initialize() override;
@@ -61,4 +66,8 @@ private:
 	SceneID currScene_;
 	SceneID nextScene_;
 
+	// Systems this one uses, looked up once in Initialize
+	LightingSystem* lightSys_;
+	ObjectManagerSystem* objManSys_;
+
 };
\ No newline at end of file
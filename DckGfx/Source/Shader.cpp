@@ -20,7 +20,7 @@
 //	Param fragFile
 //		The filepath of the fragment shader
 //*****************************************************************************
-Shader::Shader(const char* vertFile, const char* fragFile) : program_(0), attribs_(), uniforms_() {
+Shader::Shader(const char* vertFile, const char* fragFile) : program_(0), attribs_(), uniforms_(), instancedVariant_(nullptr) {
 	// Read the vertex shader file
 	std::string vertCodeStr = ReadShaderFile(vertFile);
 	if (vertCodeStr.empty())
@@ -138,6 +138,17 @@ void Shader::Use() {
 	glUseProgram(program_);
 }
 
+//*****************************************************************************
+//  Description
+//		Gets the OpenGL program of this shader
+// 
+//	Return
+//		Returns the program, 0 if the shader failed to be created
+//*****************************************************************************
+GLuint Shader::GetProgram() {
+	return program_;
+}
+
 //*****************************************************************************
 //  Description
 //		Get the location of a specified attribute from the shader
@@ -172,6 +183,30 @@ GLint Shader::GetUniformLocation(std::string uniformName) {
 	return result->second;
 }
 
+//*****************************************************************************
+//  Description
+//		Sets the instanced version of this shader, which takes the per object
+//		data (matrices, tint, material) as instance attributes so identical
+//		meshes can be drawn in one call
+//	
+//	Param variant
+//		The instanced shader, or nullptr if this shader has none
+//*****************************************************************************
+void Shader::SetInstancedVariant(Shader* variant) {
+	instancedVariant_ = variant;
+}
+
+//*****************************************************************************
+//  Description
+//		Gets the instanced version of this shader
+// 
+//	Return
+//		Returns the instanced shader, nullptr if this shader has none
+//*****************************************************************************
+Shader* Shader::GetInstancedVariant() {
+	return instancedVariant_;
+}
+
 //*****************************************************************************
 //  Description
 //		Shader destructor, which handles clearing the attribute map and 
@@ -16,9 +16,13 @@ public:
 	Shader(const char* vertFile, const char* fragFile);
 
 	void Use();
+	GLuint GetProgram();
 
 	GLint GetAttribLocation(std::string attribName);
 	GLint GetUniformLocation(std::string uniformName);
+
+	void SetInstancedVariant(Shader* variant);
+	Shader* GetInstancedVariant();
 	
 	~Shader();
 
@@ -32,4 +36,7 @@ private:
 
 	// Uniform locations ( will do this when needed)
 	std::map<std::string, GLint> uniforms_;
+
+	// Version of this shader that takes per instance data as attributes (owned by the shader library)
+	Shader* instancedVariant_;
 };
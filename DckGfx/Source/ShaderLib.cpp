@@ -46,6 +46,15 @@ void ShaderLib::Initialize()
 	// Create and add the lighting shader to the shader manager
 	Shader* phongShader = new Shader("Data/Shaders/PhongShader.vert", "Data/Shaders/PhongShader.frag");
 	AddObject("Phong Shader", phongShader);
+
+	// Create the instanced versions of the shaders, used to batch draws of the same mesh
+	Shader* defaultInstanced = new Shader("Data/Shaders/3dShaderInstanced.vert", "Data/Shaders/3dShader.frag");
+	AddObject("Default Shader Instanced", defaultInstanced);
+	defaultShader->SetInstancedVariant(defaultInstanced);
+
+	Shader* phongInstanced = new Shader("Data/Shaders/PhongShaderInstanced.vert", "Data/Shaders/PhongShaderInstanced.frag");
+	AddObject("Phong Shader Instanced", phongInstanced);
+	phongShader->SetInstancedVariant(phongInstanced);
 }
 
 void ShaderLib::AddObject(std::string name, Shader* shader)
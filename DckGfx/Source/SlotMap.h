@@ -0,0 +1,214 @@
+#pragma once
+//*****************************************************************************
+//	File:   SlotMap.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Container that hands out generational handles to what is put
+//		in it. Adding, removing and looking up by handle are all O(1), and
+//		the values stay packed together so going through them is as fast as
+//		going through a vector
+//*****************************************************************************
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//*****************************************************************************
+//  Description:
+//		Handle to a value in a slot map. The generation changes every time a
+//		slot is reused, so a handle to something removed stays invalid even
+//		after something else takes its place. Generation 0 is never used, so
+//		a default handle is always invalid
+//*****************************************************************************
+struct SlotHandle {
+	uint32_t index;
+	uint32_t generation;
+
+	SlotHandle() :
+		index(0),
+		generation(0)
+	{}
+
+	SlotHandle(uint32_t slotIndex, uint32_t slotGeneration) :
+		index(slotIndex),
+		generation(slotGeneration)
+	{}
+
+	bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+//*****************************************************************************
+//  Description:
+//		Slot map of values. The values are kept packed in their own array,
+//		and removing one moves the last value into its place, so the order
+//		of the values changes as things are removed
+//*****************************************************************************
+template <typename T>
+class SlotMap {
+public:
+
+	SlotMap() :
+		values_(),
+		valueSlots_(),
+		slots_(),
+		freeHead_(noSlot)
+	{
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Adds a value, reusing a removed slot if there is one
+	//
+	//	Return:
+	//		Returns the handle to the value
+	//*************************************************************************
+	SlotHandle Add(const T& value)
+	{
+		uint32_t slotIndex;
+		if (freeHead_ != noSlot)
+		{
+			slotIndex = freeHead_;
+			freeHead_ = slots_[slotIndex].valueIndex;
+		}
+		else
+		{
+			slotIndex = static_cast<uint32_t>(slots_.size());
+			slots_.push_back(Slot());
+		}
+
+		Slot& slot = slots_[slotIndex];
+		slot.valueIndex = static_cast<uint32_t>(values_.size());
+		values_.push_back(value);
+		valueSlots_.push_back(slotIndex);
+		return SlotHandle(slotIndex, slot.generation);
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Removes the value a handle is for, if it is still there
+	//
+	//	Return:
+	//		Returns true if something was removed
+	//*************************************************************************
+	bool Remove(SlotHandle handle)
+	{
+		if (!Contains(handle))
+			return false;
+
+		RemoveAt(slots_[handle.index].valueIndex);
+		return true;
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Removes the value at a place in the packed array. The last value
+	//		moves into its place, so when removing while going through the
+	//		values, the same place has to be looked at again
+	//*************************************************************************
+	void RemoveAt(size_t valueIndex)
+	{
+		uint32_t slotIndex = valueSlots_[valueIndex];
+		uint32_t lastIndex = static_cast<uint32_t>(values_.size() - 1);
+		if (valueIndex != lastIndex)
+		{
+			values_[valueIndex] = values_[lastIndex];
+			valueSlots_[valueIndex] = valueSlots_[lastIndex];
+			slots_[valueSlots_[valueIndex]].valueIndex = static_cast<uint32_t>(valueIndex);
+		}
+		values_.pop_back();
+		valueSlots_.pop_back();
+
+		// Invalidate every handle to the slot, and put it on the free list
+		Slot& slot = slots_[slotIndex];
+		slot.generation = NextGeneration(slot.generation);
+		slot.valueIndex = freeHead_;
+		freeHead_ = slotIndex;
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Gets the value a handle is for
+	//
+	//	Return:
+	//		Returns a pointer to the value, or nullptr if it was removed. The
+	//		pointer is only good until the next add or remove
+	//*************************************************************************
+	T* Get(SlotHandle handle)
+	{
+		if (!Contains(handle))
+			return nullptr;
+		return &values_[slots_[handle.index].valueIndex];
+	}
+
+	bool Contains(SlotHandle handle)
+	{
+		return handle.index < slots_.size() && handle.generation != 0 && slots_[handle.index].generation == handle.generation;
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Gets the handle to the value at a place in the packed array
+	//*************************************************************************
+	SlotHandle GetHandle(size_t valueIndex)
+	{
+		uint32_t slotIndex = valueSlots_[valueIndex];
+		return SlotHandle(slotIndex, slots_[slotIndex].generation);
+	}
+
+	//*************************************************************************
+	//  Description:
+	//		Removes everything. Every handle given out so far stays invalid,
+	//		and the memory is kept for whatever is added next
+	//*************************************************************************
+	void Clear()
+	{
+		for (size_t i = values_.size(); i > 0; --i)
+			RemoveAt(i - 1);
+	}
+
+	void Reserve(size_t capacity)
+	{
+		values_.reserve(capacity);
+		valueSlots_.reserve(capacity);
+		slots_.reserve(capacity);
+	}
+
+	T& operator[](size_t valueIndex) { return values_[valueIndex]; }
+	T* Data() { return values_.data(); }
+	size_t Size() { return values_.size(); }
+	bool Empty() { return values_.empty(); }
+
+	T* begin() { return values_.data(); }
+	T* end() { return values_.data() + values_.size(); }
+
+private:
+
+	// Marks the end of the free list
+	static const uint32_t noSlot = 0xFFFFFFFF;
+
+	// Where a handle's value is in the packed array, or the next free slot if the slot is free
+	struct Slot {
+		uint32_t valueIndex;
+		uint32_t generation;
+
+		Slot() :
+			valueIndex(0),
+			generation(1)
+		{}
+	};
+
+	static uint32_t NextGeneration(uint32_t generation)
+	{
+		// Skips 0 when it wraps, so default handles never match
+		return generation + 1 == 0 ? 1 : generation + 1;
+	}
+
+	// The values packed together, and the slot each one is in
+	std::vector<T> values_;
+	std::vector<uint32_t> valueSlots_;
+
+	// Every slot ever used, and the first free one
+	std::vector<Slot> slots_;
+	uint32_t freeHead_;
+};
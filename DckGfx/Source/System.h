@@ -9,6 +9,7 @@
 
 // Forward declare engine so System knows what it is
 class Engine;
+struct FramePacket;
 
 class System {
 public:
@@ -26,22 +27,46 @@ public:
 		SystemCount
 	};
 
-	System(SysType type) : type_(type), parent_(nullptr) {}
+	// Every system also has a static Type matching the one it is constructed
+	// with, which is what lets Engine::Get find it without casting at runtime
+	System(SysType type) : type_(type), parent_(nullptr), dependencies_(0), mainThreadOnly_(true) {}
 
 	virtual void Initialize() = 0;
 	virtual void Update(float dt) = 0;
 	virtual void Shutdown() = 0;
 
+	// OpenGL work for a frame, after every system has updated. Update only records into the
+	// frame packet, so this can run on the render thread while the next frame updates
+	virtual void Submit(FramePacket& /*packet*/) {}
+
 	SysType GetType() { return type_; }
 
 	Engine* GetParent() { return parent_; }
 	void SetParent(Engine* engine) { parent_ = engine; }
 
+	// Systems that have to finish updating before this one starts, as bits of (1 << SysType)
+	unsigned int GetDependencies() { return dependencies_; }
+
+	// Anything touching SDL or OpenGL has to stay on the main thread. The render queues only take
+	// one writer at a time, so systems that queue draws also stay on it unless everything else
+	// that draws runs after them
+	bool IsMainThreadOnly() { return mainThreadOnly_; }
+
 	~System() {}
 
+protected:
+
+	// Says this system reads something the given system writes during its update. Systems that
+	// weren't added don't pass their own dependencies on, so list everything that has to come first
+	void RunsAfter(SysType type) { dependencies_ |= 1u << type; }
+	void SetMainThreadOnly(bool mainThreadOnly) { mainThreadOnly_ = mainThreadOnly; }
+
 private:
 
 	SysType type_;
 	Engine* parent_;
 
+	unsigned int dependencies_;
+	bool mainThreadOnly_;
+
 };
\ No newline at end of file
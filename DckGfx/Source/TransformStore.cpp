@@ -0,0 +1,518 @@
+//*****************************************************************************
+//	File:   TransformStore.cpp
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Position, scale and rotation of every object, kept as a
+//		structure of arrays. Transforms that changed get packed together and
+//		turned into model and normal matrices with SIMD, several at a time
+//*****************************************************************************
+
+#include "TransformStore.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+// Builds with AVX2 do eight transforms at a time, anything else on x86 does four with SSE2
+#if defined(__AVX2__)
+#define DCK_TRANSFORM_SIMD
+#define DCK_TRANSFORM_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DCK_TRANSFORM_SIMD
+#include <emmintrin.h>
+#endif
+
+// Fewest transforms a job turns into matrices
+static const int matrixBatchSize = 1024;
+
+// Most transforms done at once, every packed array is padded out to a multiple of this
+static const int maxSimdWidth = 8;
+
+// Values padding lanes get, so they stay well defined
+static const float fieldDefaults[] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+static TransformStore transformStore;
+
+#ifdef DCK_TRANSFORM_SIMD
+
+//*****************************************************************************
+//  Description:
+//		Four wide SSE2 operations, for the matrix kernel
+//*****************************************************************************
+struct SimdSse {
+	typedef __m128 V;
+	static const int width = 4;
+
+	static V Load(const float* p) { return _mm_loadu_ps(p); }
+	static V Set1(float f) { return _mm_set1_ps(f); }
+	static V Add(V a, V b) { return _mm_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+	static V Div(V a, V b) { return _mm_div_ps(a, b); }
+
+	//*************************************************************************
+	//  Description:
+	//		Writes a column of every lane's matrix, given each row of that
+	//		column across the lanes
+	//*************************************************************************
+	static void StoreColumn(V x, V y, V z, V w, glm::mat4* const* mats, int column, int count)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		V lanes[4] = { x, y, z, w };
+		for (int i = 0; i < count; ++i)
+			_mm_storeu_ps(&(*mats[i])[column][0], lanes[i]);
+	}
+};
+
+#ifdef DCK_TRANSFORM_AVX2
+
+//*****************************************************************************
+//  Description:
+//		Eight wide AVX2 operations, for the matrix kernel
+//*****************************************************************************
+struct SimdAvx2 {
+	typedef __m256 V;
+	static const int width = 8;
+
+	static V Load(const float* p) { return _mm256_loadu_ps(p); }
+	static V Set1(float f) { return _mm256_set1_ps(f); }
+	static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+	static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+	static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+	static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+
+	static void StoreColumn(V x, V y, V z, V w, glm::mat4* const* mats, int column, int count)
+	{
+		// Each half is transposed like SSE would
+		SimdSse::StoreColumn(_mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z),
+							 _mm256_castps256_ps128(w), mats, column, count < 4 ? count : 4);
+		if (count > 4)
+			SimdSse::StoreColumn(_mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1),
+								 _mm256_extractf128_ps(w, 1), mats + 4, column, count - 4);
+	}
+};
+
+typedef SimdAvx2 Simd;
+
+#else
+
+typedef SimdSse Simd;
+
+#endif
+
+//*****************************************************************************
+//  Description:
+//		Makes the model and normal matrices of packed transforms, a SIMD
+//		group at a time. The rotation comes straight from the quaternion
+//		with no trig, and since it has no scale in it, the normal matrix is
+//		just the rotation divided by the scale instead of a full inverse
+//
+//	Param fields:
+//		The packed transforms in field order, padded out to a whole group
+//
+//	Param targets:
+//		Index of each packed transform in the store's matrix arrays
+//
+//	Param begin:
+//		First packed transform to do, has to start a group
+//*****************************************************************************
+template <typename S>
+static void ComputeMatricesSimd(const float* const* fields, const uint32_t* targets, glm::mat4* modelMats,
+								glm::mat4* normalMats, int begin, int end)
+{
+	typedef typename S::V V;
+
+	V zero = S::Set1(0.0f);
+	V one = S::Set1(1.0f);
+	for (int i = begin; i < end; i += S::width)
+	{
+		V px = S::Load(fields[0] + i);
+		V py = S::Load(fields[1] + i);
+		V pz = S::Load(fields[2] + i);
+		V sx = S::Load(fields[3] + i);
+		V sy = S::Load(fields[4] + i);
+		V sz = S::Load(fields[5] + i);
+		V qx = S::Load(fields[6] + i);
+		V qy = S::Load(fields[7] + i);
+		V qz = S::Load(fields[8] + i);
+		V qw = S::Load(fields[9] + i);
+
+		// Dividing by the squared length keeps the rotation pure even if the quaternion drifted a little
+		V two = S::Set1(2.0f);
+		V s = S::Div(two, S::Add(S::Add(S::Mul(qx, qx), S::Mul(qy, qy)), S::Add(S::Mul(qz, qz), S::Mul(qw, qw))));
+		V sx2 = S::Mul(qx, s);
+		V sy2 = S::Mul(qy, s);
+		V sz2 = S::Mul(qz, s);
+		V xx = S::Mul(qx, sx2);
+		V yy = S::Mul(qy, sy2);
+		V zz = S::Mul(qz, sz2);
+		V xy = S::Mul(qx, sy2);
+		V xz = S::Mul(qx, sz2);
+		V yz = S::Mul(qy, sz2);
+		V wx = S::Mul(qw, sx2);
+		V wy = S::Mul(qw, sy2);
+		V wz = S::Mul(qw, sz2);
+
+		// Rotation from the quaternion, by column
+		V r00 = S::Sub(one, S::Add(yy, zz));
+		V r10 = S::Add(xy, wz);
+		V r20 = S::Sub(xz, wy);
+		V r01 = S::Sub(xy, wz);
+		V r11 = S::Sub(one, S::Add(xx, zz));
+		V r21 = S::Add(yz, wx);
+		V r02 = S::Add(xz, wy);
+		V r12 = S::Sub(yz, wx);
+		V r22 = S::Sub(one, S::Add(xx, yy));
+
+		int count = end - i < S::width ? end - i : S::width;
+		glm::mat4* models[S::width];
+		glm::mat4* normals[S::width];
+		for (int lane = 0; lane < count; ++lane)
+		{
+			models[lane] = &modelMats[targets[i + lane]];
+			normals[lane] = &normalMats[targets[i + lane]];
+		}
+
+		// Translate * Rotate * Scale
+		S::StoreColumn(S::Mul(r00, sx), S::Mul(r10, sx), S::Mul(r20, sx), zero, models, 0, count);
+		S::StoreColumn(S::Mul(r01, sy), S::Mul(r11, sy), S::Mul(r21, sy), zero, models, 1, count);
+		S::StoreColumn(S::Mul(r02, sz), S::Mul(r12, sz), S::Mul(r22, sz), zero, models, 2, count);
+		S::StoreColumn(px, py, pz, one, models, 3, count);
+
+		// Inverse transpose of Rotate * Scale
+		V isx = S::Div(one, sx);
+		V isy = S::Div(one, sy);
+		V isz = S::Div(one, sz);
+		S::StoreColumn(S::Mul(r00, isx), S::Mul(r10, isx), S::Mul(r20, isx), zero, normals, 0, count);
+		S::StoreColumn(S::Mul(r01, isy), S::Mul(r11, isy), S::Mul(r21, isy), zero, normals, 1, count);
+		S::StoreColumn(S::Mul(r02, isz), S::Mul(r12, isz), S::Mul(r22, isz), zero, normals, 2, count);
+		S::StoreColumn(zero, zero, zero, one, normals, 3, count);
+	}
+}
+
+#endif
+
+TransformStore::TransformStore() :
+	indices_(),
+	handles_(),
+	fields_(),
+	modelMats_(),
+	normalMats_(),
+	dirty_(),
+	dirtyList_(),
+	batch_(),
+	batchFields_()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Adds a transform at the origin with no rotation and a scale of one
+//
+//	Return:
+//		Returns the handle to the new transform
+//*****************************************************************************
+TransformHandle TransformStore::Add()
+{
+	uint32_t index = static_cast<uint32_t>(handles_.size());
+	TransformHandle handle = indices_.Add(index);
+	handles_.push_back(handle);
+	for (int field = 0; field < FieldCount; ++field)
+		fields_[field].push_back(fieldDefaults[field]);
+	modelMats_.push_back(glm::mat4(1));
+	normalMats_.push_back(glm::mat4(1));
+	dirty_.push_back(0);
+	return handle;
+}
+
+//*****************************************************************************
+//  Description:
+//		Removes a transform. The last transform moves into its place, so the
+//		arrays stay packed
+//
+//	Param handle:
+//		Handle to the transform, nothing happens if it was already removed
+//*****************************************************************************
+void TransformStore::Remove(TransformHandle handle)
+{
+	uint32_t* found = indices_.Get(handle);
+	if (!found)
+		return;
+
+	uint32_t index = *found;
+	uint32_t last = static_cast<uint32_t>(handles_.size() - 1);
+	if (index != last)
+	{
+		for (int field = 0; field < FieldCount; ++field)
+			fields_[field][index] = fields_[field][last];
+		modelMats_[index] = modelMats_[last];
+		normalMats_[index] = normalMats_[last];
+		handles_[index] = handles_[last];
+		*indices_.Get(handles_[index]) = index;
+
+		// The moved transform keeps its changes, under its new index
+		dirty_[index] = dirty_[last];
+		if (dirty_[index])
+			dirtyList_.push_back(index);
+	}
+
+	for (int field = 0; field < FieldCount; ++field)
+		fields_[field].pop_back();
+	modelMats_.pop_back();
+	normalMats_.pop_back();
+	handles_.pop_back();
+	dirty_.pop_back();
+	indices_.Remove(handle);
+}
+
+void TransformStore::Clear()
+{
+	indices_.Clear();
+	handles_.clear();
+	for (int field = 0; field < FieldCount; ++field)
+		fields_[field].clear();
+	modelMats_.clear();
+	normalMats_.clear();
+	dirty_.clear();
+	dirtyList_.clear();
+}
+
+void TransformStore::SetPosition(TransformHandle handle, const glm::vec4& pos)
+{
+	uint32_t index = IndexOf(handle);
+	fields_[PosX][index] = pos.x;
+	fields_[PosY][index] = pos.y;
+	fields_[PosZ][index] = pos.z;
+	MarkDirty(index);
+}
+
+void TransformStore::SetScale(TransformHandle handle, const glm::vec3& scale)
+{
+	uint32_t index = IndexOf(handle);
+	fields_[ScaleX][index] = scale.x;
+	fields_[ScaleY][index] = scale.y;
+	fields_[ScaleZ][index] = scale.z;
+	MarkDirty(index);
+}
+
+//*****************************************************************************
+//  Description:
+//		Sets the rotation of a transform
+//
+//	Param axis:
+//		Vector to rotate around, doesn't need to be unit length
+//
+//	Param angle:
+//		Amount to rotate by in degrees
+//*****************************************************************************
+void TransformStore::SetRotation(TransformHandle handle, const glm::vec4& axis, float angle)
+{
+	SetOrientation(handle, GfxMath::QuatFromAxisAngle(axis, angle));
+}
+
+void TransformStore::SetOrientation(TransformHandle handle, const GfxMath::Quat& orientation)
+{
+	uint32_t index = IndexOf(handle);
+	fields_[RotX][index] = orientation.x;
+	fields_[RotY][index] = orientation.y;
+	fields_[RotZ][index] = orientation.z;
+	fields_[RotW][index] = orientation.w;
+	MarkDirty(index);
+}
+
+//*****************************************************************************
+//  Description:
+//		Turns a transform by some more rotation, on top of what it already
+//		has. Only a quaternion multiply, so it is cheap to do every frame
+//
+//	Param rotation:
+//		The rotation to add, done after the current one
+//*****************************************************************************
+void TransformStore::Rotate(TransformHandle handle, const GfxMath::Quat& rotation)
+{
+	SetOrientation(handle, GfxMath::QuatNormalize(rotation * GetOrientation(handle)));
+}
+
+glm::vec4 TransformStore::GetPosition(TransformHandle handle)
+{
+	uint32_t index = IndexOf(handle);
+	return glm::vec4(fields_[PosX][index], fields_[PosY][index], fields_[PosZ][index], 1.0f);
+}
+
+glm::vec3 TransformStore::GetScale(TransformHandle handle)
+{
+	uint32_t index = IndexOf(handle);
+	return glm::vec3(fields_[ScaleX][index], fields_[ScaleY][index], fields_[ScaleZ][index]);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the rotation of a transform as a unit axis and an angle in
+//		degrees from 0 to 360
+//*****************************************************************************
+void TransformStore::GetRotation(TransformHandle handle, glm::vec4* axis, float* angle)
+{
+	GfxMath::QuatToAxisAngle(GetOrientation(handle), axis, angle);
+}
+
+GfxMath::Quat TransformStore::GetOrientation(TransformHandle handle)
+{
+	uint32_t index = IndexOf(handle);
+	return GfxMath::Quat(fields_[RotX][index], fields_[RotY][index], fields_[RotZ][index], fields_[RotW][index]);
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the object to world matrix of a transform, as of the last update
+//*****************************************************************************
+const glm::mat4& TransformStore::GetModelMatrix(TransformHandle handle)
+{
+	return modelMats_[IndexOf(handle)];
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the matrix for bringing normals into world space, as of the last
+//		update
+//*****************************************************************************
+const glm::mat4& TransformStore::GetNormalMatrix(TransformHandle handle)
+{
+	return normalMats_[IndexOf(handle)];
+}
+
+//*****************************************************************************
+//  Description:
+//		Remakes the matrices of every transform that changed. The changed
+//		transforms are packed into their own arrays first, so the SIMD
+//		kernel only ever does straight loads
+//
+//	Param jobSystem:
+//		Used to split the work across threads, or nullptr to do it all here
+//*****************************************************************************
+void TransformStore::Update(JobSystem* jobSystem)
+{
+	DCK_PROFILE_ZONE("Update Transforms");
+
+	batch_.clear();
+	for (uint32_t index : dirtyList_)
+	{
+		if (index < dirty_.size() && dirty_[index])
+		{
+			dirty_[index] = 0;
+			batch_.push_back(index);
+		}
+	}
+	dirtyList_.clear();
+
+	int count = static_cast<int>(batch_.size());
+	if (count == 0)
+		return;
+
+	int padded = (count + maxSimdWidth - 1) / maxSimdWidth * maxSimdWidth;
+	for (int field = 0; field < FieldCount; ++field)
+	{
+		std::vector<float>& packed = batchFields_[field];
+		const float* source = fields_[field].data();
+		packed.resize(padded);
+		for (int i = 0; i < count; ++i)
+			packed[i] = source[batch_[i]];
+		for (int i = count; i < padded; ++i)
+			packed[i] = fieldDefaults[field];
+	}
+
+	// Jobs are handed whole SIMD groups, so no job's loads or stores reach into the next job's range
+	auto computeMatrices = [this, count](int beginGroup, int endGroup) {
+		int end = endGroup * maxSimdWidth;
+		ComputeMatrices(beginGroup * maxSimdWidth, end < count ? end : count);
+	};
+	int groupCount = padded / maxSimdWidth;
+	if (jobSystem)
+		jobSystem->ParallelFor(groupCount, matrixBatchSize / maxSimdWidth, computeMatrices);
+	else
+		computeMatrices(0, groupCount);
+}
+
+int TransformStore::GetCount()
+{
+	return static_cast<int>(handles_.size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets how many transforms had their matrices remade in the last update
+//*****************************************************************************
+int TransformStore::GetUpdatedCount()
+{
+	return static_cast<int>(batch_.size());
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets one of the transforms that had its matrices remade in the last
+//		update. Only good until a transform is added or removed
+//
+//	Param updatedIndex:
+//		Which one, from 0 up to the updated count
+//*****************************************************************************
+TransformHandle TransformStore::GetUpdatedHandle(int updatedIndex)
+{
+	return handles_[batch_[updatedIndex]];
+}
+
+uint32_t TransformStore::IndexOf(TransformHandle handle)
+{
+	return *indices_.Get(handle);
+}
+
+void TransformStore::MarkDirty(uint32_t index)
+{
+	if (!dirty_[index])
+	{
+		dirty_[index] = 1;
+		dirtyList_.push_back(index);
+	}
+}
+
+//*****************************************************************************
+//  Description:
+//		Makes the matrices for a range of the packed transforms
+//*****************************************************************************
+void TransformStore::ComputeMatrices(int begin, int end)
+{
+#ifdef DCK_TRANSFORM_SIMD
+	const float* fields[FieldCount];
+	for (int field = 0; field < FieldCount; ++field)
+		fields[field] = batchFields_[field].data();
+	ComputeMatricesSimd<Simd>(fields, batch_.data(), modelMats_.data(), normalMats_.data(), begin, end);
+#else
+	for (int i = begin; i < end; ++i)
+	{
+		GfxMath::Quat orientation(batchFields_[RotX][i], batchFields_[RotY][i], batchFields_[RotZ][i], batchFields_[RotW][i]);
+		glm::vec3 scale(batchFields_[ScaleX][i], batchFields_[ScaleY][i], batchFields_[ScaleZ][i]);
+		glm::mat3 rotation(GfxMath::QuatToMatrix(orientation));
+
+		glm::mat4& model = modelMats_[batch_[i]];
+		glm::mat4& normal = normalMats_[batch_[i]];
+		model = glm::mat4(1);
+		normal = glm::mat4(1);
+		for (int column = 0; column < 3; ++column)
+		{
+			model[column] = glm::vec4(rotation[column] * scale[column], 0.0f);
+			normal[column] = glm::vec4(rotation[column] / scale[column], 0.0f);
+		}
+		model[3] = glm::vec4(batchFields_[PosX][i], batchFields_[PosY][i], batchFields_[PosZ][i], 1.0f);
+	}
+#endif
+}
+
+TransformStore::~TransformStore()
+{
+}
+
+//*****************************************************************************
+//  Description:
+//		Gets the transform store every render object keeps its transform in
+//*****************************************************************************
+TransformStore* TransformStoreGet()
+{
+	return &transformStore;
+}
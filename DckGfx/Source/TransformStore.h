@@ -0,0 +1,97 @@
+#pragma once
+//*****************************************************************************
+//	File:   TransformStore.h
+//  Author: Hunter Smith
+//  Date:   10/17/2026
+//  Description: Position, scale and rotation of every object, kept as a
+//		structure of arrays. Transforms that changed get packed together and
+//		turned into model and normal matrices with SIMD, several at a time
+//*****************************************************************************
+
+#include "SlotMap.h"
+#include "GfxMath.h"
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Handle to a transform in the store, which goes invalid once the transform is removed
+typedef SlotHandle TransformHandle;
+
+class TransformStore {
+public:
+
+	TransformStore();
+
+	TransformHandle Add();
+	void Remove(TransformHandle handle);
+	void Clear();
+
+	void SetPosition(TransformHandle handle, const glm::vec4& pos);
+	void SetScale(TransformHandle handle, const glm::vec3& scale);
+	void SetRotation(TransformHandle handle, const glm::vec4& axis, float angle);
+	void SetOrientation(TransformHandle handle, const GfxMath::Quat& orientation);
+	void Rotate(TransformHandle handle, const GfxMath::Quat& rotation);
+
+	glm::vec4 GetPosition(TransformHandle handle);
+	glm::vec3 GetScale(TransformHandle handle);
+	void GetRotation(TransformHandle handle, glm::vec4* axis, float* angle);
+	GfxMath::Quat GetOrientation(TransformHandle handle);
+
+	const glm::mat4& GetModelMatrix(TransformHandle handle);
+	const glm::mat4& GetNormalMatrix(TransformHandle handle);
+
+	void Update(JobSystem* jobSystem = nullptr);
+
+	int GetCount();
+	int GetUpdatedCount();
+	TransformHandle GetUpdatedHandle(int updatedIndex);
+
+	~TransformStore();
+
+private:
+
+	// Each part of a transform gets its own array
+	enum Field {
+		PosX,
+		PosY,
+		PosZ,
+		ScaleX,
+		ScaleY,
+		ScaleZ,
+		RotX,
+		RotY,
+		RotZ,
+		RotW,
+		FieldCount
+	};
+
+	// Not copyable, handles given out point into this store
+	TransformStore(const TransformStore&);
+	TransformStore& operator=(const TransformStore&);
+
+	uint32_t IndexOf(TransformHandle handle);
+	void MarkDirty(uint32_t index);
+	void ComputeMatrices(int begin, int end);
+
+	// Where each handle's transform is in the arrays, and the handle of each transform
+	SlotMap<uint32_t> indices_;
+	std::vector<TransformHandle> handles_;
+
+	// The transforms, and the matrices made from them the last time they changed
+	std::vector<float> fields_[FieldCount];
+	std::vector<glm::mat4> modelMats_;
+	std::vector<glm::mat4> normalMats_;
+
+	// Transforms changed since the last update. A transform is only listed while its flag is set,
+	// so anything listed twice or moved by a removal is skipped
+	std::vector<uint8_t> dirty_;
+	std::vector<uint32_t> dirtyList_;
+
+	// The changed transforms packed together, padded out to a whole number of SIMD groups
+	std::vector<uint32_t> batch_;
+	std::vector<float> batchFields_[FieldCount];
+
+};
+
+TransformStore* TransformStoreGet();
@@ -9,21 +9,39 @@
 #include "WindowSystem.h"
 #include "CameraSystem.h"
 #include "GraphicsSystem.h"
+#include "glad/glad.h"
 #include <stdexcept>
 #include <iostream>
 
-WindowSystem::WindowSystem() : System(SysType::WindowSys),
+WindowSystem::WindowSystem() : System(Type),
 	width_(1280),
 	height_(720),
 	aspect_(static_cast<float>(width_) / static_cast<float>(height_)),
 	name_("DckGfx"),
 	window_(nullptr),
-	glContext_(nullptr)
+	glContext_(nullptr),
+	headless_(false),
+	camSys_(nullptr)
 {
 }
 
 void WindowSystem::Initialize()
 {
+	camSys_ = GetParent()->Get<CameraSystem>();
+
+	const EngineConfig& config = GetParent()->GetConfig();
+	headless_ = config.headless;
+	width_ = config.width;
+	height_ = config.height;
+	aspect_ = static_cast<float>(width_) / static_cast<float>(height_);
+
+#ifndef _WIN32
+	// Without a display SDL's offscreen driver makes an EGL context with no surface, which
+	// runs on Mesa's llvmpipe when there is no GPU either. An explicitly picked driver wins
+	if (headless_ && !SDL_getenv("SDL_VIDEODRIVER"))
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+#endif
+
 	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		std::cout << "SDL Failed to Initialize" << std::endl;
@@ -40,13 +58,14 @@ void WindowSystem::Initialize()
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
-	// Now create the window
+	// Now create the window. Headless windows are never shown, the graphics system draws offscreen instead
+	Uint32 windowFlags = headless_ ? SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL : SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL;
 	window_ = SDL_CreateWindow("DckGfx",
 		SDL_WINDOWPOS_UNDEFINED,
 		SDL_WINDOWPOS_UNDEFINED,
 		width_,
 		height_,
-		SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL);
+		windowFlags);
 	if (!window_)
 	{
 		std::cout << "Window failed to be created" << std::endl;
@@ -63,7 +82,16 @@ void WindowSystem::Initialize()
 
 void WindowSystem::Update(float dt)
 {
-	SDL_GL_SwapWindow(window_);
+}
+
+void WindowSystem::Submit(FramePacket& /*packet*/)
+{
+	// Show the last frame drawn before this one starts drawing. Headless there is nothing to
+	// show, so wait for the GPU instead so frame times still include drawing the frame
+	if (headless_)
+		glFinish();
+	else
+		SDL_GL_SwapWindow(window_);
 }
 
 void WindowSystem::Shutdown()
@@ -83,17 +111,38 @@ SDL_GLContext WindowSystem::GetGLContext()
 	return glContext_;
 }
 
+//*****************************************************************************
+//  Description:
+//		Makes the GL context current on the calling thread. It can only be
+//		current on one thread at a time
+//*****************************************************************************
+void WindowSystem::MakeContextCurrent()
+{
+	SDL_GL_MakeCurrent(window_, glContext_);
+}
+
+//*****************************************************************************
+//  Description:
+//		Releases the GL context from the calling thread, so another thread can
+//		make it current
+//*****************************************************************************
+void WindowSystem::ReleaseContext()
+{
+	SDL_GL_MakeCurrent(window_, nullptr);
+}
+
 void WindowSystem::UpdateWindowSize(int newW, int newH)
 {
 	width_ = newW;
 	height_ = newH;
 	aspect_ = static_cast<float>(newW) / static_cast<float>(newH);
-	GraphicsSystem* graphics = dynamic_cast<GraphicsSystem*>(GetParent()->GetSystem(GraphicsSys));
-	if (graphics)
-		glViewport(0, 0, newW, newH);
-	CameraSystem* camSys = dynamic_cast<CameraSystem*>(GetParent()->GetSystem(CameraSys));
-	if (camSys)
-		camSys->UpdateAspects(aspect_);
+	if (camSys_)
+		camSys_->UpdateAspects(aspect_);
+}
+
+bool WindowSystem::IsHeadless()
+{
+	return headless_;
 }
 
 void WindowSystem::GetWindowSize(int* w, int* h)
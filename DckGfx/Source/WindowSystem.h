@@ -10,21 +10,30 @@
 #include "SDL2/SDL.h"
 #include <string>
 
+class CameraSystem;
+
 class WindowSystem : public System {
 public:
 
+	static constexpr SysType Type = SysType::WindowSys;
+
 	WindowSystem();
 
 	void Initialize() override;
 	void Update(float dt) override;
+	void Submit(FramePacket& packet) override;
 	void Shutdown() override;
 
 	SDL_Window* GetWindowHandle();
 	SDL_GLContext GetGLContext();
 
+	void MakeContextCurrent();
+	void ReleaseContext();
+
 	void UpdateWindowSize(int newW, int newH);
 
 	void GetWindowSize(int* w, int* h);
+	bool IsHeadless();
 
 	~WindowSystem();
 
@@ -37,5 +46,9 @@ private:
 
 	SDL_Window* window_;
 	SDL_GLContext glContext_;
+	bool headless_;
+
+	// Systems this one uses, looked up once in Initialize
+	CameraSystem* camSys_;
 
 };
\ No newline at end of file